@@ -10,6 +10,7 @@
  * remove transactions, adjust balances, and retrieve detailed account information for reporting purposes.
  */
 #include "Account.h"
+#include "StringPool.h"
 #include <iostream>
 #include <iomanip>
 
@@ -27,7 +28,8 @@ using namespace std;
  *
  * Initializes the account number to 0, description to an empty string, and balance to 0.0.
  */
-Account::Account() : accountNumber(0), description(""), balance(0.0) {}
+Account::Account() : accountNumber(0), description(0), balance(0.0),
+                     minDayKey(0), maxDayKey(0), minAmount(0.0), maxAmount(0.0), dirty(false) {}
 
 /**
  * @brief Parameterized constructor for the Account class.
@@ -36,9 +38,10 @@ Account::Account() : accountNumber(0), description(""), balance(0.0) {}
  * @param desc The description of the account.
  * @param bal The initial balance of the account.
  */
-Account::Account(int num, const string &desc, double bal) {
+Account::Account(int num, string_view desc, double bal)
+        : minDayKey(0), maxDayKey(0), minAmount(0.0), maxAmount(0.0), dirty(false) {
     accountNumber = num;
-    description = desc;
+    description = StringPool::intern(desc);
     balance = bal;
 }
 
@@ -52,8 +55,40 @@ Account::Account(const Account &acc) {
     description = acc.description;
     balance = acc.balance;
     transactions = acc.transactions;
+    dailyTotals = acc.dailyTotals;
+    monthlyTotals = acc.monthlyTotals;
+    minDayKey = acc.minDayKey;
+    maxDayKey = acc.maxDayKey;
+    minAmount = acc.minAmount;
+    maxAmount = acc.maxAmount;
+    dirty = acc.dirty;
 }
 
+/**
+ * @brief Move constructor for the Account class.
+ *
+ * Takes over the transactions and period buckets of the source without copying them.
+ *
+ * @param acc The account object to be moved from.
+ */
+Account::Account(Account &&acc) noexcept = default;
+
+/**
+ * @brief Copy assignment operator for the Account class.
+ *
+ * @param acc The account object to be copied.
+ * @return A reference to this account.
+ */
+Account &Account::operator=(const Account &acc) = default;
+
+/**
+ * @brief Move assignment operator for the Account class.
+ *
+ * @param acc The account object to be moved from.
+ * @return A reference to this account.
+ */
+Account &Account::operator=(Account &&acc) noexcept = default;
+
 /**
  * @brief Destructor for the Account class.
  *
@@ -88,6 +123,21 @@ const vector<Transaction> &Account::getTransactions() const {
     return transactions;
 }
 
+/**
+ * @brief Returns the net of the account's own transactions: debits minus credits, in cents.
+ *
+ * A branch-free integer sum over the packed records, which the compiler can vectorize.
+ *
+ * @return The net amount in cents
+ */
+int64_t Account::getNetCents() const {
+    int64_t net = 0;
+    for (const Transaction &t: transactions) {
+        net += t.getSignedCents();
+    }
+    return net;
+}
+
 /**
  * @brief Retrieves the total number of transactions.
  *
@@ -97,14 +147,59 @@ int Account::getTransactionCount() const {
     return transactions.size();
 }
 
+/**
+ * @brief Retrieves the earliest transaction day key.
+ *
+ * @return The `YYYYMMDD` key, or 0 if no dated transaction exists.
+ */
+int Account::getMinDayKey() const {
+    return minDayKey;
+}
+
+/**
+ * @brief Retrieves the latest transaction day key.
+ *
+ * @return The `YYYYMMDD` key, or 0 if no dated transaction exists.
+ */
+int Account::getMaxDayKey() const {
+    return maxDayKey;
+}
+
+/**
+ * @brief Retrieves the smallest transaction amount.
+ *
+ * @return The smallest amount, or 0 if there are no transactions.
+ */
+double Account::getMinAmount() const {
+    return minAmount;
+}
+
+/**
+ * @brief Retrieves the largest transaction amount.
+ *
+ * @return The largest amount, or 0 if there are no transactions.
+ */
+double Account::getMaxAmount() const {
+    return maxAmount;
+}
+
+/**
+ * @brief Checks whether the transactions changed since the account was last serialized.
+ *
+ * @return True if a transaction was added, replaced or removed since the last `clearDirty()`.
+ */
+bool Account::isDirty() const {
+    return dirty;
+}
+
 /**
  * @brief Retrieves a specific transaction by its index.
  *
  * @param index The index of the transaction to retrieve.
- * @return The transaction at the specified index.
+ * @return A reference to the transaction at the specified index, valid until the transactions change.
  * @throws std::out_of_range if the index is invalid.
  */
-Transaction Account::getTransaction(int index) const {
+const Transaction &Account::getTransaction(int index) const {
     if (index >= 0 && index < transactions.size()) {
         return transactions[index];
     }
@@ -114,11 +209,11 @@ Transaction Account::getTransaction(int index) const {
 /**
  * @brief Retrieves the account description.
  *
- * @return The account description.
+ * @return The account description, valid for the life of the process.
  */
 
-string Account::getDescription() const {
-    return description;
+string_view Account::getDescription() const {
+    return StringPool::view(description);
 }
 
 /**
@@ -135,8 +230,8 @@ void Account::setAccountNumber(int num) {
  *
  * @param desc The new description of the account.
  */
-void Account::setDescription(const string &desc) {
-    description = desc;
+void Account::setDescription(string_view desc) {
+    description = StringPool::intern(desc);
 }
 
 /**
@@ -157,7 +252,7 @@ void Account::setBalance(double bal) {
  */
 void Account::setTransaction(int index, const Transaction &t) {
     if (index >= 0 && index < transactions.size()) {
-        Transaction oldT = transactions[index];
+        const Transaction &oldT = transactions[index];
         if (oldT.getDebitCredit() == 'D') {
             balance -= oldT.getAmount();
         } else {
@@ -165,18 +260,27 @@ void Account::setTransaction(int index, const Transaction &t) {
         }
         transactions[index] = t;
         updateBalance(t);
+        rebuildSummary();
+        dirty = true;
     } else {
         throw out_of_range("Transaction out of range :)");
     }
 }
 
+/**
+ * @brief Marks the transactions as serialized, after the owner has written them out.
+ */
+void Account::clearDirty() {
+    dirty = false;
+}
+
 /**
  * @brief Adds a new transaction to the account.
  *
  * @param t The transaction to add.
  */
 void Account::addTransaction(const Transaction &t) {
-    transactions.push_back(t);
+    emplaceTransaction(t);
 }
 
 /**
@@ -187,8 +291,41 @@ void Account::addTransaction(const Transaction &t) {
  */
 void Account::removeTransaction(int index) {
     if (index >= 0 && index < transactions.size()) {
-        Transaction t = transactions[index];
         transactions.erase(transactions.begin() + index);
+        rebuildSummary();
+        dirty = true;
+    }
+}
+
+/**
+ * @brief Widens the min/max date and amount summaries to cover a new transaction.
+ *
+ * @param t The transaction being added.
+ * @param first True if this is the only transaction the summary covers so far.
+ */
+void Account::extendSummary(const Transaction &t, bool first) {
+    if (first) {
+        minAmount = maxAmount = t.getAmount();
+    } else {
+        minAmount = min(minAmount, t.getAmount());
+        maxAmount = max(maxAmount, t.getAmount());
+    }
+
+    int dayKey = t.getDayKey();
+    if (dayKey != 0) {
+        minDayKey = (minDayKey == 0) ? dayKey : min(minDayKey, dayKey);
+        maxDayKey = max(maxDayKey, dayKey);
+    }
+}
+
+/**
+ * @brief Recomputes the min/max summaries after a transaction was removed or replaced.
+ */
+void Account::rebuildSummary() {
+    minDayKey = maxDayKey = 0;
+    minAmount = maxAmount = 0.0;
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        extendSummary(transactions[i], i == 0);
     }
 }
 
@@ -213,7 +350,84 @@ void Account::updateBalance(const Transaction &t) {
  * @return The truncated account description.
  */
 string Account::getShortDescription() const {
-    return description.length() > 10 ? description.substr(0, 10) : description;
+    return string(getDescription().substr(0, 10));
+}
+
+/**
+ * @brief Adds a signed transaction amount to a period bucket, dropping the bucket once it is empty.
+ *
+ * @param buckets The day or month buckets to update.
+ * @param key The bucket key.
+ * @param t The transaction being recorded.
+ * @param sign +1 to add the transaction, -1 to remove it.
+ */
+static void applyToBucket(map<int, PeriodTotals> &buckets, int key, const Transaction &t, int sign) {
+    PeriodTotals &totals = buckets[key];
+    if (t.getDebitCredit() == 'D') {
+        totals.debits += sign * t.getAmount();
+    } else {
+        totals.credits += sign * t.getAmount();
+    }
+    totals.count += sign;
+    if (totals.count <= 0) {
+        buckets.erase(key);
+    }
+}
+
+/**
+ * @brief Adds or removes a transaction from the day and month buckets.
+ *
+ * Transactions without a parseable date are ignored.
+ *
+ * @param t The transaction to record.
+ * @param sign +1 when the transaction is posted, -1 when it is deleted.
+ */
+void Account::recordPeriodTotals(const Transaction &t, int sign) {
+    int dayKey = t.getDayKey();
+    if (dayKey == 0) {
+        return;
+    }
+    applyToBucket(dailyTotals, dayKey, t, sign);
+    applyToBucket(monthlyTotals, dayKey / 100, t, sign);
+}
+
+/**
+ * @brief Retrieves the totals for a single day.
+ *
+ * @param dayKey The day in `YYYYMMDD` form.
+ * @return The totals for that day.
+ */
+PeriodTotals Account::getDailyTotals(int dayKey) const {
+    auto it = dailyTotals.find(dayKey);
+    return it != dailyTotals.end() ? it->second : PeriodTotals();
+}
+
+/**
+ * @brief Retrieves the totals for a single month.
+ *
+ * @param monthKey The month in `YYYYMM` form.
+ * @return The totals for that month.
+ */
+PeriodTotals Account::getMonthlyTotals(int monthKey) const {
+    auto it = monthlyTotals.find(monthKey);
+    return it != monthlyTotals.end() ? it->second : PeriodTotals();
+}
+
+/**
+ * @brief Sums the day buckets in an inclusive range.
+ *
+ * @param fromDayKey The first day in `YYYYMMDD` form.
+ * @param toDayKey The last day in `YYYYMMDD` form.
+ * @return The summed totals.
+ */
+PeriodTotals Account::getTotalsBetween(int fromDayKey, int toDayKey) const {
+    PeriodTotals result;
+    for (auto it = dailyTotals.lower_bound(fromDayKey); it != dailyTotals.end() && it->first <= toDayKey; ++it) {
+        result.debits += it->second.debits;
+        result.credits += it->second.credits;
+        result.count += it->second.count;
+    }
+    return result;
 }
 
 /**
@@ -6,11 +6,32 @@
 #define ACCOUNT_H
 
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <vector>
+#include <map>
+#include <utility>
 #include <iostream>
 #include "Transaction.h"
 using namespace std;
 
+/**
+ * @struct PeriodTotals
+ * @brief Debit and credit totals accumulated over one day, one month or a range of days.
+ */
+struct PeriodTotals {
+    double debits = 0.0;  ///< Sum of the debit amounts in the period
+    double credits = 0.0; ///< Sum of the credit amounts in the period
+    int count = 0;        ///< Number of transactions in the period
+
+    /**
+     * @brief Returns the net movement of the period (debits minus credits).
+     *
+     * @return The net amount
+     */
+    double net() const { return debits - credits; }
+};
+
 /**
  * @class Account
  * @brief Represents a financial account with account number, description, balance, and transactions.
@@ -22,9 +43,29 @@ using namespace std;
 class Account {
 private:
     int accountNumber;               ///< The account number
-    string description;              ///< The description of the account
+    uint32_t description;            ///< `StringPool` handle of the description of the account
     double balance;                  ///< The current balance of the account
     vector<Transaction> transactions;///< The list of transactions associated with the account
+    map<int, PeriodTotals> dailyTotals;  ///< Subtree totals keyed by `YYYYMMDD` day key
+    map<int, PeriodTotals> monthlyTotals;///< Subtree totals keyed by `YYYYMM` month key
+    int minDayKey;                   ///< Earliest dated transaction (`YYYYMMDD`), 0 if none
+    int maxDayKey;                   ///< Latest dated transaction (`YYYYMMDD`), 0 if none
+    double minAmount;                ///< Smallest transaction amount, 0 if none
+    double maxAmount;                ///< Largest transaction amount, 0 if none
+    bool dirty;                      ///< Set when the transactions change; cleared once they are re-serialized
+
+    /**
+     * @brief Widens the min/max summaries to cover one more transaction.
+     *
+     * @param t The transaction being added
+     * @param first True if this is the only transaction the summary covers so far
+     */
+    void extendSummary(const Transaction& t, bool first);
+
+    /**
+     * @brief Recomputes the min/max summaries from the remaining transactions.
+     */
+    void rebuildSummary();
 
 public:
     // Constructors & Destructor
@@ -45,7 +86,7 @@ public:
      * @param desc The account description
      * @param bal The account balance
      */
-    Account(int num, const string& desc, double bal);
+    Account(int num, string_view desc, double bal);
 
     /**
      * @brief Copy constructor for Account class.
@@ -56,6 +97,31 @@ public:
      */
     Account(const Account& acc);
 
+    /**
+     * @brief Move constructor for Account class.
+     *
+     * Takes over the transactions and period buckets of the provided `Account` instead of copying them.
+     *
+     * @param acc The account to move from
+     */
+    Account(Account&& acc) noexcept;
+
+    /**
+     * @brief Copy assignment operator for Account class.
+     *
+     * @param acc The account to copy
+     * @return A reference to this account
+     */
+    Account& operator=(const Account& acc);
+
+    /**
+     * @brief Move assignment operator for Account class.
+     *
+     * @param acc The account to move from
+     * @return A reference to this account
+     */
+    Account& operator=(Account&& acc) noexcept;
+
     /**
      * @brief Destructor for Account class.
      *
@@ -75,9 +141,9 @@ public:
     /**
      * @brief Returns the account description.
      *
-     * @return The description of the account
+     * @return The description of the account, valid for the life of the process
      */
-    string getDescription() const;
+    string_view getDescription() const;
 
     /**
      * @brief Returns the current balance of the account.
@@ -93,6 +159,13 @@ public:
      */
     const vector<Transaction>& getTransactions() const;
 
+    /**
+     * @brief Returns the net of the account's own transactions: debits minus credits, in cents.
+     *
+     * @return The net amount in cents
+     */
+    int64_t getNetCents() const;
+
     /**
      * @brief Returns the number of transactions in the account.
      *
@@ -104,10 +177,45 @@ public:
      * @brief Returns the transaction at the specified index.
      *
      * @param index The index of the transaction to retrieve
-     * @return The transaction at the specified index
+     * @return A reference to the transaction at the specified index, valid until the transactions change
      * @throws out_of_range If the index is out of range
      */
-    Transaction getTransaction(int index) const;
+    const Transaction& getTransaction(int index) const;
+
+    /**
+     * @brief Returns the earliest transaction day key.
+     *
+     * @return The `YYYYMMDD` key of the earliest dated transaction, or 0 if there is none
+     */
+    int getMinDayKey() const;
+
+    /**
+     * @brief Returns the latest transaction day key.
+     *
+     * @return The `YYYYMMDD` key of the latest dated transaction, or 0 if there is none
+     */
+    int getMaxDayKey() const;
+
+    /**
+     * @brief Returns the smallest transaction amount.
+     *
+     * @return The smallest amount, or 0 if there are no transactions
+     */
+    double getMinAmount() const;
+
+    /**
+     * @brief Returns the largest transaction amount.
+     *
+     * @return The largest amount, or 0 if there are no transactions
+     */
+    double getMaxAmount() const;
+
+    /**
+     * @brief Checks whether the transactions changed since the account was last serialized.
+     *
+     * @return True if a transaction was added, replaced or removed since the last `clearDirty()`
+     */
+    bool isDirty() const;
 
     // Setters
 
@@ -123,7 +231,7 @@ public:
      *
      * @param desc The account description to set
      */
-    void setDescription(const string& desc);
+    void setDescription(string_view desc);
 
     /**
      * @brief Sets the account balance.
@@ -143,6 +251,11 @@ public:
      */
     void setTransaction(int index, const Transaction& t);
 
+    /**
+     * @brief Marks the transactions as serialized, after the owner has written them out.
+     */
+    void clearDirty();
+
     // Operations
 
     /**
@@ -154,6 +267,23 @@ public:
      */
     void addTransaction(const Transaction& t);
 
+    /**
+     * @brief Constructs a transaction in place at the end of the account's transactions.
+     *
+     * Same as `addTransaction`, but the transaction is built directly in the account's storage from the arguments
+     * of one of the `Transaction` constructors.
+     *
+     * @param args The `Transaction` constructor arguments
+     * @return A reference to the new transaction, valid until the transactions change
+     */
+    template<typename... Args>
+    const Transaction& emplaceTransaction(Args&&... args) {
+        const Transaction& t = transactions.emplace_back(std::forward<Args>(args)...);
+        extendSummary(t, transactions.size() == 1);
+        dirty = true;
+        return t;
+    }
+
     /**
      * @brief Removes the transaction at the specified index.
      *
@@ -180,6 +310,46 @@ public:
      * @return A short version of the account description
      */
     string getShortDescription() const;
+
+    // Period rollups
+
+    /**
+     * @brief Adds or removes a transaction from the day and month buckets.
+     *
+     * The buckets hold totals for this account and all of its descendants, so the forest calls this for the account
+     * that owns the transaction and for each of its ancestors.
+     *
+     * @param t The transaction to record
+     * @param sign +1 when the transaction is posted, -1 when it is deleted
+     */
+    void recordPeriodTotals(const Transaction& t, int sign);
+
+    /**
+     * @brief Returns the totals for a single day.
+     *
+     * @param dayKey The day in `YYYYMMDD` form
+     * @return The totals for that day (all zero if nothing was posted)
+     */
+    PeriodTotals getDailyTotals(int dayKey) const;
+
+    /**
+     * @brief Returns the totals for a single month.
+     *
+     * @param monthKey The month in `YYYYMM` form
+     * @return The totals for that month (all zero if nothing was posted)
+     */
+    PeriodTotals getMonthlyTotals(int monthKey) const;
+
+    /**
+     * @brief Returns the totals for an inclusive range of days.
+     *
+     * Only the day buckets inside the range are visited, never the transactions themselves.
+     *
+     * @param fromDayKey The first day in `YYYYMMDD` form
+     * @param toDayKey The last day in `YYYYMMDD` form
+     * @return The summed totals over the range
+     */
+    PeriodTotals getTotalsBetween(int fromDayKey, int toDayKey) const;
     //bool isParentOf(int otherAccountNum) const;
 
 };
@@ -0,0 +1,138 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file AtomicFileWriter.cpp
+ * @brief Implements `AtomicFileWriter`, the buffered temp-file-and-rename writer used to save the chart.
+ */
+
+#include "AtomicFileWriter.h"
+#include "ForestTrace.h"
+#include <cstring>
+#include <stdexcept>
+#include <filesystem>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Opens the temp file next to the target.
+ *
+ * @param filename The file to replace on `commit()`.
+ * @param syncWrites Whether `commit` fsyncs before renaming, so the new contents survive a power loss.
+ * @param bufferSize Size of the write buffer in bytes.
+ *
+ * @throws runtime_error If the temp file cannot be created.
+ */
+AtomicFileWriter::AtomicFileWriter(const string &filename, bool syncWrites, size_t bufferSize)
+        : filename(filename), tempName(filename + ".tmp"), file(nullptr), buffer(bufferSize < 64 ? 64 : bufferSize),
+          used(0), written(0), syncWrites(syncWrites) {
+    file = fopen(tempName.c_str(), "wb");
+    if (!file) {
+        throw runtime_error("Unable to open file for writing: " + tempName);
+    }
+    setvbuf(file, nullptr, _IONBF, 0);  // Our own buffer already batches the writes
+}
+
+/**
+ * @brief Removes the temp file unless `commit()` succeeded.
+ */
+AtomicFileWriter::~AtomicFileWriter() {
+    if (file) {
+        fclose(file);
+        remove(tempName.c_str());
+    }
+}
+
+/**
+ * @brief Hands the buffered bytes to the OS.
+ */
+void AtomicFileWriter::drain() {
+    if (used == 0) {
+        return;
+    }
+    if (fwrite(buffer.data(), 1, used, file) != used) {
+        throw runtime_error("Unable to write file: " + tempName);
+    }
+    written += used;
+    used = 0;
+}
+
+/**
+ * @brief Appends raw text.
+ *
+ * @param text The text
+ */
+void AtomicFileWriter::write(string_view text) {
+    if (text.size() > buffer.size() - used) {
+        drain();
+        if (text.size() > buffer.size()) {
+            if (fwrite(text.data(), 1, text.size(), file) != text.size()) {
+                throw runtime_error("Unable to write file: " + tempName);
+            }
+            written += text.size();
+            return;
+        }
+    }
+    memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+}
+
+/**
+ * @brief Flushes, fsyncs and renames the temp file over the target.
+ *
+ * @return The number of bytes written.
+ *
+ * @throws runtime_error If any step fails; the target is then left untouched.
+ */
+uint64_t AtomicFileWriter::commit() {
+    drain();
+    bool ok = fflush(file) == 0 && (!syncWrites || syncFile(file));
+    ok = fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        remove(tempName.c_str());
+        throw runtime_error("Unable to write file: " + tempName);
+    }
+
+    error_code ec;
+    filesystem::rename(tempName, filename, ec);
+    if (ec) {
+        remove(tempName.c_str());
+        throw runtime_error("Unable to replace " + filename + ": " + ec.message());
+    }
+
+#ifndef _WIN32
+    // Persist the rename itself: the new directory entry lives in the directory, not in the file
+    if (syncWrites) {
+        string directory = filesystem::path(filename).parent_path().string();
+        int dirFd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+        if (dirFd >= 0) {
+            fsync(dirFd);
+            close(dirFd);
+        }
+    }
+#endif
+    return written;
+}
+
+/**
+ * @brief Forces a stdio stream's data to the device.
+ *
+ * @param file The open stream, already flushed.
+ * @return True on success.
+ */
+bool AtomicFileWriter::syncFile(FILE *file) {
+    FOREST_TRACE_SPAN("fsync");
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
@@ -0,0 +1,86 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_ATOMICFILEWRITER_H
+#define ADS_MIDTERM_PROJECT_ATOMICFILEWRITER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class AtomicFileWriter
+ * @brief Writes a file through a large buffer into a temp file, then fsyncs and renames it over the target.
+ *
+ * Readers (and a restart after a crash) see either the complete old file or the complete new one, never a torn mix.
+ * Numbers are formatted with `to_chars` straight into the buffer, so no stream or locale machinery runs per field.
+ * If the writer is destroyed without `commit()`, the temp file is removed and the target is left untouched.
+ *
+ * Errors are reported by throwing `runtime_error`, like the other file writers of the project.
+ */
+class AtomicFileWriter {
+private:
+    string filename;        ///< The file being replaced
+    string tempName;        ///< The temp file being written
+    FILE *file;             ///< The open temp file, or null once committed or abandoned
+    vector<char> buffer;    ///< Bytes not yet handed to the OS
+    size_t used;            ///< Bytes of `buffer` in use
+    uint64_t written;       ///< Bytes handed to the OS so far
+    bool syncWrites;        ///< Whether `commit` fsyncs the file and its directory
+
+    /**
+     * @brief Hands the buffered bytes to the OS.
+     */
+    void drain();
+
+public:
+    /**
+     * @brief Opens the temp file next to the target.
+     *
+     * @param filename The file to replace on `commit()`.
+     * @param syncWrites Whether `commit` fsyncs before renaming, so the new contents survive a power loss.
+     * @param bufferSize Size of the write buffer in bytes.
+     *
+     * @throws runtime_error If the temp file cannot be created.
+     */
+    explicit AtomicFileWriter(const string &filename, bool syncWrites = true, size_t bufferSize = 1 << 20);
+
+    /**
+     * @brief Removes the temp file unless `commit()` succeeded.
+     */
+    ~AtomicFileWriter();
+
+    AtomicFileWriter(const AtomicFileWriter &) = delete;
+    AtomicFileWriter &operator=(const AtomicFileWriter &) = delete;
+
+    /**
+     * @brief Appends raw text.
+     *
+     * @param text The text
+     */
+    void write(string_view text);
+
+    /**
+     * @brief Flushes, fsyncs and renames the temp file over the target.
+     *
+     * @return The number of bytes written.
+     *
+     * @throws runtime_error If any step fails; the target is then left untouched.
+     */
+    uint64_t commit();
+
+    /**
+     * @brief Forces a stdio stream's data to the device.
+     *
+     * @param file The open stream, already flushed.
+     * @return True on success.
+     */
+    static bool syncFile(FILE *file);
+};
+
+#endif //ADS_MIDTERM_PROJECT_ATOMICFILEWRITER_H
@@ -0,0 +1,287 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file BalanceIndex.cpp
+ * @brief Implements `BalanceIndex`, a treap-based order-statistic index over account balances.
+ */
+
+#include "BalanceIndex.h"
+#include <limits>
+
+using namespace std;
+
+/**
+ * @brief Creates an empty index.
+ */
+BalanceIndex::BalanceIndex() : root(nullptr), seed(2463534242u) {}
+
+/**
+ * @brief Frees every node of the index.
+ */
+BalanceIndex::~BalanceIndex() {
+    destroy(root);
+}
+
+/**
+ * @brief Inserts an account, or moves it to a new balance if it is already indexed.
+ *
+ * @param accountNumber The account number.
+ * @param balance The current balance of the account.
+ */
+void BalanceIndex::update(int accountNumber, double balance) {
+    auto it = balances.find(accountNumber);
+    if (it != balances.end()) {
+        if (it->second == balance) {
+            return;
+        }
+        root = erase(root, it->second, accountNumber);
+        it->second = balance;
+    } else {
+        balances[accountNumber] = balance;
+    }
+
+    IndexNode *node = new IndexNode{balance, accountNumber, nextPriority(), 1, nullptr, nullptr};
+    IndexNode *left, *right;
+    split(root, balance, accountNumber, left, right);
+    root = merge(merge(left, node), right);
+}
+
+/**
+ * @brief Removes an account from the index.
+ *
+ * @param accountNumber The account number.
+ */
+void BalanceIndex::remove(int accountNumber) {
+    auto it = balances.find(accountNumber);
+    if (it == balances.end()) {
+        return;
+    }
+    root = erase(root, it->second, accountNumber);
+    balances.erase(it);
+}
+
+/**
+ * @brief Removes every account from the index.
+ */
+void BalanceIndex::clear() {
+    destroy(root);
+    root = nullptr;
+    balances.clear();
+}
+
+/**
+ * @brief Returns the number of indexed accounts.
+ *
+ * @return The account count.
+ */
+size_t BalanceIndex::size() const {
+    return sizeOf(root);
+}
+
+/**
+ * @brief Counts the accounts whose balance is strictly below a threshold.
+ *
+ * @param threshold The balance threshold.
+ * @return The number of accounts below the threshold.
+ */
+size_t BalanceIndex::countBelow(double threshold) const {
+    return countByBalance(threshold, false);
+}
+
+/**
+ * @brief Counts the accounts whose balance lies in an inclusive range.
+ *
+ * @param low The lowest balance to include.
+ * @param high The highest balance to include.
+ * @return The number of accounts in the range.
+ */
+size_t BalanceIndex::countBetween(double low, double high) const {
+    if (high < low) {
+        return 0;
+    }
+    return countByBalance(high, true) - countByBalance(low, false);
+}
+
+/**
+ * @brief Lists the accounts whose balance is strictly below a threshold.
+ *
+ * @param threshold The balance threshold.
+ * @return The account numbers, in ascending balance order.
+ */
+vector<int> BalanceIndex::accountsBelow(double threshold) const {
+    vector<int> result;
+    collect(root, -numeric_limits<double>::infinity(), threshold, false, result);
+    return result;
+}
+
+/**
+ * @brief Lists the accounts whose balance lies in an inclusive range.
+ *
+ * @param low The lowest balance to include.
+ * @param high The highest balance to include.
+ * @return The account numbers, in ascending balance order.
+ */
+vector<int> BalanceIndex::accountsBetween(double low, double high) const {
+    vector<int> result;
+    collect(root, low, high, true, result);
+    return result;
+}
+
+/**
+ * @brief Returns the rank of an account by balance.
+ *
+ * @param accountNumber The account number.
+ * @return The number of accounts ordered before it, or -1 if it is not indexed.
+ */
+long BalanceIndex::rankOf(int accountNumber) const {
+    auto it = balances.find(accountNumber);
+    if (it == balances.end()) {
+        return -1;
+    }
+
+    size_t rank = 0;
+    const IndexNode *node = root;
+    while (node) {
+        if (lessThan(node->balance, node->accountNumber, it->second, accountNumber)) {
+            rank += sizeOf(node->left) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return static_cast<long>(rank);
+}
+
+/**
+ * @brief Returns the account at a given rank.
+ *
+ * @param rank The 0-based rank, counting from the lowest balance.
+ * @return The account number, or -1 if the rank is out of range.
+ */
+int BalanceIndex::accountAt(size_t rank) const {
+    const IndexNode *node = root;
+    while (node) {
+        size_t leftSize = sizeOf(node->left);
+        if (rank < leftSize) {
+            node = node->left;
+        } else if (rank == leftSize) {
+            return node->accountNumber;
+        } else {
+            rank -= leftSize + 1;
+            node = node->right;
+        }
+    }
+    return -1;
+}
+
+size_t BalanceIndex::sizeOf(const IndexNode *node) {
+    return node ? node->size : 0;
+}
+
+void BalanceIndex::refresh(IndexNode *node) {
+    node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+}
+
+bool BalanceIndex::lessThan(double balanceA, int accountA, double balanceB, int accountB) {
+    return balanceA < balanceB || (balanceA == balanceB && accountA < accountB);
+}
+
+void BalanceIndex::split(IndexNode *node, double balance, int accountNumber, IndexNode *&left, IndexNode *&right) {
+    if (!node) {
+        left = right = nullptr;
+        return;
+    }
+    if (lessThan(node->balance, node->accountNumber, balance, accountNumber)) {
+        split(node->right, balance, accountNumber, node->right, right);
+        left = node;
+    } else {
+        split(node->left, balance, accountNumber, left, node->left);
+        right = node;
+    }
+    refresh(node);
+}
+
+BalanceIndex::IndexNode *BalanceIndex::merge(IndexNode *left, IndexNode *right) {
+    if (!left) return right;
+    if (!right) return left;
+    if (left->priority > right->priority) {
+        left->right = merge(left->right, right);
+        refresh(left);
+        return left;
+    }
+    right->left = merge(left, right->left);
+    refresh(right);
+    return right;
+}
+
+BalanceIndex::IndexNode *BalanceIndex::erase(IndexNode *node, double balance, int accountNumber) {
+    if (!node) {
+        return nullptr;
+    }
+    if (node->balance == balance && node->accountNumber == accountNumber) {
+        IndexNode *joined = merge(node->left, node->right);
+        delete node;
+        return joined;
+    }
+    if (lessThan(balance, accountNumber, node->balance, node->accountNumber)) {
+        node->left = erase(node->left, balance, accountNumber);
+    } else {
+        node->right = erase(node->right, balance, accountNumber);
+    }
+    refresh(node);
+    return node;
+}
+
+void BalanceIndex::destroy(IndexNode *node) {
+    // Free iteratively so a degenerate treap cannot overflow the stack
+    vector<IndexNode *> stack;
+    if (node) stack.push_back(node);
+    while (!stack.empty()) {
+        IndexNode *current = stack.back();
+        stack.pop_back();
+        if (current->left) stack.push_back(current->left);
+        if (current->right) stack.push_back(current->right);
+        delete current;
+    }
+}
+
+size_t BalanceIndex::countByBalance(double balance, bool inclusive) const {
+    size_t count = 0;
+    const IndexNode *node = root;
+    while (node) {
+        if (node->balance < balance || (inclusive && node->balance == balance)) {
+            count += sizeOf(node->left) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return count;
+}
+
+void BalanceIndex::collect(const IndexNode *node, double low, double high, bool highInclusive, vector<int> &out) {
+    if (!node) {
+        return;
+    }
+    bool aboveLow = node->balance >= low;
+    bool belowHigh = node->balance < high || (highInclusive && node->balance == high);
+    if (aboveLow) {
+        collect(node->left, low, high, highInclusive, out);
+    }
+    if (aboveLow && belowHigh) {
+        out.push_back(node->accountNumber);
+    }
+    if (belowHigh) {
+        collect(node->right, low, high, highInclusive, out);
+    }
+}
+
+uint32_t BalanceIndex::nextPriority() {
+    // xorshift32
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
@@ -0,0 +1,181 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_BALANCEINDEX_H
+#define ADS_MIDTERM_PROJECT_BALANCEINDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class BalanceIndex
+ * @brief An order-statistic index of account balances.
+ *
+ * Accounts are kept in a treap ordered by (balance, account number), where every node also stores the size of its
+ * subtree. This gives O(log n) updates, counts and ranks, and O(log n + k) range listings, instead of a full walk of
+ * the chart of accounts. The forest keeps the index in step with every balance change.
+ */
+class BalanceIndex {
+private:
+    struct IndexNode {
+        double balance;     ///< The balance of the account (primary key)
+        int accountNumber;  ///< The account number (tie breaker)
+        uint32_t priority;  ///< Random heap priority
+        size_t size;        ///< Number of nodes in this subtree
+        IndexNode *left;    ///< Smaller keys
+        IndexNode *right;   ///< Larger keys
+    };
+
+    IndexNode *root;                        ///< Root of the treap
+    unordered_map<int, double> balances;    ///< Balance currently indexed for each account
+    uint32_t seed;                          ///< State of the priority generator
+
+public:
+    /**
+     * @brief Creates an empty index.
+     */
+    BalanceIndex();
+
+    /**
+     * @brief Frees every node of the index.
+     */
+    ~BalanceIndex();
+
+    BalanceIndex(const BalanceIndex &) = delete;
+    BalanceIndex &operator=(const BalanceIndex &) = delete;
+
+    /**
+     * @brief Inserts an account, or moves it to a new balance if it is already indexed.
+     *
+     * @param accountNumber The account number
+     * @param balance The current balance of the account
+     */
+    void update(int accountNumber, double balance);
+
+    /**
+     * @brief Removes an account from the index.
+     *
+     * @param accountNumber The account number
+     */
+    void remove(int accountNumber);
+
+    /**
+     * @brief Removes every account from the index.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of indexed accounts.
+     *
+     * @return The account count
+     */
+    size_t size() const;
+
+    /**
+     * @brief Counts the accounts whose balance is strictly below a threshold.
+     *
+     * @param threshold The balance threshold
+     * @return The number of accounts below the threshold
+     */
+    size_t countBelow(double threshold) const;
+
+    /**
+     * @brief Counts the accounts whose balance lies in an inclusive range.
+     *
+     * @param low The lowest balance to include
+     * @param high The highest balance to include
+     * @return The number of accounts in the range
+     */
+    size_t countBetween(double low, double high) const;
+
+    /**
+     * @brief Lists the accounts whose balance is strictly below a threshold, in ascending balance order.
+     *
+     * @param threshold The balance threshold
+     * @return The account numbers
+     */
+    vector<int> accountsBelow(double threshold) const;
+
+    /**
+     * @brief Lists the accounts whose balance lies in an inclusive range, in ascending balance order.
+     *
+     * @param low The lowest balance to include
+     * @param high The highest balance to include
+     * @return The account numbers
+     */
+    vector<int> accountsBetween(double low, double high) const;
+
+    /**
+     * @brief Returns the rank of an account by balance.
+     *
+     * @param accountNumber The account number
+     * @return The number of accounts ordered before it (0 for the lowest balance), or -1 if it is not indexed
+     */
+    long rankOf(int accountNumber) const;
+
+    /**
+     * @brief Returns the account at a given rank.
+     *
+     * @param rank The 0-based rank, counting from the lowest balance
+     * @return The account number, or -1 if the rank is out of range
+     */
+    int accountAt(size_t rank) const;
+
+private:
+    /**
+     * @brief Returns the subtree size of a node, 0 for null.
+     */
+    static size_t sizeOf(const IndexNode *node);
+
+    /**
+     * @brief Recomputes the subtree size of a node from its children.
+     */
+    static void refresh(IndexNode *node);
+
+    /**
+     * @brief Compares two (balance, account number) keys.
+     */
+    static bool lessThan(double balanceA, int accountA, double balanceB, int accountB);
+
+    /**
+     * @brief Splits a treap into keys smaller than (balance, accountNumber) and the rest.
+     */
+    static void split(IndexNode *node, double balance, int accountNumber, IndexNode *&left, IndexNode *&right);
+
+    /**
+     * @brief Joins two treaps where every key of `left` is smaller than every key of `right`.
+     */
+    static IndexNode *merge(IndexNode *left, IndexNode *right);
+
+    /**
+     * @brief Removes one key from a treap and returns the new root.
+     */
+    static IndexNode *erase(IndexNode *node, double balance, int accountNumber);
+
+    /**
+     * @brief Frees a whole treap.
+     */
+    static void destroy(IndexNode *node);
+
+    /**
+     * @brief Counts the accounts whose balance is below (or, if inclusive, at most) a value.
+     */
+    size_t countByBalance(double balance, bool inclusive) const;
+
+    /**
+     * @brief Appends the accounts of a subtree whose balance lies in a range, in order.
+     */
+    static void collect(const IndexNode *node, double low, double high, bool highInclusive, vector<int> &out);
+
+    /**
+     * @brief Draws the next random heap priority.
+     */
+    uint32_t nextPriority();
+};
+
+#endif //ADS_MIDTERM_PROJECT_BALANCEINDEX_H
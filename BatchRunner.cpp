@@ -0,0 +1,394 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file BatchRunner.cpp
+ * @brief Implements `BatchRunner`, the headless command mode of the chart of accounts program.
+ */
+
+#include "BatchRunner.h"
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * @brief Returns the throughput of the run.
+ *
+ * @return Commands per second, or 0 if the run took no measurable time
+ */
+double BatchStats::opsPerSecond() const {
+    return seconds > 0.0 ? operations / seconds : 0.0;
+}
+
+/**
+ * @brief Creates a runner bound to a forest and its chart of accounts file.
+ *
+ * @param tree The forest the commands run against.
+ * @param accountsPath The chart of accounts file that `add-account` updates.
+ * @param batchSize Maximum number of commands per bulk call.
+ */
+BatchRunner::BatchRunner(ForestTree &tree, const string &accountsPath, size_t batchSize)
+        : tree(tree), accountsPath(accountsPath), batchSize(batchSize > 0 ? batchSize : 1) {}
+
+/**
+ * @brief Executes every command read from a stream.
+ *
+ * @param in The command stream.
+ * @param out The stream receiving one JSON result line per command and a final summary line.
+ * @return The throughput summary of the run.
+ */
+BatchStats BatchRunner::run(istream &in, ostream &out) {
+    stats = BatchStats();
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    string line;
+    size_t lineNumber = 0;
+    while (getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        size_t first = line.find_first_not_of(" \t");
+        if (first == string::npos || line[first] == '#') {
+            continue;
+        }
+        execute(line, lineNumber, out);
+    }
+    flush(out);
+
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    out << fixed << setprecision(6)
+        << "{\"summary\":{\"operations\":" << stats.operations
+        << ",\"failed\":" << stats.failed
+        << ",\"batches\":" << stats.batches
+        << ",\"seconds\":" << stats.seconds
+        << ",\"ops_per_sec\":" << setprecision(1) << stats.opsPerSecond() << "}}" << endl;
+    return stats;
+}
+
+/**
+ * @brief Parses and executes one command line.
+ *
+ * @param line The command text.
+ * @param lineNumber The 1-based input line, echoed in the result.
+ * @param out The stream receiving the result.
+ */
+void BatchRunner::execute(const string &line, size_t lineNumber, ostream &out) {
+    istringstream iss(line);
+    string op;
+    iss >> op;
+
+    // A different command ends the current batch, so it sees every earlier posting, deletion or new account. A
+    // malformed post, delete or add-account flushes too, so results always come out in input order.
+    if (op != pendingOp) {
+        flush(out);
+    }
+
+    try {
+        if (op == "post") {
+            int accountNumber;
+            string id, amount, type, date, description;
+            if (!(iss >> accountNumber >> id >> amount >> type >> date) || type.size() != 1) {
+                flush(out);
+                writeResult(out, lineNumber, op, false, "\"error\":\"usage: post <account> <id> <amount> <D|C> <date> [description]\"");
+                return;
+            }
+            getline(iss >> ws, description);
+
+            // The constructor would quietly turn these into a debit or a zero amount
+            double value = stod(amount);
+            if ((type[0] != 'D' && type[0] != 'C') || !(value >= 0)) {
+                flush(out);
+                writeResult(out, lineNumber, op, false, "\"error\":\"type must be D or C and amount not negative\"");
+                return;
+            }
+
+            Transaction transaction(id, value, type[0], description, date);
+            if (!transaction.isValid()) {
+                flush(out);
+                writeResult(out, lineNumber, op, false, "\"error\":\"invalid transaction\"");
+                return;
+            }
+            pendingOp = op;
+            pendingPostings.emplace_back(accountNumber, transaction);
+            pendingLines.push_back(lineNumber);
+            if (pendingPostings.size() >= batchSize) {
+                flush(out);
+            }
+        } else if (op == "delete") {
+            int accountNumber, index;
+            if (!(iss >> accountNumber >> index)) {
+                flush(out);
+                writeResult(out, lineNumber, op, false, "\"error\":\"usage: delete <account> <index>\"");
+                return;
+            }
+            pendingOp = op;
+            pendingDeletions.emplace_back(accountNumber, index);
+            pendingLines.push_back(lineNumber);
+            if (pendingDeletions.size() >= batchSize) {
+                flush(out);
+            }
+        } else if (op == "add-account") {
+            int accountNumber;
+            double balance;
+            string description;
+            if (!(iss >> accountNumber >> balance) || accountNumber <= 0) {
+                flush(out);
+                writeResult(out, lineNumber, op, false, "\"error\":\"usage: add-account <number> <balance> <description>\"");
+                return;
+            }
+            getline(iss >> ws, description);
+
+            Account account;
+            account.setAccountNumber(accountNumber);
+            account.setDescription(description);
+            account.setBalance(balance);
+            pendingOp = op;
+            pendingAccounts.push_back(account);
+            pendingLines.push_back(lineNumber);
+            if (pendingAccounts.size() >= batchSize) {
+                flush(out);
+            }
+        } else if (op == "report") {
+            int accountNumber;
+            string filename;
+            if (!(iss >> accountNumber >> filename)) {
+                writeResult(out, lineNumber, op, false, "\"error\":\"usage: report <account> <file>\"");
+                return;
+            }
+            if (!tree.findAccount(accountNumber)) {
+                writeResult(out, lineNumber, op, false, "\"error\":\"account not found\"");
+                return;
+            }
+            tree.printDetailedReport(accountNumber, filename);
+            writeResult(out, lineNumber, op, true, "\"file\":\"" + jsonEscape(filename) + "\"");
+        } else if (op == "query") {
+            int accountNumber;
+            if (!(iss >> accountNumber)) {
+                writeResult(out, lineNumber, op, false, "\"error\":\"usage: query <account> [key=value...]\"");
+                return;
+            }
+
+            TransactionQuery filter;
+            string option;
+            while (iss >> option) {
+                size_t eq = option.find('=');
+                string key = option.substr(0, eq);
+                string value = eq == string::npos ? "" : option.substr(eq + 1);
+                if ((key == "from" || key == "to") && Transaction::toDayKey(value) == 0) {
+                    writeResult(out, lineNumber, op, false, "\"error\":\"invalid date: " + jsonEscape(value) + "\"");
+                    return;
+                }
+                if (key == "from") filter.fromDayKey = Transaction::toDayKey(value);
+                else if (key == "to") filter.toDayKey = Transaction::toDayKey(value);
+                else if (key == "min") filter.minAmount = stod(value);
+                else if (key == "max") filter.maxAmount = stod(value);
+                else if (key == "type" && value.size() == 1) filter.debitCredit = value[0];
+                else if (key == "text") filter.descriptionContains = value;
+                else {
+                    writeResult(out, lineNumber, op, false, "\"error\":\"unknown filter: " + jsonEscape(option) + "\"");
+                    return;
+                }
+            }
+
+            if (!tree.findAccount(accountNumber)) {
+                writeResult(out, lineNumber, op, false, "\"error\":\"account not found\"");
+                return;
+            }
+
+            ostringstream hits;
+            hits << fixed << setprecision(2) << "\"transactions\":[";
+            bool firstHit = true;
+            size_t matches = tree.query(accountNumber, filter, [&](const Account &account, const Transaction &t) {
+                hits << (firstHit ? "" : ",")
+                     << "{\"account\":" << account.getAccountNumber()
+                     << ",\"id\":\"" << jsonEscape(t.getTransactionID())
+                     << "\",\"amount\":" << t.getAmount()
+                     << ",\"type\":\"" << t.getDebitCredit()
+                     << "\",\"date\":\"" << jsonEscape(t.getDate())
+                     << "\",\"description\":\"" << jsonEscape(t.getDescription()) << "\"}";
+                firstHit = false;
+                return true;
+            });
+            hits << "]";
+            writeResult(out, lineNumber, op, true, "\"matches\":" + to_string(matches) + "," + hits.str());
+        } else if (op == "audit") {
+            AuditReport report = tree.audit();
+            writeResult(out, lineNumber, op, report.clean(), auditMembers(report));
+        } else if (op == "rebuild-balances") {
+            AuditReport report = tree.rebuildBalances();
+            if (!report.clean()) {
+                tree.saveToFile(accountsPath);
+            }
+            writeResult(out, lineNumber, op, true, auditMembers(report));
+        } else if (op == "fingerprint") {
+            writeResult(out, lineNumber, op, true,
+                        "\"fingerprint\":\"" + LedgerDigest::toHex(tree.fingerprint()) + "\"");
+        } else if (op == "diff") {
+            string filename;
+            if (!(iss >> filename)) {
+                writeResult(out, lineNumber, op, false, "\"error\":\"usage: diff <chart file>\"");
+                return;
+            }
+            if (!ifstream(filename)) {
+                writeResult(out, lineNumber, op, false, "\"error\":\"cannot open " + jsonEscape(filename) + "\"");
+                return;
+            }
+            ForestTree other;
+            other.buildFromFile(filename);
+            vector<LedgerDifference> differences = tree.diff(other);
+            writeResult(out, lineNumber, op, differences.empty(), diffMembers(differences));
+        } else {
+            writeResult(out, lineNumber, op, false, "\"error\":\"unknown command\"");
+        }
+    } catch (const invalid_argument &) {
+        flush(out);
+        writeResult(out, lineNumber, op, false, "\"error\":\"invalid number\"");
+    } catch (const out_of_range &) {
+        flush(out);
+        writeResult(out, lineNumber, op, false, "\"error\":\"number out of range\"");
+    } catch (const exception &e) {
+        flush(out);
+        writeResult(out, lineNumber, op, false, "\"error\":\"" + jsonEscape(e.what()) + "\"");
+    }
+}
+
+/**
+ * @brief Applies the buffered postings, deletions or new accounts and writes their results.
+ *
+ * @param out The stream receiving the results.
+ */
+void BatchRunner::flush(ostream &out) {
+    if (pendingLines.empty()) {
+        pendingOp.clear();
+        return;
+    }
+
+    vector<bool> applied;
+    string error;
+    vector<string> errors;
+    string warning;
+    if (pendingOp == "post") {
+        applied = tree.postTransactions(pendingPostings);
+        error = "\"error\":\"account not found\"";
+        // A posting to an existing account only fails when its ID was already posted
+        errors.resize(applied.size());
+        for (size_t i = 0; i < applied.size(); ++i) {
+            if (!applied[i] && tree.findAccount(pendingPostings[i].first)) {
+                errors[i] = "\"error\":\"duplicate transaction ID\"";
+            }
+        }
+    } else if (pendingOp == "delete") {
+        applied = tree.deleteTransactions(pendingDeletions);
+        error = "\"error\":\"account or index not found\"";
+    } else {
+        applied = tree.addAccounts(move(pendingAccounts), accountsPath);
+        error = "\"error\":\"duplicate account or missing parent\"";
+        // The accounts are added even if the chart could not be written; it is saved again by the final commit
+        if (tree.hasChartWriteFailed()) {
+            warning = "\"warning\":\"chart not saved\"";
+        }
+    }
+    ++stats.batches;
+
+    for (size_t i = 0; i < pendingLines.size(); ++i) {
+        const string &failure = i < errors.size() && !errors[i].empty() ? errors[i] : error;
+        writeResult(out, pendingLines[i], pendingOp, applied[i], applied[i] ? warning : failure);
+    }
+
+    pendingPostings.clear();
+    pendingDeletions.clear();
+    pendingAccounts.clear();
+    pendingLines.clear();
+    pendingOp.clear();
+}
+
+/**
+ * @brief Writes the result of one command and updates the counters.
+ *
+ * @param out The stream receiving the result.
+ * @param lineNumber The input line of the command.
+ * @param op The command name.
+ * @param ok Whether the command succeeded.
+ * @param extra Additional JSON members (without a leading comma), or empty.
+ */
+void BatchRunner::writeResult(ostream &out, size_t lineNumber, const string &op, bool ok, const string &extra) {
+    ++stats.operations;
+    if (!ok) {
+        ++stats.failed;
+    }
+    out << "{\"line\":" << lineNumber << ",\"op\":\"" << jsonEscape(op) << "\",\"ok\":" << (ok ? "true" : "false");
+    if (!extra.empty()) {
+        out << "," << extra;
+    }
+    out << "}\n";
+}
+
+/**
+ * @brief Formats the members describing an audit report.
+ *
+ * @param report The report.
+ * @return `"checked":N,"mismatches":[...]`, ready to pass as `extra` to `writeResult`.
+ */
+string BatchRunner::auditMembers(const AuditReport &report) {
+    ostringstream members;
+    members << fixed << setprecision(2) << "\"checked\":" << report.accountsChecked << ",\"mismatches\":[";
+    for (size_t i = 0; i < report.mismatches.size(); ++i) {
+        const BalanceMismatch &mismatch = report.mismatches[i];
+        members << (i ? "," : "") << "{\"account\":" << mismatch.accountNumber
+                << ",\"stored\":" << mismatch.stored << ",\"computed\":" << mismatch.computed << "}";
+    }
+    members << "]";
+    return members.str();
+}
+
+/**
+ * @brief Formats the members describing the differences between two ledgers.
+ *
+ * @param differences The differences found by `ForestTree::diff`.
+ * @return `"differences":[...]`, ready to pass as `extra` to `writeResult`.
+ */
+string BatchRunner::diffMembers(const vector<LedgerDifference> &differences) {
+    static const char *const KIND_NAMES[] = {"only_here", "only_there", "changed"};
+    string members = "\"differences\":[";
+    for (size_t i = 0; i < differences.size(); ++i) {
+        members += (i ? ",{\"account\":" : "{\"account\":") + to_string(differences[i].accountNumber)
+                   + ",\"kind\":\"" + KIND_NAMES[differences[i].kind] + "\"}";
+    }
+    members += "]";
+    return members;
+}
+
+/**
+ * @brief Escapes a string for use inside a JSON string literal.
+ *
+ * @param text The text to escape.
+ * @return The escaped text, without surrounding quotes.
+ */
+string BatchRunner::jsonEscape(string_view text) {
+    string escaped;
+    escaped.reserve(text.size());
+    for (char c: text) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    escaped += buffer;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
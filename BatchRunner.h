@@ -0,0 +1,151 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_BATCHRUNNER_H
+#define ADS_MIDTERM_PROJECT_BATCHRUNNER_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ForestTree.h"
+
+using namespace std;
+
+/**
+ * @struct BatchStats
+ * @brief Throughput summary of a batch run.
+ */
+struct BatchStats {
+    size_t operations = 0;  ///< Commands executed, including failed ones
+    size_t failed = 0;      ///< Commands that reported `"ok":false`
+    size_t batches = 0;     ///< Bulk add-account/post/delete calls made
+    double seconds = 0.0;   ///< Wall-clock time of the whole run
+
+    /**
+     * @brief Returns the throughput of the run.
+     *
+     * @return Commands per second, or 0 if the run took no measurable time
+     */
+    double opsPerSecond() const;
+};
+
+/**
+ * @class BatchRunner
+ * @brief Executes a stream of text commands against a `ForestTree` without any prompts.
+ *
+ * One command per line, fields separated by whitespace; blank lines and lines starting with `#` are ignored:
+ *
+ *     add-account <number> <balance> <description...>
+ *     post <account> <transactionID> <amount> <D|C> <DD-MM-YY> [description...]
+ *     delete <account> <index>
+ *     report <account> <file>
+ *     query <account> [from=DD-MM-YY] [to=DD-MM-YY] [min=X] [max=X] [type=D|C] [text=word]
+ *     audit
+ *     rebuild-balances
+ *     fingerprint
+ *     diff <chart file>
+ *
+ * Consecutive `post` commands (and consecutive `delete` or `add-account` commands) are buffered and applied through
+ * `ForestTree::postTransactions` / `ForestTree::deleteTransactions` / `ForestTree::addAccounts`, so the transaction
+ * file or the chart is written once per batch rather than once per command. Within one `add-account` batch a parent
+ * may be listed after its children. Any other command flushes the pending batch first, so commands always observe the
+ * effects of the lines before them. `audit` fails if any balance disagrees with its transactions; `rebuild-balances`
+ * corrects every such balance and saves the chart. `fingerprint` prints the digest of the whole ledger; `diff` loads
+ * another chart (with its transaction file) and lists the accounts that differ from it, failing if any do. A `post`
+ * whose transaction ID is already in the forest fails as a duplicate, so replaying a command file posts nothing twice.
+ * Postings and deletions change balances, so the chart is saved along with the transaction file whenever the tree's
+ * durability policy writes the pending changes, and so are the accounts of an `add-account` batch. If the chart could
+ * not be saved, the added accounts still report `"ok":true`, with `"warning":"chart not saved"`, and the chart is
+ * saved again by the final commit.
+ *
+ * Every command produces one JSON line on the output stream, in input order, e.g.
+ * `{"line":3,"op":"post","ok":true}`, followed by a final `{"summary":...}` line with the throughput.
+ */
+class BatchRunner {
+private:
+    ForestTree &tree;                       ///< The forest the commands run against
+    string accountsPath;                    ///< The chart of accounts file that `add-account` updates
+    size_t batchSize;                       ///< Maximum number of commands per bulk call
+
+    vector<Posting> pendingPostings;        ///< Buffered `post` commands
+    vector<pair<int, int>> pendingDeletions;///< Buffered `delete` commands
+    vector<Account> pendingAccounts;        ///< Buffered `add-account` commands
+    vector<size_t> pendingLines;            ///< Input line of each buffered command
+    string pendingOp;                       ///< "post", "delete", "add-account", or empty when nothing is buffered
+
+    BatchStats stats;                       ///< Counters of the current run
+
+    /**
+     * @brief Parses and executes one command line.
+     *
+     * @param line The command text.
+     * @param lineNumber The 1-based input line, echoed in the result.
+     * @param out The stream receiving the result.
+     */
+    void execute(const string &line, size_t lineNumber, ostream &out);
+
+    /**
+     * @brief Applies the buffered postings, deletions or new accounts and writes their results.
+     *
+     * @param out The stream receiving the results.
+     */
+    void flush(ostream &out);
+
+    /**
+     * @brief Writes the result of one command and updates the counters.
+     *
+     * @param out The stream receiving the result.
+     * @param lineNumber The input line of the command.
+     * @param op The command name.
+     * @param ok Whether the command succeeded.
+     * @param extra Additional JSON members (without a leading comma), or empty.
+     */
+    void writeResult(ostream &out, size_t lineNumber, const string &op, bool ok, const string &extra = "");
+
+    /**
+     * @brief Escapes a string for use inside a JSON string literal.
+     *
+     * @param text The text to escape.
+     * @return The escaped text, without surrounding quotes.
+     */
+    static string jsonEscape(string_view text);
+
+    /**
+     * @brief Formats the members describing an audit report.
+     *
+     * @param report The report.
+     * @return `"checked":N,"mismatches":[...]`, ready to pass as `extra` to `writeResult`.
+     */
+    static string auditMembers(const AuditReport &report);
+
+    /**
+     * @brief Formats the members describing the differences between two ledgers.
+     *
+     * @param differences The differences found by `ForestTree::diff`.
+     * @return `"differences":[...]`, ready to pass as `extra` to `writeResult`.
+     */
+    static string diffMembers(const vector<LedgerDifference> &differences);
+
+public:
+    /**
+     * @brief Creates a runner bound to a forest and its chart of accounts file.
+     *
+     * @param tree The forest the commands run against.
+     * @param accountsPath The chart of accounts file that `add-account` updates.
+     * @param batchSize Maximum number of commands per bulk call.
+     */
+    BatchRunner(ForestTree &tree, const string &accountsPath, size_t batchSize = 1024);
+
+    /**
+     * @brief Executes every command read from a stream.
+     *
+     * @param in The command stream.
+     * @param out The stream receiving one JSON result line per command and a final summary line.
+     * @return The throughput summary of the run.
+     */
+    BatchStats run(istream &in, ostream &out);
+};
+
+#endif //ADS_MIDTERM_PROJECT_BATCHRUNNER_H
@@ -0,0 +1,157 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file Crc32c.cpp
+ * @brief Implements `Crc32c` with the SSE4.2 `crc32` instruction and a slice-by-8 table fallback.
+ */
+
+#include "Crc32c.h"
+#include <cstring>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define FOREST_CRC32C_SSE42 1
+#endif
+
+using namespace std;
+
+/**
+ * @brief The Castagnoli polynomial, bit-reversed.
+ */
+static const uint32_t POLYNOMIAL = 0x82F63B78u;
+
+/**
+ * @brief Slice-by-8 lookup tables: `table[k][b]` is the CRC of byte `b` followed by `k` zero bytes.
+ */
+struct SliceTables {
+    uint32_t table[8][256];
+
+    SliceTables() {
+        for (uint32_t b = 0; b < 256; ++b) {
+            uint32_t crc = b;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? POLYNOMIAL : 0);
+            }
+            table[0][b] = crc;
+        }
+        for (uint32_t b = 0; b < 256; ++b) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+            }
+        }
+    }
+};
+
+/**
+ * @brief Software implementation, eight bytes per step through the slice tables.
+ *
+ * @param crc The running (inverted) checksum
+ * @param p The bytes
+ * @param size The number of bytes
+ * @return The updated (inverted) checksum
+ */
+static uint32_t extendTable(uint32_t crc, const unsigned char *p, size_t size) {
+    static const SliceTables tables;
+    const uint32_t (*t)[256] = tables.table;
+    while (size >= 8) {
+        uint32_t low;
+        uint32_t high;
+        memcpy(&low, p, 4);
+        memcpy(&high, p + 4, 4);
+        low ^= crc;  // Little-endian byte order, as on every platform the project builds for
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef FOREST_CRC32C_SSE42
+/**
+ * @brief Hardware implementation with the SSE4.2 `crc32` instruction.
+ *
+ * @param crc The running (inverted) checksum
+ * @param p The bytes
+ * @param size The number of bytes
+ * @return The updated (inverted) checksum
+ */
+__attribute__((target("sse4.2")))
+static uint32_t extendHardware(uint32_t crc, const unsigned char *p, size_t size) {
+#ifdef __x86_64__
+    uint64_t wide = crc;
+    while (size >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        wide = _mm_crc32_u64(wide, word);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(wide);
+#endif
+    while (size >= 4) {
+        uint32_t word;
+        memcpy(&word, p, 4);
+        crc = _mm_crc32_u32(crc, word);
+        p += 4;
+        size -= 4;
+    }
+    while (size-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+typedef uint32_t (*ExtendFunction)(uint32_t, const unsigned char *, size_t);
+
+/**
+ * @brief Picks the hardware implementation when the CPU supports it.
+ *
+ * @return The implementation to use.
+ */
+static ExtendFunction chooseImplementation() {
+#ifdef FOREST_CRC32C_SSE42
+    if (__builtin_cpu_supports("sse4.2")) {
+        return extendHardware;
+    }
+#endif
+    return extendTable;
+}
+
+/**
+ * @brief The implementation chosen for this CPU.
+ */
+static ExtendFunction implementation() {
+    static const ExtendFunction chosen = chooseImplementation();
+    return chosen;
+}
+
+/**
+ * @brief Extends a checksum with more bytes.
+ *
+ * @param crc The checksum of the bytes so far (0 to start).
+ * @param data The bytes
+ * @param size The number of bytes
+ * @return The checksum of the bytes so far followed by `data`
+ */
+uint32_t Crc32c::extend(uint32_t crc, const void *data, size_t size) {
+    return ~implementation()(~crc, static_cast<const unsigned char *>(data), size);
+}
+
+/**
+ * @brief Reports whether the SSE4.2 instruction is in use.
+ *
+ * @return True if checksums are computed in hardware.
+ */
+bool Crc32c::hardwareAccelerated() {
+#ifdef FOREST_CRC32C_SSE42
+    return implementation() == extendHardware;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,49 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_CRC32C_H
+#define ADS_MIDTERM_PROJECT_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @class Crc32c
+ * @brief CRC-32C (Castagnoli), the checksum behind every persisted record and file section.
+ *
+ * On x86 CPUs with SSE4.2 the `crc32` instruction processes eight bytes per step; elsewhere a slice-by-8 table does
+ * the same work in software. The implementation is chosen once at startup and both produce identical values.
+ */
+class Crc32c {
+public:
+    /**
+     * @brief Extends a checksum with more bytes.
+     *
+     * @param crc The checksum of the bytes so far (0 to start).
+     * @param data The bytes
+     * @param size The number of bytes
+     * @return The checksum of the bytes so far followed by `data`
+     */
+    static uint32_t extend(uint32_t crc, const void *data, size_t size);
+
+    /**
+     * @brief Computes the checksum of a byte string.
+     *
+     * @param data The bytes
+     * @return The checksum
+     */
+    static uint32_t compute(string_view data) { return extend(0, data.data(), data.size()); }
+
+    /**
+     * @brief Reports whether the SSE4.2 instruction is in use.
+     *
+     * @return True if checksums are computed in hardware.
+     */
+    static bool hardwareAccelerated();
+};
+
+#endif //ADS_MIDTERM_PROJECT_CRC32C_H
@@ -0,0 +1,179 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file ForestIterators.cpp
+ * @brief Implements the pre-order, post-order and level-order forest iterators.
+ */
+
+#include "ForestIterators.h"
+
+using namespace std;
+
+/**
+ * @brief Creates the end iterator.
+ */
+PreOrderIterator::PreOrderIterator() : ForestIterator(nullptr, nullptr) {}
+
+/**
+ * @brief Creates an iterator positioned on its start node.
+ *
+ * @param start The first node to visit, or nullptr for an empty walk
+ * @param withSiblings Whether to go on to the start node's right siblings after its subtree
+ */
+PreOrderIterator::PreOrderIterator(NodePtr start, bool withSiblings)
+        : ForestIterator(start, withSiblings ? nullptr : start) {}
+
+/**
+ * @brief Moves to the next node in pre-order.
+ *
+ * @return This iterator
+ */
+PreOrderIterator &PreOrderIterator::operator++() {
+    if (current->getLeftChild()) {
+        ancestors.push_back(current);
+        current = current->getLeftChild();
+        return *this;
+    }
+
+    // The subtree of the current node is done: take the first sibling found on the way back up
+    while (current != top) {
+        if (current->getRightSibling()) {
+            current = current->getRightSibling();
+            return *this;
+        }
+        if (ancestors.empty()) {
+            break;
+        }
+        current = ancestors.back();
+        ancestors.pop_back();
+    }
+    current = nullptr;
+    return *this;
+}
+
+/**
+ * @brief Moves to the next node in pre-order.
+ *
+ * @return A copy of the iterator before it moved
+ */
+PreOrderIterator PreOrderIterator::operator++(int) {
+    PreOrderIterator before = *this;
+    ++*this;
+    return before;
+}
+
+/**
+ * @brief Creates the end iterator.
+ */
+PostOrderIterator::PostOrderIterator() : ForestIterator(nullptr, nullptr) {}
+
+/**
+ * @brief Creates an iterator positioned on the first node in post-order: the start node's deepest first child.
+ *
+ * @param start The node the walk starts from, or nullptr for an empty walk
+ * @param withSiblings Whether to go on to the start node's right siblings after its subtree
+ */
+PostOrderIterator::PostOrderIterator(NodePtr start, bool withSiblings)
+        : ForestIterator(start, withSiblings ? nullptr : start) {
+    if (current) {
+        descend();
+    }
+}
+
+/**
+ * @brief Follows first children down from the current node, remembering each node passed.
+ */
+void PostOrderIterator::descend() {
+    while (current->getLeftChild()) {
+        ancestors.push_back(current);
+        current = current->getLeftChild();
+    }
+}
+
+/**
+ * @brief Moves to the next node in post-order.
+ *
+ * @return This iterator
+ */
+PostOrderIterator &PostOrderIterator::operator++() {
+    if (current == top) {
+        current = nullptr;
+        return *this;
+    }
+
+    // Only the current node's sibling link is read, so the caller may free the node once this returns
+    NodePtr sibling = current->getRightSibling();
+    if (sibling) {
+        current = sibling;
+        descend();
+    } else if (ancestors.empty()) {
+        current = nullptr;
+    } else {
+        // Every child of the parent is done
+        current = ancestors.back();
+        ancestors.pop_back();
+    }
+    return *this;
+}
+
+/**
+ * @brief Moves to the next node in post-order.
+ *
+ * @return A copy of the iterator before it moved
+ */
+PostOrderIterator PostOrderIterator::operator++(int) {
+    PostOrderIterator before = *this;
+    ++*this;
+    return before;
+}
+
+/**
+ * @brief Creates the end iterator.
+ */
+LevelOrderIterator::LevelOrderIterator() : ForestIterator(nullptr, nullptr), next(0) {}
+
+/**
+ * @brief Creates an iterator positioned on its start node.
+ *
+ * @param start The first node to visit, or nullptr for an empty walk
+ * @param withSiblings Whether the start node's right siblings form the first level with it
+ */
+LevelOrderIterator::LevelOrderIterator(NodePtr start, bool withSiblings)
+        : ForestIterator(start, withSiblings ? nullptr : start), next(0) {}
+
+/**
+ * @brief Moves to the next node in level order.
+ *
+ * @return This iterator
+ */
+LevelOrderIterator &LevelOrderIterator::operator++() {
+    // Parents are passed in level order, so their first children queue up in level order too
+    if (current->getLeftChild()) {
+        pending.push_back(current->getLeftChild());
+    }
+
+    NodePtr following = current == top ? nullptr : current->getRightSibling();
+    if (!following && next < pending.size()) {
+        following = pending[next++];
+        // Drop the visited half of the queue once it outweighs the rest, so it stays as long as the levels ahead
+        if (next * 2 >= pending.size()) {
+            pending.erase(pending.begin(), pending.begin() + next);
+            next = 0;
+        }
+    }
+    current = following;
+    return *this;
+}
+
+/**
+ * @brief Moves to the next node in level order.
+ *
+ * @return A copy of the iterator before it moved
+ */
+LevelOrderIterator LevelOrderIterator::operator++(int) {
+    LevelOrderIterator before = *this;
+    ++*this;
+    return before;
+}
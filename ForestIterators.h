@@ -0,0 +1,281 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTITERATORS_H
+#define ADS_MIDTERM_PROJECT_FORESTITERATORS_H
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "TreeNode.h"
+
+using namespace std;
+
+/**
+ * @class ForestIterator
+ * @brief The parts shared by every forest traversal: the node being visited and the standard iterator interface.
+ *
+ * The traversals below walk the left-child/right-sibling links with a small explicit stack or queue instead of
+ * recursing, so a chart with a hundred thousand siblings under one parent costs no more call stack than a chart with
+ * ten. An iterator either stays inside the subtree of its start node (`withSiblings` false) or also visits the start
+ * node's right siblings and their subtrees, as `TreeNode::findNode` always has.
+ *
+ * They are forward iterators, so they work with range-for and the non-mutating `<algorithm>` functions. The end
+ * iterator is the one with no current node. Advancing past a node only reads its links, so a post-order walk may
+ * delete each node once it has moved on from it.
+ */
+class ForestIterator {
+public:
+    typedef forward_iterator_tag iterator_category; ///< Multi-pass, forward only
+    typedef TreeNode value_type;                    ///< Iterators visit nodes
+    typedef ptrdiff_t difference_type;              ///< Required by `iterator_traits`
+    typedef TreeNode *pointer;                      ///< A visited node
+    typedef TreeNode &reference;                    ///< A visited node
+
+    /**
+     * @brief Returns the node being visited.
+     *
+     * @return A reference to the node
+     */
+    TreeNode &operator*() const { return *current; }
+
+    /**
+     * @brief Gives member access to the node being visited.
+     *
+     * @return A pointer to the node
+     */
+    TreeNode *operator->() const { return current; }
+
+    /**
+     * @brief Checks whether two iterators visit the same node. Every end iterator compares equal.
+     *
+     * @param other The iterator to compare with
+     * @return True if both visit the same node, or both are past the end
+     */
+    bool operator==(const ForestIterator &other) const { return current == other.current; }
+
+    /**
+     * @brief Checks whether two iterators visit different nodes.
+     *
+     * @param other The iterator to compare with
+     * @return True if the iterators differ
+     */
+    bool operator!=(const ForestIterator &other) const { return current != other.current; }
+
+protected:
+    /**
+     * @brief Creates an iterator positioned on a node.
+     *
+     * @param node The node, or nullptr for the end iterator
+     * @param top The node whose siblings are not followed, or nullptr to follow the start node's siblings
+     */
+    ForestIterator(NodePtr node, NodePtr top) : current(node), top(top) {}
+
+    NodePtr current; ///< The node being visited, nullptr past the end
+    NodePtr top;     ///< The start node when the walk stays inside its subtree, otherwise nullptr
+};
+
+/**
+ * @class PreOrderIterator
+ * @brief Visits each node before its children, and the children in sibling order: the order of the chart file.
+ *
+ * The only state besides the current node is the path of ancestors back to the start, so memory grows with the depth
+ * of the chart and never with the number of siblings.
+ */
+class PreOrderIterator : public ForestIterator {
+public:
+    /**
+     * @brief Creates the end iterator.
+     */
+    PreOrderIterator();
+
+    /**
+     * @brief Creates an iterator positioned on its start node.
+     *
+     * @param start The first node to visit, or nullptr for an empty walk
+     * @param withSiblings Whether to go on to the start node's right siblings after its subtree
+     */
+    PreOrderIterator(NodePtr start, bool withSiblings);
+
+    /**
+     * @brief Moves to the next node in pre-order.
+     *
+     * @return This iterator
+     */
+    PreOrderIterator &operator++();
+
+    /**
+     * @brief Moves to the next node in pre-order.
+     *
+     * @return A copy of the iterator before it moved
+     */
+    PreOrderIterator operator++(int);
+
+    /**
+     * @brief Returns how far below the start node's level the current node is.
+     *
+     * @return 0 for the start node and its siblings, 1 for their children, and so on
+     */
+    int depth() const { return static_cast<int>(ancestors.size()); }
+
+private:
+    vector<NodePtr> ancestors; ///< The ancestors of the current node inside the walk, outermost first
+};
+
+/**
+ * @class PostOrderIterator
+ * @brief Visits the children of each node, in sibling order, before the node itself.
+ *
+ * Like `PreOrderIterator`, it keeps only the path of ancestors. Because a node's children are all visited before the
+ * node, and the iterator never looks at a node again once it has moved past it, this is the order for freeing a tree.
+ */
+class PostOrderIterator : public ForestIterator {
+public:
+    /**
+     * @brief Creates the end iterator.
+     */
+    PostOrderIterator();
+
+    /**
+     * @brief Creates an iterator positioned on the first node in post-order: the start node's deepest first child.
+     *
+     * @param start The node the walk starts from, or nullptr for an empty walk
+     * @param withSiblings Whether to go on to the start node's right siblings after its subtree
+     */
+    PostOrderIterator(NodePtr start, bool withSiblings);
+
+    /**
+     * @brief Moves to the next node in post-order.
+     *
+     * @return This iterator
+     */
+    PostOrderIterator &operator++();
+
+    /**
+     * @brief Moves to the next node in post-order.
+     *
+     * @return A copy of the iterator before it moved
+     */
+    PostOrderIterator operator++(int);
+
+private:
+    /**
+     * @brief Follows first children down from the current node, remembering each node passed.
+     */
+    void descend();
+
+    vector<NodePtr> ancestors; ///< The ancestors of the current node inside the walk, outermost first
+};
+
+/**
+ * @class LevelOrderIterator
+ * @brief Visits the nodes level by level (breadth-first), each level in sibling order.
+ *
+ * Instead of queueing every node, it queues only the first child of each node it passes that has children, and walks
+ * the sibling links from there, so the queue holds one entry per parent of the levels ahead.
+ */
+class LevelOrderIterator : public ForestIterator {
+public:
+    /**
+     * @brief Creates the end iterator.
+     */
+    LevelOrderIterator();
+
+    /**
+     * @brief Creates an iterator positioned on its start node.
+     *
+     * @param start The first node to visit, or nullptr for an empty walk
+     * @param withSiblings Whether the start node's right siblings form the first level with it
+     */
+    LevelOrderIterator(NodePtr start, bool withSiblings);
+
+    /**
+     * @brief Moves to the next node in level order.
+     *
+     * @return This iterator
+     */
+    LevelOrderIterator &operator++();
+
+    /**
+     * @brief Moves to the next node in level order.
+     *
+     * @return A copy of the iterator before it moved
+     */
+    LevelOrderIterator operator++(int);
+
+private:
+    vector<NodePtr> pending; ///< First children still to visit; entries before `next` are done
+    size_t next;             ///< The next entry of `pending` to visit
+};
+
+/**
+ * @class ForestRange
+ * @brief A traversal as a range, for range-for and for the `<algorithm>` functions that take two iterators.
+ *
+ * @tparam Iterator One of the forest iterators
+ */
+template<typename Iterator>
+class ForestRange {
+public:
+    /**
+     * @brief Creates the range of a traversal.
+     *
+     * @param start The node the walk starts from, or nullptr for an empty range
+     * @param withSiblings Whether the walk also covers the start node's right siblings
+     */
+    ForestRange(NodePtr start, bool withSiblings) : start(start), withSiblings(withSiblings) {}
+
+    /**
+     * @brief Returns an iterator on the first node of the traversal.
+     *
+     * @return The first iterator
+     */
+    Iterator begin() const { return Iterator(start, withSiblings); }
+
+    /**
+     * @brief Returns the end iterator.
+     *
+     * @return The end iterator
+     */
+    Iterator end() const { return Iterator(); }
+
+private:
+    NodePtr start;     ///< The node the walk starts from
+    bool withSiblings; ///< Whether the start node's right siblings are covered too
+};
+
+/**
+ * @brief Returns the nodes of a subtree (or of a sibling chain, with `withSiblings`) in pre-order.
+ *
+ * @param start The node the walk starts from
+ * @param withSiblings Whether to also cover the start node's right siblings and their subtrees
+ * @return The range
+ */
+inline ForestRange<PreOrderIterator> preOrder(NodePtr start, bool withSiblings = false) {
+    return ForestRange<PreOrderIterator>(start, withSiblings);
+}
+
+/**
+ * @brief Returns the nodes of a subtree (or of a sibling chain, with `withSiblings`) in post-order.
+ *
+ * @param start The node the walk starts from
+ * @param withSiblings Whether to also cover the start node's right siblings and their subtrees
+ * @return The range
+ */
+inline ForestRange<PostOrderIterator> postOrder(NodePtr start, bool withSiblings = false) {
+    return ForestRange<PostOrderIterator>(start, withSiblings);
+}
+
+/**
+ * @brief Returns the nodes of a subtree (or of a sibling chain, with `withSiblings`) level by level.
+ *
+ * @param start The node the walk starts from
+ * @param withSiblings Whether to also cover the start node's right siblings and their subtrees
+ * @return The range
+ */
+inline ForestRange<LevelOrderIterator> levelOrder(NodePtr start, bool withSiblings = false) {
+    return ForestRange<LevelOrderIterator>(start, withSiblings);
+}
+
+#endif //ADS_MIDTERM_PROJECT_FORESTITERATORS_H
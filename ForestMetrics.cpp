@@ -0,0 +1,310 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file ForestMetrics.cpp
+ * @brief Implements the latency histograms, counters and Prometheus export of `ForestMetrics`.
+ */
+
+#include "ForestMetrics.h"
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Creates an empty histogram.
+ */
+LatencyHistogram::LatencyHistogram() : count(0), sum(0) {
+    for (atomic<uint64_t> &bucket: buckets) {
+        bucket.store(0, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Records one sample.
+ *
+ * @param nanos The latency in nanoseconds.
+ */
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets[bucketIndex(nanos)].fetch_add(1, memory_order_relaxed);
+    count.fetch_add(1, memory_order_relaxed);
+    sum.fetch_add(nanos, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the number of recorded samples.
+ *
+ * @return The sample count.
+ */
+uint64_t LatencyHistogram::getCount() const {
+    return count.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the sum of all recorded samples.
+ *
+ * @return The sum in nanoseconds.
+ */
+uint64_t LatencyHistogram::getSum() const {
+    return sum.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Returns an upper bound of the given percentile.
+ *
+ * @param percentile The percentile, between 0 and 100.
+ * @return The upper edge of the bucket holding that percentile, in nanoseconds.
+ */
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    uint64_t total = 0;
+    for (const atomic<uint64_t> &bucket: buckets) {
+        total += bucket.load(memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * total + 0.5);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i].load(memory_order_relaxed);
+        if (seen >= target) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(BUCKET_COUNT - 1);
+}
+
+/**
+ * @brief Returns the number of samples in one bucket.
+ *
+ * @param index The bucket index.
+ * @return The sample count.
+ */
+uint64_t LatencyHistogram::getBucketCount(int index) const {
+    return buckets[index].load(memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the largest value that falls into a bucket.
+ *
+ * @param index The bucket index.
+ * @return The inclusive upper edge of the bucket, in nanoseconds.
+ */
+uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    int group = index >> SUB_BUCKET_BITS;
+    uint64_t sub = index & (SUB_BUCKETS - 1);
+    if (group == 0) {
+        return sub;
+    }
+    int shift = group - 1;
+    uint64_t lower = (SUB_BUCKETS + sub) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+/**
+ * @brief Returns the bucket a value falls into.
+ *
+ * Values below 16 get a bucket each; above that, the four bits after the most significant one select the
+ * sub-bucket within the value's power of two.
+ *
+ * @param nanos The value.
+ * @return The bucket index.
+ */
+int LatencyHistogram::bucketIndex(uint64_t nanos) {
+    if (nanos < static_cast<uint64_t>(SUB_BUCKETS)) {
+        return static_cast<int>(nanos);
+    }
+    int msb = 63;
+    while (!(nanos >> msb)) {
+        --msb;
+    }
+    int shift = msb - SUB_BUCKET_BITS;
+    int sub = static_cast<int>((nanos >> shift) - SUB_BUCKETS);
+    return ((shift + 1) << SUB_BUCKET_BITS) + sub;
+}
+
+/**
+ * @brief Clears every bucket.
+ */
+void LatencyHistogram::reset() {
+    for (atomic<uint64_t> &bucket: buckets) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    count.store(0, memory_order_relaxed);
+    sum.store(0, memory_order_relaxed);
+}
+
+ForestMetrics::ForestMetrics() {
+    for (atomic<uint64_t> &counter: counters) {
+        counter.store(0, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Returns the process-wide registry.
+ *
+ * @return The registry.
+ */
+ForestMetrics &ForestMetrics::global() {
+    static ForestMetrics instance;
+    return instance;
+}
+
+/**
+ * @brief Records the latency of one operation.
+ *
+ * @param op The operation.
+ * @param nanos The latency in nanoseconds.
+ */
+void ForestMetrics::recordLatency(MetricOp op, uint64_t nanos) {
+    histograms[static_cast<int>(op)].record(nanos);
+}
+
+/**
+ * @brief Adds to a counter.
+ *
+ * @param counter The counter.
+ * @param amount The amount to add.
+ */
+void ForestMetrics::add(MetricCounter counter, uint64_t amount) {
+    counters[static_cast<int>(counter)].fetch_add(amount, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the current value of a counter.
+ *
+ * @param counter The counter.
+ * @return The value.
+ */
+uint64_t ForestMetrics::getCounter(MetricCounter counter) const {
+    return counters[static_cast<int>(counter)].load(memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the latency histogram of an operation.
+ *
+ * @param op The operation.
+ * @return The histogram.
+ */
+const LatencyHistogram &ForestMetrics::getHistogram(MetricOp op) const {
+    return histograms[static_cast<int>(op)];
+}
+
+/**
+ * @brief Clears every counter and histogram.
+ */
+void ForestMetrics::reset() {
+    for (LatencyHistogram &histogram: histograms) {
+        histogram.reset();
+    }
+    for (atomic<uint64_t> &counter: counters) {
+        counter.store(0, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Writes every metric in the Prometheus text exposition format.
+ *
+ * Counters become `forest_<name>_total`. Each operation becomes a `forest_op_duration_seconds` histogram labelled
+ * with the operation name, with one cumulative bucket per power of two of nanoseconds.
+ *
+ * @param filename The file to write.
+ * @throws runtime_error If the file cannot be opened.
+ */
+void ForestMetrics::writePrometheus(const string &filename) const {
+    ofstream file(filename);
+    if (!file) {
+        throw runtime_error("Unable to open metrics file for writing: " + filename);
+    }
+
+    for (int c = 0; c < static_cast<int>(MetricCounter::Count); ++c) {
+        const char *name = counterName(static_cast<MetricCounter>(c));
+        file << "# TYPE forest_" << name << "_total counter\n"
+             << "forest_" << name << "_total " << counters[c].load(memory_order_relaxed) << "\n";
+    }
+
+    file << "# TYPE forest_op_duration_seconds histogram\n";
+    for (int o = 0; o < static_cast<int>(MetricOp::Count); ++o) {
+        const LatencyHistogram &histogram = histograms[o];
+        const char *name = opName(static_cast<MetricOp>(o));
+
+        // Find the last power-of-two group that holds samples
+        int lastGroup = 0;
+        for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+            if (histogram.getBucketCount(i) != 0) {
+                lastGroup = i >> LatencyHistogram::SUB_BUCKET_BITS;
+            }
+        }
+
+        uint64_t cumulative = 0;
+        for (int group = 0; group <= lastGroup; ++group) {
+            for (int sub = 0; sub < LatencyHistogram::SUB_BUCKETS; ++sub) {
+                cumulative += histogram.getBucketCount((group << LatencyHistogram::SUB_BUCKET_BITS) + sub);
+            }
+            uint64_t upper = LatencyHistogram::bucketUpperBound(
+                    (group << LatencyHistogram::SUB_BUCKET_BITS) + LatencyHistogram::SUB_BUCKETS - 1);
+            file << "forest_op_duration_seconds_bucket{op=\"" << name << "\",le=\"" << (upper + 1) / 1e9 << "\"} "
+                 << cumulative << "\n";
+        }
+        file << "forest_op_duration_seconds_bucket{op=\"" << name << "\",le=\"+Inf\"} " << histogram.getCount()
+             << "\n"
+             << "forest_op_duration_seconds_sum{op=\"" << name << "\"} " << histogram.getSum() / 1e9 << "\n"
+             << "forest_op_duration_seconds_count{op=\"" << name << "\"} " << histogram.getCount() << "\n";
+    }
+}
+
+/**
+ * @brief Returns the metric name of an operation.
+ *
+ * @param op The operation.
+ * @return The name.
+ */
+const char *ForestMetrics::opName(MetricOp op) {
+    switch (op) {
+        case MetricOp::BuildFromFile: return "build_from_file";
+        case MetricOp::LoadTransactions: return "load_transactions";
+        case MetricOp::AddAccount: return "add_account";
+        case MetricOp::AddAccountWithFile: return "add_account_with_file";
+        case MetricOp::AddTransaction: return "add_transaction";
+        case MetricOp::DeleteTransaction: return "delete_transaction";
+        case MetricOp::FindAccount: return "find_account";
+        case MetricOp::PrintDetailedReport: return "print_detailed_report";
+        case MetricOp::PrintForestTree: return "print_forest_tree";
+        case MetricOp::SaveToFile: return "save_to_file";
+        case MetricOp::SaveTransactions: return "save_transactions";
+        case MetricOp::PeriodTotals: return "period_totals";
+        case MetricOp::Query: return "query";
+        case MetricOp::TopTransactions: return "top_transactions";
+        case MetricOp::TopAccounts: return "top_accounts";
+        case MetricOp::PostTransactions: return "post_transactions";
+        case MetricOp::DeleteTransactions: return "delete_transactions";
+        case MetricOp::AddAccounts: return "add_accounts";
+        case MetricOp::Commit: return "commit";
+        case MetricOp::Audit: return "audit";
+        case MetricOp::RebuildBalances: return "rebuild_balances";
+        case MetricOp::Diff: return "diff";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Returns the metric name of a counter.
+ *
+ * @param counter The counter.
+ * @return The name.
+ */
+const char *ForestMetrics::counterName(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::NodesVisited: return "nodes_visited";
+        case MetricCounter::RollupSteps: return "rollup_steps";
+        case MetricCounter::Rollups: return "rollups";
+        case MetricCounter::BytesWritten: return "bytes_written";
+        case MetricCounter::AccountsSerialized: return "accounts_serialized";
+        case MetricCounter::DuplicateTransactions: return "duplicate_transactions";
+        default: return "unknown";
+    }
+}
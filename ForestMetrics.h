@@ -0,0 +1,273 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTMETRICS_H
+#define ADS_MIDTERM_PROJECT_FORESTMETRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @brief The `ForestTree` operations whose latency is recorded.
+ */
+enum class MetricOp {
+    BuildFromFile,
+    LoadTransactions,
+    AddAccount,
+    AddAccountWithFile,
+    AddTransaction,
+    DeleteTransaction,
+    FindAccount,
+    PrintDetailedReport,
+    PrintForestTree,
+    SaveToFile,
+    SaveTransactions,
+    PeriodTotals,
+    Query,
+    TopTransactions,
+    TopAccounts,
+    PostTransactions,
+    DeleteTransactions,
+    AddAccounts,
+    Commit,
+    Audit,
+    RebuildBalances,
+    Diff,
+    Count  ///< Number of operations, not an operation
+};
+
+/**
+ * @brief The event counters maintained alongside the latency histograms.
+ */
+enum class MetricCounter {
+    NodesVisited,    ///< Tree nodes examined by `TreeNode::findNode`
+    RollupSteps,     ///< Ancestor updates made while propagating a posting
+    Rollups,         ///< Postings or deletions propagated to ancestors
+    BytesWritten,    ///< Bytes written to the accounts and transaction files
+    AccountsSerialized, ///< Dirty accounts whose transactions were re-serialized for a rewrite
+    DuplicateTransactions, ///< Postings and loaded transactions dropped because their ID was already present
+    Count            ///< Number of counters, not a counter
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief A lock-free, HDR-style latency histogram.
+ *
+ * Values (in nanoseconds) are bucketed log-linearly: each power of two is split into 16 equal sub-buckets, which
+ * bounds the relative error of any reported percentile to about 6% over the full 64-bit range. Recording is a
+ * single relaxed atomic increment, so histograms can be shared between threads.
+ */
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 4;                           ///< log2 of sub-buckets per power of two
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;            ///< Sub-buckets per power of two
+    static const int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS; ///< Total number of buckets
+
+private:
+    atomic<uint64_t> buckets[BUCKET_COUNT]; ///< Sample count per bucket
+    atomic<uint64_t> count;                 ///< Total number of samples
+    atomic<uint64_t> sum;                   ///< Sum of all samples
+
+public:
+    /**
+     * @brief Creates an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Records one sample.
+     *
+     * @param nanos The latency in nanoseconds
+     */
+    void record(uint64_t nanos);
+
+    /**
+     * @brief Returns the number of recorded samples.
+     *
+     * @return The sample count
+     */
+    uint64_t getCount() const;
+
+    /**
+     * @brief Returns the sum of all recorded samples.
+     *
+     * @return The sum in nanoseconds
+     */
+    uint64_t getSum() const;
+
+    /**
+     * @brief Returns an upper bound of the given percentile.
+     *
+     * @param percentile The percentile, between 0 and 100
+     * @return The upper edge of the bucket holding that percentile, in nanoseconds (0 if empty)
+     */
+    uint64_t getPercentile(double percentile) const;
+
+    /**
+     * @brief Returns the number of samples in one bucket.
+     *
+     * @param index The bucket index
+     * @return The sample count
+     */
+    uint64_t getBucketCount(int index) const;
+
+    /**
+     * @brief Returns the largest value that falls into a bucket.
+     *
+     * @param index The bucket index
+     * @return The inclusive upper edge of the bucket, in nanoseconds
+     */
+    static uint64_t bucketUpperBound(int index);
+
+    /**
+     * @brief Returns the bucket a value falls into.
+     *
+     * @param nanos The value
+     * @return The bucket index
+     */
+    static int bucketIndex(uint64_t nanos);
+
+    /**
+     * @brief Clears every bucket.
+     */
+    void reset();
+};
+
+/**
+ * @class ForestMetrics
+ * @brief Process-wide counters and latency histograms for the chart of accounts.
+ *
+ * Recording goes through the `FOREST_METRIC_*` macros, which expand to nothing unless the build defines
+ * `FOREST_ENABLE_METRICS`. The registry itself always exists, so code reading metrics compiles either way and simply
+ * sees zeros when metrics are disabled.
+ */
+class ForestMetrics {
+private:
+    LatencyHistogram histograms[static_cast<int>(MetricOp::Count)];     ///< One histogram per operation
+    atomic<uint64_t> counters[static_cast<int>(MetricCounter::Count)];  ///< One value per counter
+
+    ForestMetrics();
+
+public:
+    ForestMetrics(const ForestMetrics &) = delete;
+    ForestMetrics &operator=(const ForestMetrics &) = delete;
+
+    /**
+     * @brief Returns the process-wide registry.
+     *
+     * @return The registry
+     */
+    static ForestMetrics &global();
+
+    /**
+     * @brief Records the latency of one operation.
+     *
+     * @param op The operation
+     * @param nanos The latency in nanoseconds
+     */
+    void recordLatency(MetricOp op, uint64_t nanos);
+
+    /**
+     * @brief Adds to a counter.
+     *
+     * @param counter The counter
+     * @param amount The amount to add
+     */
+    void add(MetricCounter counter, uint64_t amount);
+
+    /**
+     * @brief Returns the current value of a counter.
+     *
+     * @param counter The counter
+     * @return The value
+     */
+    uint64_t getCounter(MetricCounter counter) const;
+
+    /**
+     * @brief Returns the latency histogram of an operation.
+     *
+     * @param op The operation
+     * @return The histogram
+     */
+    const LatencyHistogram &getHistogram(MetricOp op) const;
+
+    /**
+     * @brief Clears every counter and histogram.
+     */
+    void reset();
+
+    /**
+     * @brief Writes every metric in the Prometheus text exposition format.
+     *
+     * @param filename The file to write
+     * @throws runtime_error If the file cannot be opened
+     */
+    void writePrometheus(const string &filename) const;
+
+    /**
+     * @brief Returns the metric name of an operation, e.g. "add_transaction".
+     *
+     * @param op The operation
+     * @return The name
+     */
+    static const char *opName(MetricOp op);
+
+    /**
+     * @brief Returns the metric name of a counter, e.g. "nodes_visited".
+     *
+     * @param counter The counter
+     * @return The name
+     */
+    static const char *counterName(MetricCounter counter);
+};
+
+/**
+ * @class MetricTimer
+ * @brief Records the time between its construction and destruction into an operation's histogram.
+ */
+class MetricTimer {
+private:
+    MetricOp op;                                 ///< The operation being timed
+    chrono::steady_clock::time_point start;      ///< When the operation started
+
+public:
+    /**
+     * @brief Starts timing an operation.
+     *
+     * @param op The operation
+     */
+    explicit MetricTimer(MetricOp op) : op(op), start(chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Stops timing and records the latency.
+     */
+    ~MetricTimer() {
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start);
+        ForestMetrics::global().recordLatency(op, static_cast<uint64_t>(elapsed.count()));
+    }
+
+    MetricTimer(const MetricTimer &) = delete;
+    MetricTimer &operator=(const MetricTimer &) = delete;
+};
+
+#define FOREST_METRIC_CONCAT_INNER(a, b) a##b
+#define FOREST_METRIC_CONCAT(a, b) FOREST_METRIC_CONCAT_INNER(a, b)
+
+#ifdef FOREST_ENABLE_METRICS
+/// Times the rest of the enclosing scope as one `op`.
+#define FOREST_METRIC_TIMER(op) MetricTimer FOREST_METRIC_CONCAT(forestMetricTimer, __LINE__)(op)
+/// Adds `amount` to `counter`.
+#define FOREST_METRIC_ADD(counter, amount) ForestMetrics::global().add((counter), (amount))
+#else
+#define FOREST_METRIC_TIMER(op) ((void) 0)
+// The amount is still evaluated: callers pass expressions with side effects, such as `writer.commit()`
+#define FOREST_METRIC_ADD(counter, amount) ((void) (amount))
+#endif
+
+#endif //ADS_MIDTERM_PROJECT_FORESTMETRICS_H
@@ -0,0 +1,206 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file ForestProtocol.cpp
+ * @brief Implements the frame encoder and decoder of the `ForestServer` protocol.
+ */
+
+#include "ForestProtocol.h"
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Appends an unsigned byte.
+ *
+ * @param value The byte
+ */
+void FrameWriter::putU8(uint8_t value) {
+    payload.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Appends a little-endian u32.
+ *
+ * @param value The value
+ */
+void FrameWriter::putU32(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        payload.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * @brief Appends a little-endian two's complement i32.
+ *
+ * @param value The value
+ */
+void FrameWriter::putI32(int32_t value) {
+    putU32(static_cast<uint32_t>(value));
+}
+
+/**
+ * @brief Appends a double as its IEEE-754 bit pattern, little-endian.
+ *
+ * @param value The value
+ */
+void FrameWriter::putDouble(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putU32(static_cast<uint32_t>(bits));
+    putU32(static_cast<uint32_t>(bits >> 32));
+}
+
+/**
+ * @brief Appends a u32 length followed by the string bytes.
+ *
+ * @param value The string
+ */
+void FrameWriter::putString(string_view value) {
+    putU32(static_cast<uint32_t>(value.size()));
+    payload += value;
+}
+
+/**
+ * @brief Returns the encoded payload.
+ *
+ * @return The payload bytes
+ */
+const string &FrameWriter::data() const {
+    return payload;
+}
+
+/**
+ * @brief Wraps a payload in a complete frame.
+ *
+ * @param requestId The request ID
+ * @param code The request op or response status
+ * @param payload The payload bytes
+ * @return The frame, ready to send
+ */
+string FrameWriter::frame(uint32_t requestId, uint8_t code, const string &payload) {
+    FrameWriter header;
+    header.putU32(static_cast<uint32_t>(FRAME_HEADER_SIZE + payload.size()));
+    header.putU32(requestId);
+    header.putU8(code);
+    return header.payload + payload;
+}
+
+/**
+ * @brief Creates a reader over a payload. The bytes must outlive the reader.
+ *
+ * @param data The payload bytes
+ * @param size The payload length
+ */
+FrameReader::FrameReader(const char *data, size_t size) : data(data), size(size), offset(0), ok(true) {}
+
+/**
+ * @brief Reserves the next bytes of the payload.
+ *
+ * @param count The number of bytes wanted
+ * @return A pointer to them, or nullptr if the payload is too short
+ */
+const char *FrameReader::take(size_t count) {
+    if (!ok || size - offset < count) {
+        ok = false;
+        return nullptr;
+    }
+    const char *bytes = data + offset;
+    offset += count;
+    return bytes;
+}
+
+/**
+ * @brief Reads an unsigned byte.
+ *
+ * @param value Receives the byte
+ * @return False if the payload is too short
+ */
+bool FrameReader::getU8(uint8_t &value) {
+    const char *bytes = take(1);
+    if (!bytes) {
+        return false;
+    }
+    value = static_cast<uint8_t>(bytes[0]);
+    return true;
+}
+
+/**
+ * @brief Reads a little-endian u32.
+ *
+ * @param value Receives the value
+ * @return False if the payload is too short
+ */
+bool FrameReader::getU32(uint32_t &value) {
+    const char *bytes = take(4);
+    if (!bytes) {
+        return false;
+    }
+    value = decodeU32(bytes);
+    return true;
+}
+
+/**
+ * @brief Reads a little-endian two's complement i32.
+ *
+ * @param value Receives the value
+ * @return False if the payload is too short
+ */
+bool FrameReader::getI32(int32_t &value) {
+    uint32_t bits;
+    if (!getU32(bits)) {
+        return false;
+    }
+    value = static_cast<int32_t>(bits);
+    return true;
+}
+
+/**
+ * @brief Reads a double sent as a little-endian IEEE-754 bit pattern.
+ *
+ * @param value Receives the value
+ * @return False if the payload is too short
+ */
+bool FrameReader::getDouble(double &value) {
+    uint32_t low, high;
+    if (!getU32(low) || !getU32(high)) {
+        return false;
+    }
+    uint64_t bits = (static_cast<uint64_t>(high) << 32) | low;
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+/**
+ * @brief Reads a length-prefixed string.
+ *
+ * @param value Receives the string
+ * @return False if the payload is too short
+ */
+bool FrameReader::getString(string &value) {
+    uint32_t length;
+    if (!getU32(length)) {
+        return false;
+    }
+    const char *bytes = take(length);
+    if (!bytes) {
+        return false;
+    }
+    value.assign(bytes, length);
+    return true;
+}
+
+/**
+ * @brief Decodes a little-endian u32 from raw bytes, e.g. a frame length prefix.
+ *
+ * @param bytes Four bytes
+ * @return The value
+ */
+uint32_t FrameReader::decodeU32(const char *bytes) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(bytes[0])) |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[2])) << 16 |
+           static_cast<uint32_t>(static_cast<uint8_t>(bytes[3])) << 24;
+}
@@ -0,0 +1,219 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTPROTOCOL_H
+#define ADS_MIDTERM_PROJECT_FORESTPROTOCOL_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @file ForestProtocol.h
+ * @brief The length-prefixed binary protocol spoken by `ForestServer`.
+ *
+ * Every request and response is one frame:
+ *
+ *     u32 length      number of bytes that follow
+ *     u32 requestId   chosen by the client, echoed in the response
+ *     u8  code        a `RequestOp` in requests, a `ResponseStatus` in responses
+ *     ... payload
+ *
+ * Integers are little-endian, doubles are IEEE-754 bit patterns sent as little-endian u64, and strings are a u32
+ * byte count followed by the bytes. Clients may pipeline any number of requests without waiting; responses can
+ * arrive in a different order and are matched to requests by `requestId`. A client that has sent its last request
+ * may shut down its sending side; the server still answers every complete request it received, then closes.
+ *
+ * Payloads:
+ *
+ *     Ping         request: (empty)                        response: (empty)
+ *     FindAccount  request: i32 account                    response: i32 account, f64 balance, str description,
+ *                                                                    u32 transactionCount
+ *     Query        request: i32 account, i32 fromDayKey,   response: u32 matches, u32 returned, then per row:
+ *                           i32 toDayKey, f64 minAmount,             i32 account, str id, f64 amount, u8 type,
+ *                           f64 maxAmount, u8 type (0=both),         str date, str description
+ *                           str text, u32 limit
+ *     Post         request: i32 account, str id, f64 amount, response: (empty)
+ *                           u8 type, str date, str description
+ *
+ * A query stops scanning at the first match past `limit`, so `matches` counts at most `limit + 1` transactions; it
+ * is greater than `returned` exactly when more transactions matched than were sent.
+ */
+
+/**
+ * @brief Request codes.
+ */
+enum class RequestOp : uint8_t {
+    Ping = 0,          ///< Liveness check, answered by the event loop itself
+    FindAccount = 1,   ///< Account lookup, served by the reader pool
+    Query = 2,         ///< Filtered transaction query over a subtree, served by the reader pool
+    Post = 3           ///< Transaction posting, applied by the writer in batches
+};
+
+/**
+ * @brief Response status codes.
+ */
+enum class ResponseStatus : uint8_t {
+    Ok = 0,            ///< The request succeeded; the payload follows
+    NotFound = 1,      ///< The account does not exist
+    BadRequest = 2,    ///< The request could not be decoded or the op is unknown
+    Error = 3,         ///< The request failed on the server
+    Duplicate = 4      ///< A transaction with this ID was already posted; the retry changed nothing
+};
+
+/**
+ * @brief Size of the frame header after the length prefix: request ID and code.
+ */
+const uint32_t FRAME_HEADER_SIZE = 5;
+
+/**
+ * @brief Largest accepted frame; a client announcing more is disconnected.
+ */
+const uint32_t MAX_FRAME_SIZE = 16u << 20;
+
+/**
+ * @class FrameWriter
+ * @brief Builds a frame payload field by field.
+ */
+class FrameWriter {
+private:
+    string payload; ///< The encoded fields so far
+
+public:
+    /**
+     * @brief Appends an unsigned byte.
+     *
+     * @param value The value
+     */
+    void putU8(uint8_t value);
+
+    /**
+     * @brief Appends a little-endian u32.
+     *
+     * @param value The value
+     */
+    void putU32(uint32_t value);
+
+    /**
+     * @brief Appends a little-endian two's complement i32.
+     *
+     * @param value The value
+     */
+    void putI32(int32_t value);
+
+    /**
+     * @brief Appends a double as its IEEE-754 bit pattern, little-endian.
+     *
+     * @param value The value
+     */
+    void putDouble(double value);
+
+    /**
+     * @brief Appends a u32 length followed by the string bytes.
+     *
+     * @param value The value
+     */
+    void putString(string_view value);
+
+    /**
+     * @brief Returns the encoded payload.
+     *
+     * @return The payload bytes
+     */
+    const string &data() const;
+
+    /**
+     * @brief Wraps a payload in a complete frame.
+     *
+     * @param requestId The request ID
+     * @param code The request op or response status
+     * @param payload The payload bytes
+     * @return The frame, ready to send
+     */
+    static string frame(uint32_t requestId, uint8_t code, const string &payload);
+};
+
+/**
+ * @class FrameReader
+ * @brief Decodes the fields of a frame payload, failing softly on truncated input.
+ *
+ * Each getter returns false, and every later getter keeps returning false, once the payload runs out.
+ */
+class FrameReader {
+private:
+    const char *data;   ///< The payload bytes
+    size_t size;        ///< Payload length
+    size_t offset;      ///< Bytes consumed so far
+    bool ok;            ///< False once a read ran past the end
+
+    /**
+     * @brief Reserves the next bytes of the payload.
+     *
+     * @param count The number of bytes wanted
+     * @return A pointer to them, or nullptr if the payload is too short
+     */
+    const char *take(size_t count);
+
+public:
+    /**
+     * @brief Creates a reader over a payload. The bytes must outlive the reader.
+     *
+     * @param data The payload bytes
+     * @param size The payload length
+     */
+    FrameReader(const char *data, size_t size);
+
+    /**
+     * @brief Reads an unsigned byte.
+     *
+     * @param value Receives the value
+     * @return False if the payload is too short
+     */
+    bool getU8(uint8_t &value);
+
+    /**
+     * @brief Reads a little-endian u32.
+     *
+     * @param value Receives the value
+     * @return False if the payload is too short
+     */
+    bool getU32(uint32_t &value);
+
+    /**
+     * @brief Reads a little-endian two's complement i32.
+     *
+     * @param value Receives the value
+     * @return False if the payload is too short
+     */
+    bool getI32(int32_t &value);
+
+    /**
+     * @brief Reads a double sent as a little-endian IEEE-754 bit pattern.
+     *
+     * @param value Receives the value
+     * @return False if the payload is too short
+     */
+    bool getDouble(double &value);
+
+    /**
+     * @brief Reads a length-prefixed string.
+     *
+     * @param value Receives the value
+     * @return False if the payload is too short
+     */
+    bool getString(string &value);
+
+    /**
+     * @brief Decodes a little-endian u32 from raw bytes, e.g. a frame length prefix.
+     *
+     * @param bytes Four bytes
+     * @return The value
+     */
+    static uint32_t decodeU32(const char *bytes);
+};
+
+#endif //ADS_MIDTERM_PROJECT_FORESTPROTOCOL_H
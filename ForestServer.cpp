@@ -0,0 +1,658 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file ForestServer.cpp
+ * @brief Implements `ForestServer`: the epoll event loop, the reader pool and the batching writer.
+ */
+
+#include "ForestServer.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @brief Creates a server for a tree. Nothing is opened until `start()`.
+ *
+ * @param tree The ledger to serve.
+ * @param config Listening address and thread counts.
+ */
+ForestServer::ForestServer(ForestTree &tree, const ServerConfig &config)
+        : tree(tree), config(config), listenFd(-1), epollFd(-1), wakeFd(-1), running(false) {
+    if (this->config.readers == 0) {
+        this->config.readers = 1;
+    }
+    if (this->config.batchSize == 0) {
+        this->config.batchSize = 1;
+    }
+}
+
+/**
+ * @brief Stops the server if it is still running.
+ */
+ForestServer::~ForestServer() {
+    running = false;
+    shutdown();
+}
+
+/**
+ * @brief Opens the listening socket and starts the reader pool and the writer.
+ *
+ * @return True on success; on failure the error is printed and false is returned.
+ */
+bool ForestServer::start() {
+    if (!openListener()) {
+        return false;
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        cerr << "Error: cannot create event loop: " << strerror(errno) << endl;
+        shutdown();
+        return false;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+    running = true;
+    for (size_t i = 0; i < config.readers; ++i) {
+        readerThreads.emplace_back(&ForestServer::readerLoop, this);
+    }
+    writerThread = thread(&ForestServer::writerLoop, this);
+    return true;
+}
+
+/**
+ * @brief Creates and binds the listening socket described by the configuration.
+ *
+ * @return True on success; on failure the error is printed and false is returned.
+ */
+bool ForestServer::openListener() {
+    if (!config.socketPath.empty()) {
+        sockaddr_un address{};
+        if (config.socketPath.size() >= sizeof(address.sun_path)) {
+            cerr << "Error: socket path is too long: " << config.socketPath << endl;
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, config.socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        unlink(config.socketPath.c_str());  // A stale socket from an earlier run would make bind fail
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+            cerr << "Error: cannot bind " << config.socketPath << ": " << strerror(errno) << endl;
+            return false;
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(config.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        int reuse = 1;
+        if (listenFd >= 0) {
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+            cerr << "Error: cannot bind 127.0.0.1:" << config.port << ": " << strerror(errno) << endl;
+            return false;
+        }
+    }
+
+    if (listen(listenFd, SOMAXCONN) < 0) {
+        cerr << "Error: cannot listen: " << strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Asks the event loop to exit. Safe to call from another thread or a signal handler.
+ */
+void ForestServer::stop() {
+    running = false;
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void) ignored;
+    }
+}
+
+/**
+ * @brief Runs the event loop on the calling thread until `stop()` is called, then shuts down.
+ */
+void ForestServer::run() {
+    const int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+
+    while (running) {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cerr << "Error: epoll_wait failed: " << strerror(errno) << endl;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptClients();
+            } else if (fd == wakeFd) {
+                uint64_t ignored;
+                while (read(wakeFd, &ignored, sizeof(ignored)) > 0) {}
+
+                vector<ConnectionPtr> ready;
+                {
+                    lock_guard<mutex> lock(flushMutex);
+                    ready.swap(flushQueue);
+                }
+                for (const ConnectionPtr &connection: ready) {
+                    if (!connection->closed) {
+                        writeTo(connection);
+                    }
+                }
+            } else {
+                auto it = connections.find(fd);
+                if (it == connections.end()) {
+                    continue;
+                }
+                ConnectionPtr connection = it->second;
+                if (connection->inputClosed && (events[i].events & (EPOLLHUP | EPOLLERR))) {
+                    // The client has gone completely, so the responses still owed cannot be delivered
+                    closeConnection(connection);
+                    continue;
+                }
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readFrom(connection);
+                }
+                if (!connection->closed && (events[i].events & EPOLLOUT)) {
+                    writeTo(connection);
+                }
+            }
+        }
+    }
+
+    shutdown();
+}
+
+/**
+ * @brief Accepts every pending client connection.
+ */
+void ForestServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                cerr << "Warning: accept failed: " << strerror(errno) << endl;
+            }
+            return;
+        }
+
+        if (config.socketPath.empty()) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+
+        ConnectionPtr connection = make_shared<Connection>();
+        connection->fd = fd;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+        connections[fd] = connection;
+    }
+}
+
+/**
+ * @brief Reads everything available on a connection and dispatches each complete frame.
+ *
+ * @param connection The connection.
+ *
+ * @details Frames received before the end of the input are still dispatched. After an orderly shutdown the client
+ * may still be reading, so the connection stays open until every response has been sent (see `writeTo`); after a
+ * read error it is closed at once.
+ */
+void ForestServer::readFrom(const ConnectionPtr &connection) {
+    char buffer[64 * 1024];
+    bool ended = false;
+    bool failed = false;
+    while (!connection->inputClosed) {
+        ssize_t received = read(connection->fd, buffer, sizeof(buffer));
+        if (received > 0) {
+            connection->input.append(buffer, static_cast<size_t>(received));
+            continue;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        // Orderly shutdown by the client, or a hard error: nothing more will arrive
+        ended = true;
+        failed = received < 0;
+        break;
+    }
+
+    // Split off every complete frame; a partial frame stays buffered until the rest arrives
+    string &input = connection->input;
+    size_t offset = 0;
+    while (input.size() - offset >= 4) {
+        uint32_t length = FrameReader::decodeU32(input.data() + offset);
+        if (length < FRAME_HEADER_SIZE || length > MAX_FRAME_SIZE) {
+            cerr << "Warning: dropping client that sent a malformed frame" << endl;
+            closeConnection(connection);
+            return;
+        }
+        if (input.size() - offset - 4 < length) {
+            break;
+        }
+
+        const char *frame = input.data() + offset + 4;
+        Request request;
+        request.connection = connection;
+        request.requestId = FrameReader::decodeU32(frame);
+        request.op = static_cast<RequestOp>(static_cast<uint8_t>(frame[4]));
+        request.payload.assign(frame + FRAME_HEADER_SIZE, length - FRAME_HEADER_SIZE);
+        dispatch(move(request));
+
+        offset += 4 + length;
+    }
+    input.erase(0, offset);
+
+    if (failed) {
+        closeConnection(connection);
+    } else if (ended) {
+        // A partial frame left over can never be completed
+        connection->inputClosed = true;
+        input.clear();
+        writeTo(connection);
+    }
+}
+
+/**
+ * @brief Sends as much queued output as the socket accepts, registering for EPOLLOUT if some remains.
+ *
+ * @param connection The connection.
+ *
+ * @details Once the client has stopped sending, the connection is closed as soon as every request it sent has been
+ * answered and the answers are sent.
+ */
+void ForestServer::writeTo(const ConnectionPtr &connection) {
+    bool failed = false;
+    bool pending;
+    bool finished;
+    {
+        lock_guard<mutex> lock(connection->outputMutex);
+        string &output = connection->output;
+        while (connection->outputOffset < output.size()) {
+            ssize_t sent = send(connection->fd, output.data() + connection->outputOffset,
+                                output.size() - connection->outputOffset, MSG_NOSIGNAL);
+            if (sent > 0) {
+                connection->outputOffset += static_cast<size_t>(sent);
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                failed = !(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+                break;
+            }
+        }
+        if (connection->outputOffset == output.size()) {
+            output.clear();
+            connection->outputOffset = 0;
+        }
+        pending = !output.empty();
+        // Checked under the output lock, so a response queued after this point is sure to schedule another call
+        finished = !pending && connection->inputClosed && connection->unanswered == 0;
+    }
+
+    if (failed || finished) {
+        closeConnection(connection);
+        return;
+    }
+
+    // Only ask for EPOLLOUT while the socket buffer is full, otherwise every loop iteration would wake for it. After
+    // the client stops sending, EPOLLIN would report the end of input on every iteration, so it is dropped too.
+    bool wantRead = !connection->inputClosed;
+    if (pending != connection->wantWrite || wantRead != connection->wantRead) {
+        epoll_event event{};
+        event.events = (wantRead ? uint32_t(EPOLLIN) : 0u) | (pending ? uint32_t(EPOLLOUT) : 0u);
+        event.data.fd = connection->fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->wantRead = wantRead;
+        connection->wantWrite = pending;
+    }
+}
+
+/**
+ * @brief Closes a connection and forgets it. Responses still in flight for it are dropped.
+ *
+ * @param connection The connection.
+ */
+void ForestServer::closeConnection(const ConnectionPtr &connection) {
+    if (connection->closed.exchange(true)) {
+        return;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+    close(connection->fd);
+    connections.erase(connection->fd);
+}
+
+/**
+ * @brief Routes a decoded frame to the reader pool, the writer, or answers it directly.
+ *
+ * @param request The request.
+ */
+void ForestServer::dispatch(Request &&request) {
+    // Every request gets exactly one response, which `respond` counts off
+    ++request.connection->unanswered;
+    switch (request.op) {
+        case RequestOp::Ping:
+            respond(request.connection, request.requestId, ResponseStatus::Ok);
+            break;
+        case RequestOp::FindAccount:
+        case RequestOp::Query: {
+            {
+                lock_guard<mutex> lock(readMutex);
+                readQueue.push_back(move(request));
+            }
+            readReady.notify_one();
+            break;
+        }
+        case RequestOp::Post: {
+            {
+                lock_guard<mutex> lock(writeMutex);
+                writeQueue.push_back(move(request));
+            }
+            writeReady.notify_one();
+            break;
+        }
+        default:
+            respond(request.connection, request.requestId, ResponseStatus::BadRequest);
+    }
+}
+
+/**
+ * @brief Queues an encoded response on a connection and wakes the event loop to send it.
+ *
+ * @param connection The connection.
+ * @param requestId The request being answered.
+ * @param status The outcome.
+ * @param payload The response fields.
+ */
+void ForestServer::respond(const ConnectionPtr &connection, uint32_t requestId, ResponseStatus status,
+                           const string &payload) {
+    if (connection->closed) {
+        return;
+    }
+
+    bool wasEmpty;
+    {
+        lock_guard<mutex> lock(connection->outputMutex);
+        wasEmpty = connection->output.size() == connection->outputOffset;
+        connection->output += FrameWriter::frame(requestId, static_cast<uint8_t>(status), payload);
+        --connection->unanswered;
+    }
+
+    // A connection that already had output queued is already scheduled for sending
+    if (wasEmpty) {
+        bool wake;
+        {
+            lock_guard<mutex> lock(flushMutex);
+            wake = flushQueue.empty();
+            flushQueue.push_back(connection);
+        }
+        if (wake) {
+            uint64_t one = 1;
+            ssize_t ignored = write(wakeFd, &one, sizeof(one));
+            (void) ignored;
+        }
+    }
+}
+
+/**
+ * @brief Reader pool body: serves lookups and queries until the server stops.
+ */
+void ForestServer::readerLoop() {
+    while (true) {
+        Request request;
+        {
+            unique_lock<mutex> lock(readMutex);
+            readReady.wait(lock, [this] { return !running || !readQueue.empty(); });
+            if (readQueue.empty()) {
+                return;
+            }
+            request = move(readQueue.front());
+            readQueue.pop_front();
+        }
+
+        try {
+            shared_lock<shared_mutex> lock(treeMutex);
+            serveRead(request);
+        } catch (const exception &e) {
+            cerr << "Error serving request: " << e.what() << endl;
+            respond(request.connection, request.requestId, ResponseStatus::Error);
+        }
+    }
+}
+
+/**
+ * @brief Answers a FindAccount or Query request. Called with the tree locked for reading.
+ *
+ * @param request The request.
+ */
+void ForestServer::serveRead(const Request &request) {
+    FrameReader reader(request.payload.data(), request.payload.size());
+    FrameWriter response;
+
+    if (request.op == RequestOp::FindAccount) {
+        int32_t accountNumber;
+        if (!reader.getI32(accountNumber)) {
+            respond(request.connection, request.requestId, ResponseStatus::BadRequest);
+            return;
+        }
+        NodePtr node = tree.findAccount(accountNumber);
+        if (!node) {
+            respond(request.connection, request.requestId, ResponseStatus::NotFound);
+            return;
+        }
+        const Account &account = node->getData();
+        response.putI32(account.getAccountNumber());
+        response.putDouble(account.getBalance());
+        response.putString(account.getDescription());
+        response.putU32(static_cast<uint32_t>(account.getTransactions().size()));
+        respond(request.connection, request.requestId, ResponseStatus::Ok, response.data());
+        return;
+    }
+
+    int32_t accountNumber;
+    uint8_t type;
+    uint32_t limit;
+    TransactionQuery filter;
+    if (!reader.getI32(accountNumber) || !reader.getI32(filter.fromDayKey) || !reader.getI32(filter.toDayKey) ||
+        !reader.getDouble(filter.minAmount) || !reader.getDouble(filter.maxAmount) || !reader.getU8(type) ||
+        !reader.getString(filter.descriptionContains) || !reader.getU32(limit)) {
+        respond(request.connection, request.requestId, ResponseStatus::BadRequest);
+        return;
+    }
+    filter.debitCredit = static_cast<char>(type);
+
+    if (!tree.findAccount(accountNumber)) {
+        respond(request.connection, request.requestId, ResponseStatus::NotFound);
+        return;
+    }
+
+    FrameWriter rows;
+    uint32_t returned = 0;
+    // One match past the limit is counted, so the client can tell the rows were cut short, and the scan stops there
+    size_t matches = tree.query(accountNumber, filter, [&](const Account &account, const Transaction &t) {
+        if (returned >= limit) {
+            return false;
+        }
+        rows.putI32(account.getAccountNumber());
+        rows.putString(t.getTransactionID());
+        rows.putDouble(t.getAmount());
+        rows.putU8(static_cast<uint8_t>(t.getDebitCredit()));
+        rows.putString(t.getDate());
+        rows.putString(t.getDescription());
+        ++returned;
+        return true;
+    });
+
+    response.putU32(static_cast<uint32_t>(matches));
+    response.putU32(returned);
+    respond(request.connection, request.requestId, ResponseStatus::Ok, response.data() + rows.data());
+}
+
+/**
+ * @brief Writer body: applies postings in batches until the server stops.
+ */
+void ForestServer::writerLoop() {
+    while (true) {
+        vector<Request> batch;
+        {
+            unique_lock<mutex> lock(writeMutex);
+            writeReady.wait(lock, [this] { return !running || !writeQueue.empty(); });
+            if (writeQueue.empty()) {
+                return;
+            }
+            while (!writeQueue.empty() && batch.size() < config.batchSize) {
+                batch.push_back(move(writeQueue.front()));
+                writeQueue.pop_front();
+            }
+        }
+
+        // Decode outside the lock; malformed postings are answered straight away
+        vector<Posting> postings;
+        vector<const Request *> posted;
+        for (const Request &request: batch) {
+            FrameReader reader(request.payload.data(), request.payload.size());
+            int32_t accountNumber;
+            string id, date, description;
+            double amount;
+            uint8_t type;
+            if (!reader.getI32(accountNumber) || !reader.getString(id) || !reader.getDouble(amount) ||
+                !reader.getU8(type) || !reader.getString(date) || !reader.getString(description)) {
+                respond(request.connection, request.requestId, ResponseStatus::BadRequest);
+                continue;
+            }
+            // The constructor would quietly turn these into a debit or a zero amount
+            if ((type != 'D' && type != 'C') || !(amount >= 0)) {
+                respond(request.connection, request.requestId, ResponseStatus::BadRequest);
+                continue;
+            }
+            Transaction transaction(id, amount, static_cast<char>(type), description, date);
+            if (!transaction.isValid()) {
+                respond(request.connection, request.requestId, ResponseStatus::BadRequest);
+                continue;
+            }
+            postings.emplace_back(accountNumber, transaction);
+            posted.push_back(&request);
+        }
+        if (postings.empty()) {
+            continue;
+        }
+
+        vector<ResponseStatus> statuses(postings.size(), ResponseStatus::Ok);
+        uint64_t sequence;
+        {
+            FOREST_TRACE_SPAN("server write batch");
+            unique_lock<shared_mutex> lock(treeMutex);
+            vector<bool> applied = tree.postTransactions(postings);
+            for (size_t i = 0; i < applied.size(); ++i) {
+                if (!applied[i]) {
+                    // A posting to an existing account only fails when its ID was already posted
+                    statuses[i] = tree.findAccount(postings[i].first) ? ResponseStatus::Duplicate
+                                                                       : ResponseStatus::NotFound;
+                }
+            }
+            sequence = tree.getLastChangeSequence();
+        }
+
+        // Acknowledge only once the batch is on disk, in both the transaction file and the chart; readers already see
+        // it, since the lock is released. The chart follows the transactions, so it never holds balances they lack.
+        bool chartSaved = false;
+        if (tree.waitDurable(sequence)) {
+            unique_lock<shared_mutex> lock(treeMutex);
+            chartSaved = tree.commitIfDue();
+        }
+        if (!chartSaved) {
+            for (const Request *request: posted) {
+                respond(request->connection, request->requestId, ResponseStatus::Error);
+            }
+            continue;
+        }
+        for (size_t i = 0; i < posted.size(); ++i) {
+            respond(posted[i]->connection, posted[i]->requestId, statuses[i]);
+        }
+    }
+}
+
+/**
+ * @brief Stops the workers and closes every socket.
+ */
+void ForestServer::shutdown() {
+    // Take each queue lock once so a worker between its predicate check and its wait cannot miss the wakeup
+    {
+        lock_guard<mutex> lock(readMutex);
+    }
+    readReady.notify_all();
+    {
+        lock_guard<mutex> lock(writeMutex);
+    }
+    writeReady.notify_all();
+    for (thread &reader: readerThreads) {
+        if (reader.joinable()) {
+            reader.join();
+        }
+    }
+    readerThreads.clear();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+
+    for (auto &entry: connections) {
+        entry.second->closed = true;
+        close(entry.first);
+    }
+    connections.clear();
+
+    if (listenFd >= 0) {
+        close(listenFd);
+        if (!config.socketPath.empty()) {
+            unlink(config.socketPath.c_str());
+        }
+        listenFd = -1;
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
+}
@@ -0,0 +1,213 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTSERVER_H
+#define ADS_MIDTERM_PROJECT_FORESTSERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include "ForestTree.h"
+#include "ForestProtocol.h"
+
+using namespace std;
+
+/**
+ * @struct ServerConfig
+ * @brief Where a `ForestServer` listens and how many threads it uses.
+ */
+struct ServerConfig {
+    string socketPath;        ///< Unix-domain socket to listen on; when empty, listen on loopback TCP instead
+    int port = 7420;          ///< Loopback TCP port, used when `socketPath` is empty
+    size_t readers = 4;       ///< Threads serving lookups and queries
+    size_t batchSize = 256;   ///< Maximum number of postings the writer applies per batch
+};
+
+/**
+ * @class ForestServer
+ * @brief Serves one in-memory `ForestTree` to many local clients over the `ForestProtocol` frame protocol.
+ *
+ * One epoll event loop owns every socket: it accepts clients, reads and splits frames, and writes responses. Decoded
+ * requests are routed by lane:
+ *
+ * - lookups and queries go to a pool of reader threads, which run concurrently under a shared lock on the tree;
+ * - postings go to a single writer thread, which drains up to `batchSize` of them at a time, applies the whole
+ *   batch with `ForestTree::postTransactions` under an exclusive lock, and acknowledges it once the tree's background
+ *   writer reports the transactions durable (when background persistence is enabled) and the chart has then been
+ *   saved with the new balances.
+ *
+ * Workers append encoded responses to their connection's output buffer and wake the event loop through an eventfd,
+ * so only the loop thread ever touches a socket. Requests may be pipelined; each response echoes its request ID.
+ */
+class ForestServer {
+private:
+    /**
+     * @brief One client connection.
+     */
+    struct Connection {
+        int fd;                         ///< The client socket, owned by the event loop
+        string input;                   ///< Bytes received but not yet split into frames
+        mutex outputMutex;              ///< Guards `output`, and the decrements of `unanswered`
+        string output;                  ///< Encoded responses waiting to be sent
+        size_t outputOffset = 0;        ///< Bytes of `output` already sent
+        atomic<size_t> unanswered{0};   ///< Requests dispatched whose response is not yet queued
+        atomic<bool> closed{false};     ///< Set once the socket is closed; later responses are dropped
+        bool inputClosed = false;       ///< Whether the client has stopped sending (event loop only)
+        bool wantRead = true;           ///< Whether EPOLLIN is registered (event loop only)
+        bool wantWrite = false;         ///< Whether EPOLLOUT is registered (event loop only)
+    };
+
+    typedef shared_ptr<Connection> ConnectionPtr;
+
+    /**
+     * @brief A decoded request waiting for a reader or the writer.
+     */
+    struct Request {
+        ConnectionPtr connection;       ///< Where to send the response
+        uint32_t requestId;             ///< Echoed in the response
+        RequestOp op;                   ///< The operation
+        string payload;                 ///< The undecoded request fields
+    };
+
+    ForestTree &tree;                   ///< The ledger being served
+    ServerConfig config;                ///< Listening address and thread counts
+    shared_mutex treeMutex;             ///< Shared by readers, exclusive for the writer
+
+    int listenFd;                       ///< The listening socket
+    int epollFd;                        ///< The event loop's epoll instance
+    int wakeFd;                         ///< eventfd used to wake the event loop
+    atomic<bool> running;               ///< Cleared by `stop()`
+    unordered_map<int, ConnectionPtr> connections; ///< Open connections by socket (event loop only)
+
+    mutex readMutex;                    ///< Guards `readQueue`
+    condition_variable readReady;       ///< Signalled when a read request is queued
+    deque<Request> readQueue;           ///< Lookups and queries waiting for a reader
+
+    mutex writeMutex;                   ///< Guards `writeQueue`
+    condition_variable writeReady;      ///< Signalled when a posting is queued
+    deque<Request> writeQueue;          ///< Postings waiting for the writer
+
+    mutex flushMutex;                   ///< Guards `flushQueue`
+    vector<ConnectionPtr> flushQueue;   ///< Connections with new output for the event loop to send
+
+    vector<thread> readerThreads;       ///< The reader pool
+    thread writerThread;                ///< The single writer
+
+    /**
+     * @brief Creates and binds the listening socket described by the configuration.
+     *
+     * @return True on success; on failure the error is printed and false is returned.
+     */
+    bool openListener();
+
+    /**
+     * @brief Accepts every pending client connection.
+     */
+    void acceptClients();
+
+    /**
+     * @brief Reads everything available on a connection and dispatches each complete frame.
+     *
+     * @param connection The connection.
+     */
+    void readFrom(const ConnectionPtr &connection);
+
+    /**
+     * @brief Sends as much queued output as the socket accepts, registering for EPOLLOUT if some remains.
+     *
+     * @param connection The connection.
+     */
+    void writeTo(const ConnectionPtr &connection);
+
+    /**
+     * @brief Closes a connection and forgets it. Responses still in flight for it are dropped.
+     *
+     * @param connection The connection.
+     */
+    void closeConnection(const ConnectionPtr &connection);
+
+    /**
+     * @brief Routes a decoded frame to the reader pool, the writer, or answers it directly.
+     *
+     * @param request The request.
+     */
+    void dispatch(Request &&request);
+
+    /**
+     * @brief Queues an encoded response on a connection and wakes the event loop to send it.
+     *
+     * @param connection The connection.
+     * @param requestId The request being answered.
+     * @param status The outcome.
+     * @param payload The response fields.
+     */
+    void respond(const ConnectionPtr &connection, uint32_t requestId, ResponseStatus status,
+                 const string &payload = "");
+
+    /**
+     * @brief Reader pool body: serves lookups and queries until the server stops.
+     */
+    void readerLoop();
+
+    /**
+     * @brief Writer body: applies postings in batches until the server stops.
+     */
+    void writerLoop();
+
+    /**
+     * @brief Answers a FindAccount or Query request. Called with the tree locked for reading.
+     *
+     * @param request The request.
+     */
+    void serveRead(const Request &request);
+
+    /**
+     * @brief Stops the workers and closes every socket.
+     */
+    void shutdown();
+
+public:
+    /**
+     * @brief Creates a server for a tree. Nothing is opened until `start()`.
+     *
+     * @param tree The ledger to serve. It must not be modified by anyone else while the server runs.
+     * @param config Listening address and thread counts.
+     */
+    ForestServer(ForestTree &tree, const ServerConfig &config);
+
+    /**
+     * @brief Stops the server if it is still running.
+     */
+    ~ForestServer();
+
+    ForestServer(const ForestServer &) = delete;
+    ForestServer &operator=(const ForestServer &) = delete;
+
+    /**
+     * @brief Opens the listening socket and starts the reader pool and the writer.
+     *
+     * @return True on success; on failure the error is printed and false is returned.
+     */
+    bool start();
+
+    /**
+     * @brief Runs the event loop on the calling thread until `stop()` is called, then shuts down.
+     */
+    void run();
+
+    /**
+     * @brief Asks the event loop to exit. Safe to call from another thread or a signal handler.
+     */
+    void stop();
+};
+
+#endif //ADS_MIDTERM_PROJECT_FORESTSERVER_H
@@ -0,0 +1,141 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file ForestTrace.cpp
+ * @brief Implements the per-thread span ring buffers and Chrome trace export of `ForestTrace`.
+ */
+
+#include "ForestTrace.h"
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdexcept>
+#include <iomanip>
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief The span ring of one thread. Only the owning thread writes to it.
+     */
+    struct ThreadRing {
+        uint32_t threadId;                     ///< Small sequential ID shown as the trace "tid"
+        atomic<uint64_t> written{0};           ///< Total spans ever written; slot = written % capacity
+        atomic<uint64_t> epoch{0};             ///< Trace generation the ring's contents belong to
+        TraceEvent events[ForestTrace::RING_CAPACITY];
+    };
+
+    mutex registryMutex;                        ///< Guards `registry`, only taken once per thread and on export
+    vector<unique_ptr<ThreadRing>> registry;    ///< Every ring ever created
+    atomic<uint64_t> traceEpoch{0};             ///< Bumped by start() to discard older spans
+
+    const chrono::steady_clock::time_point origin = chrono::steady_clock::now();
+
+    ThreadRing &localRing() {
+        thread_local ThreadRing *ring = nullptr;
+        if (!ring) {
+            lock_guard<mutex> lock(registryMutex);
+            registry.push_back(unique_ptr<ThreadRing>(new ThreadRing()));
+            ring = registry.back().get();
+            ring->threadId = static_cast<uint32_t>(registry.size());
+        }
+        return *ring;
+    }
+}
+
+atomic<bool> ForestTrace::active(false);
+
+/**
+ * @brief Starts keeping spans and discards any recorded earlier.
+ */
+void ForestTrace::start() {
+    traceEpoch.fetch_add(1, memory_order_acq_rel);
+    active.store(true, memory_order_release);
+}
+
+/**
+ * @brief Stops keeping spans.
+ */
+void ForestTrace::stop() {
+    active.store(false, memory_order_release);
+}
+
+/**
+ * @brief Returns true while spans are being kept.
+ *
+ * @return True if tracing is active.
+ */
+bool ForestTrace::isActive() {
+    return active.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Records one completed span on the calling thread.
+ *
+ * @param name The span name.
+ * @param start The start time.
+ * @param end The end time.
+ */
+void ForestTrace::record(const char *name, uint64_t start, uint64_t end) {
+    ThreadRing &ring = localRing();
+
+    // A new trace generation invalidates whatever the ring held before
+    uint64_t epoch = traceEpoch.load(memory_order_acquire);
+    if (ring.epoch.load(memory_order_relaxed) != epoch) {
+        ring.written.store(0, memory_order_release);
+        ring.epoch.store(epoch, memory_order_relaxed);
+    }
+
+    uint64_t index = ring.written.load(memory_order_relaxed);
+    ring.events[index % RING_CAPACITY] = TraceEvent{name, start, end - start};
+    ring.written.store(index + 1, memory_order_release);
+}
+
+/**
+ * @brief Returns the current time on the trace clock.
+ *
+ * @return Nanoseconds since the process started; never 0.
+ */
+uint64_t ForestTrace::now() {
+    return static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count()) + 1;
+}
+
+/**
+ * @brief Writes every recorded span as a Chrome trace-event JSON file.
+ *
+ * Each span becomes a complete ("X") event with microsecond timestamps.
+ *
+ * @param filename The file to write.
+ * @throws runtime_error If the file cannot be opened.
+ */
+void ForestTrace::writeChromeTrace(const string &filename) {
+    ofstream file(filename);
+    if (!file) {
+        throw runtime_error("Unable to open trace file for writing: " + filename);
+    }
+
+    uint64_t epoch = traceEpoch.load(memory_order_acquire);
+    bool first = true;
+    file << fixed << setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    lock_guard<mutex> lock(registryMutex);
+    for (const unique_ptr<ThreadRing> &ring: registry) {
+        if (ring->epoch.load(memory_order_relaxed) != epoch) {
+            continue;
+        }
+        uint64_t written = ring->written.load(memory_order_acquire);
+        uint64_t begin = written > RING_CAPACITY ? written - RING_CAPACITY : 0;
+        for (uint64_t i = begin; i < written; ++i) {
+            const TraceEvent &event = ring->events[i % RING_CAPACITY];
+            file << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                 << ring->threadId << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0
+                 << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+}
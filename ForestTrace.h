@@ -0,0 +1,129 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_FORESTTRACE_H
+#define ADS_MIDTERM_PROJECT_FORESTTRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @struct TraceEvent
+ * @brief One completed span: a static name, a start time and a duration, both in nanoseconds.
+ */
+struct TraceEvent {
+    const char *name;   ///< Span name; must be a string literal
+    uint64_t start;     ///< Start time, relative to the trace clock origin
+    uint64_t duration;  ///< Duration
+};
+
+/**
+ * @class ForestTrace
+ * @brief Scoped trace spans written to a Chrome / Perfetto JSON trace.
+ *
+ * Each thread records into its own fixed-size ring buffer, so recording a span never takes a lock: the owning thread
+ * writes the slot and then publishes it with a release store of the write index. When a buffer wraps, the oldest
+ * spans are overwritten. Buffers are registered once per thread and live until the process exits, so spans of
+ * finished threads still appear in the trace.
+ *
+ * Spans are recorded through `FOREST_TRACE_SPAN`, which compiles to nothing unless `FOREST_ENABLE_TRACING` is
+ * defined, and are only kept between `start()` and `stop()`.
+ */
+class ForestTrace {
+public:
+    static const size_t RING_CAPACITY = 1 << 16; ///< Spans kept per thread
+
+    /**
+     * @brief Starts keeping spans and discards any recorded earlier.
+     */
+    static void start();
+
+    /**
+     * @brief Stops keeping spans. Recorded spans stay available for writing.
+     */
+    static void stop();
+
+    /**
+     * @brief Returns true while spans are being kept.
+     *
+     * @return True if tracing is active
+     */
+    static bool isActive();
+
+    /**
+     * @brief Records one completed span on the calling thread.
+     *
+     * @param name The span name; must be a string literal
+     * @param start The start time from `now()`
+     * @param end The end time from `now()`
+     */
+    static void record(const char *name, uint64_t start, uint64_t end);
+
+    /**
+     * @brief Returns the current time on the trace clock, in nanoseconds.
+     *
+     * @return The time
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Writes every recorded span as a Chrome trace-event JSON file.
+     *
+     * Open the file in chrome://tracing or ui.perfetto.dev. Call it while the traced threads are idle; spans recorded
+     * during the write may or may not appear.
+     *
+     * @param filename The file to write
+     * @throws runtime_error If the file cannot be opened
+     */
+    static void writeChromeTrace(const string &filename);
+
+private:
+    static atomic<bool> active; ///< Whether spans are being kept
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the time between its construction and destruction as one span.
+ */
+class TraceSpan {
+private:
+    const char *name; ///< Span name
+    uint64_t start;   ///< Start time, 0 if tracing was inactive
+
+public:
+    /**
+     * @brief Opens a span.
+     *
+     * @param name The span name; must be a string literal
+     */
+    explicit TraceSpan(const char *name) : name(name), start(ForestTrace::isActive() ? ForestTrace::now() : 0) {}
+
+    /**
+     * @brief Closes the span and records it.
+     */
+    ~TraceSpan() {
+        if (start != 0) {
+            ForestTrace::record(name, start, ForestTrace::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+};
+
+#define FOREST_TRACE_CONCAT_INNER(a, b) a##b
+#define FOREST_TRACE_CONCAT(a, b) FOREST_TRACE_CONCAT_INNER(a, b)
+
+#ifdef FOREST_ENABLE_TRACING
+/// Traces the rest of the enclosing scope as a span called `name` (a string literal).
+#define FOREST_TRACE_SPAN(name) TraceSpan FOREST_TRACE_CONCAT(forestTraceSpan, __LINE__)(name)
+#else
+#define FOREST_TRACE_SPAN(name) ((void) 0)
+#endif
+
+#endif //ADS_MIDTERM_PROJECT_FORESTTRACE_H
@@ -12,22 +12,36 @@
  * of accounts and subaccounts.
  */
 #include "ForestTree.h"
+#include "AtomicFileWriter.h"
+#include "RecordChecksum.h"
+#include "LedgerDate.h"
+#include "TransactionIdGenerator.h"
+#include "ForestIterators.h"
+#include "WorkerPool.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <string>
 #include <iomanip>
 #include <stdexcept>
-#include <queue>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <numeric>
+#include <climits>
+#include <charconv>
 
 using namespace std;
 
 // Constructor
 /**
  * @brief Default constructor for the ForestTree class.
- * Initializes the tree but does not allocate any nodes.
+ * Initializes the tree but does not allocate any nodes. Until `buildFromFile` or `enableBackgroundPersistence`
+ * gives it a transaction file, changes are kept in memory only.
  */
-ForestTree::ForestTree() {}
+ForestTree::ForestTree()
+        : rewritePending(false), chartPending(false), chartWriteFailed(false), chartSequence(0), repairPending(false),
+          pendingChanges(0) {}
 
 // Destructor
 /**
@@ -35,6 +49,8 @@ ForestTree::ForestTree() {}
  * Deletes all nodes in the tree and clears the root accounts.
  */
 ForestTree::~ForestTree() {
+    // Whatever the policy, a clean shutdown keeps every change
+    commit();
     cleanupTree();
 }
 
@@ -47,6 +63,17 @@ void ForestTree::cleanupTree() {
         delete root;
     }
     rootAccounts.clear();
+    accountIndex.clear();
+    balanceIndex.clear();
+    searchIndex.clear();
+    transactionIds.clear();
+    transactionBlocks.clear();
+    pendingAppends.clear();
+    rewritePending = false;
+    chartPending = false;
+    chartWriteFailed = false;
+    repairPending = false;
+    pendingChanges = 0;
 }
 
 /**
@@ -72,44 +99,50 @@ void ForestTree::initialize() {
  * In case of errors during file processing, the method catches exceptions and continues with the next line.
  */
 void ForestTree::buildFromFile(const string &filename) {
+    FOREST_METRIC_TIMER(MetricOp::BuildFromFile);
+    FOREST_TRACE_SPAN("buildFromFile");
     ifstream file(filename);
     if (!file.is_open()) {
         cerr << "Error opening file: " << filename << endl;
         return;
     }
-
-    string line;
-    while (getline(file, line)) {
-        // Skip empty lines
-        if (line.empty()) {
-            continue;
-        }
-
-        // Create a string stream from the line
-        istringstream lineStream(line);
-        Account newAccount;
-
-        try {
+    loadIntegrity = IntegrityReport();
+
+    // Parse every line first, then link the accounts into the tree
+    vector<Account> parsed;
+    {
+        FOREST_TRACE_SPAN("parse chart");
+        RecordReader records(file, filename, loadIntegrity);
+        string line;
+        while (records.next(line)) {
             // Use Account's operator>> to read the account details
-            lineStream >> newAccount;
-
-            // Calculate parent number based on account number string
-            string accStr = to_string(newAccount.getAccountNumber());
-            int parentNumber = accStr.length() > 1 ?
-                               stoi(accStr.substr(0, accStr.length() - 1)) : -1;
-
-            // Add account to tree
-            addAccount(newAccount, parentNumber);
+            istringstream lineStream(line);
+            lineStream >> parsed.emplace_back();
+        }
+    }
 
-        } catch (const exception &e) {
-            cerr << "Error processing line: " << line << endl;
-            cerr << "Error details: " << e.what() << endl;
-            continue;  // Skip this line and continue with the next one
+    {
+        FOREST_TRACE_SPAN("link tree");
+        for (Account &newAccount: parsed) {
+            int accountNumber = newAccount.getAccountNumber();
+            try {
+                // Add account to tree; the parsed copy is not needed afterwards
+                addAccount(move(newAccount), parentAccountNumber(accountNumber));
+
+            } catch (const exception &e) {
+                cerr << "Error processing account: " << accountNumber << endl;
+                cerr << "Error details: " << e.what() << endl;
+                continue;  // Skip this account and continue with the next one
+            }
         }
     }
 
     file.close();
     cout << "Chart of accounts built from file successfully." << endl;
+    chartFile = filename;
+    if (!persistence) {
+        transactionsFile = getTransactionFilename(filename);
+    }
     loadTransactions(getTransactionFilename(filename));
 }
 
@@ -125,6 +158,8 @@ void ForestTree::buildFromFile(const string &filename) {
  * If no transactions are found, a message indicating no transactions will be written.
  */
 void ForestTree::printDetailedReport(int accountNumber, const string &filename) const {
+    FOREST_METRIC_TIMER(MetricOp::PrintDetailedReport);
+    FOREST_TRACE_SPAN("printDetailedReport");
     ofstream file(filename);
     if (!file.is_open()) {
         throw runtime_error("Could not open file for writing: " + filename);
@@ -167,6 +202,7 @@ void ForestTree::printDetailedReport(int accountNumber, const string &filename)
  * If the tree is empty, a message indicating that will be printed instead.
  */
 void ForestTree::printForestTree() const {
+    FOREST_METRIC_TIMER(MetricOp::PrintForestTree);
     if (rootAccounts.empty()) {
         cout << "Tree is empty." << endl;
         return;
@@ -188,51 +224,45 @@ void ForestTree::printForestTree() const {
  *
  * @return NodePtr A pointer to the node containing the account if found, or nullptr if not found.
  *
- * @details This method traverses the forest tree and searches for the account with the specified account number.
+ * @details The node is looked up in the account index, so the cost does not depend on the size of the forest.
  * If the account is not found, nullptr is returned.
  */
 NodePtr ForestTree::findAccount(int accountNumber) const {
-    for (NodePtr root: rootAccounts) {
-        if (root) {
-            NodePtr found = root->findNode(root, accountNumber);
-            if (found) return found;
-        }
-    }
-    return nullptr;
+    FOREST_METRIC_TIMER(MetricOp::FindAccount);
+    unordered_map<int, NodePtr>::const_iterator found = accountIndex.find(accountNumber);
+    return found == accountIndex.end() ? nullptr : found->second;
 }
 
 /**
- * @brief Recursively prints the tree structure starting from a given node.
+ * @brief Prints the tree structure starting from a given node.
  *
  * @param node A pointer to the node to start printing from.
- * @param level The current level of indentation for the node being printed.
+ * @param level The level of indentation for the starting node.
  *
  * @return void
  *
- * @details This helper function prints the details of each node in the tree recursively. The output includes
- * the account number, description, and balance. The level parameter is used to determine the indentation
- * for each node based on its depth in the tree.
+ * @details This helper function prints the details of the node, its descendants and its right siblings in pre-order.
+ * The output includes the account number, description, and balance. Each node is indented by its depth in the
+ * tree, counted from the level given for the starting node.
  */
 void ForestTree::printTreeHelper(NodePtr node, int level) const {
-    if (!node || !node->getData().getAccountNumber()) {
-        return;
-    }
-
-    // Print indentation based on the level
-    for (int i = 0; i < level; ++i) {
-        cout << "  ";
-    }
-
-    // Print account details
-    cout << node->getData().getAccountNumber() << " - "
-         << node->getData().getDescription()
-         << " (Balance: " << node->getData().getBalance() << ")" << endl;
+    ForestRange<PreOrderIterator> nodes = preOrder(node, true);
+    for (PreOrderIterator it = nodes.begin(); it != nodes.end(); ++it) {
+        const Account &account = it->getData();
+        if (!account.getAccountNumber()) {
+            continue;
+        }
 
-    // Recur for child nodes
-    printTreeHelper(node->getLeftChild(), level + 1);
+        // Print indentation based on the level
+        for (int i = 0; i < level + it.depth(); ++i) {
+            cout << "  ";
+        }
 
-    // Recur for sibling nodes
-    printTreeHelper(node->getRightSibling(), level);
+        // Print account details
+        cout << account.getAccountNumber() << " - "
+             << account.getDescription()
+             << " (Balance: " << account.getBalance() << ")" << endl;
+    }
 }
 
 /**
@@ -245,53 +275,145 @@ void ForestTree::printTreeHelper(NodePtr node, int level) const {
  * @return bool Returns true if the account was successfully added, false if it already exists or the parent is not found.
  *
  * @details This method adds an account to the tree. If the parent account is provided, the new account will be added
- * under the parent. If no parent is provided, the account is added as a root account. The method checks if the account
- * already exists before adding it, and if the parent is not found, it will search for an ancestor to add the account to.
+ * under the parent. If no parent is provided, the account is added as a root account. The parent must be the account
+ * number without its last digit; it is looked up in the account index and the new node is linked straight into its
+ * sorted place among the parent's children, so no part of the forest is scanned.
  */
 bool ForestTree::addAccount(const Account &newAccount, int parentNumber) {
+    // Only copy an account that will actually be linked
+    if (accountIndex.count(newAccount.getAccountNumber())) {
+        return false;
+    }
+    return addAccount(Account(newAccount), parentNumber);
+}
+
+/**
+ * @brief Adds a new account to the tree structure, moving it into its node.
+ *
+ * @param newAccount The new account to be added. Left empty if it was added, untouched otherwise.
+ * @param parentNumber The account number of the parent to which the new account should be added.
+ * If -1, the account is added as a root account.
+ *
+ * @return bool Returns true if the account was successfully added, false if it already exists or the parent is not found.
+ *
+ * @details Same as the copying overload, except that the account's transactions and period buckets are taken over by
+ * the new node rather than copied.
+ */
+bool ForestTree::addAccount(Account &&newAccount, int parentNumber) {
+    FOREST_METRIC_TIMER(MetricOp::AddAccount);
     int accNum = newAccount.getAccountNumber();
 
-    // Handle root accounts (single digit)
+    // Check if account already exists
+    if (accountIndex.count(accNum)) {
+        return false;
+    }
+
+    NodePtr newNode;
     if (parentNumber == -1) {
-        if (findAccount(accNum)) {
-            return false;  // Account already exists
-        }
-        NodePtr newNode = new TreeNode(newAccount);
+        // Handle root accounts (single digit)
+        newNode = new TreeNode(move(newAccount));
         rootAccounts.push_back(newNode);
-        return true;
+    } else {
+        // Ancestors are found by dropping digits, so the parent must be exactly the number without its last digit
+        NodePtr parentNode = parentNumber == parentAccountNumber(accNum) ? findAccount(parentNumber) : nullptr;
+        if (!parentNode) {
+            return false;  // No suitable parent found
+        }
+        newNode = parentNode->insertChild(move(newAccount));
     }
 
-    // Find parent node for non-root accounts
-    NodePtr parentNode = findAccount(parentNumber);
-    if (!parentNode) {
-        // If parent doesn't exist, try to find a suitable ancestor
-        string accStr = to_string(accNum);
-        string parentStr = accStr;
-        while (parentStr.length() > 1 && !parentNode) {
-            parentStr = parentStr.substr(0, parentStr.length() - 1);
-            parentNode = findAccount(stoi(parentStr));
-        }
+    indexAccount(newNode);
+    return true;
+}
 
-        if (!parentNode) {
-            return false;  // No suitable parent found
+/**
+ * @brief Adds a batch of new accounts, posting their initial balances as opening entries and saving the chart once.
+ *
+ * @param batch The accounts to add, in any order. A parent may be added in the same batch as its children.
+ * @param path The chart of accounts file to rewrite, or empty to leave the chart file alone.
+ *
+ * @return vector<bool> One entry per account, true if it was added.
+ *
+ * @details Account numbers with fewer digits are smaller, so sorting the batch by number links every parent before
+ * its children. Accounts are linked with a zero balance and each non-zero initial balance becomes an opening-entry
+ * transaction; posting those as one batch rolls them up the hierarchy and records them in the transaction file, so
+ * the balances can be recomputed from transactions alone. The tree's own chart is marked pending and saved once, along
+ * with those transactions, when the durability policy writes them; any other `path` gets a snapshot right away.
+ */
+vector<bool> ForestTree::addAccounts(const vector<Account> &batch, const string &path) {
+    return addAccounts(vector<Account>(batch), path);
+}
+
+/**
+ * @brief Adds a batch of new accounts, moving each one into its node.
+ *
+ * @param batch The accounts to add, in any order. The entries that were added are left empty.
+ * @param path The chart of accounts file to rewrite, or empty to leave the chart file alone.
+ *
+ * @return vector<bool> One entry per account, true if it was added.
+ *
+ * @details Same as the copying overload, without copying the accounts.
+ */
+vector<bool> ForestTree::addAccounts(vector<Account> &&batch, const string &path) {
+    FOREST_METRIC_TIMER(MetricOp::AddAccounts);
+    FOREST_TRACE_SPAN("addAccounts");
+    vector<bool> added(batch.size(), false);
+
+    // A stable sort keeps the first of two entries with the same number, as adding them one by one would
+    vector<size_t> order(batch.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&batch](size_t a, size_t b) {
+        return batch[a].getAccountNumber() < batch[b].getAccountNumber();
+    });
+
+    vector<Posting> openings;
+    size_t addedCount = 0;
+    {
+        FOREST_TRACE_SPAN("link accounts");
+        string today = LedgerDate::format(LedgerDate::today());
+        for (size_t i: order) {
+            int accountNumber = batch[i].getAccountNumber();
+            double balance = batch[i].getBalance();
+            batch[i].setBalance(0);
+            if (accountNumber <= 0 || !addAccount(move(batch[i]), parentAccountNumber(accountNumber))) {
+                batch[i].setBalance(balance);
+                continue;
+            }
+            added[i] = true;
+            ++addedCount;
+
+            if (balance != 0) {
+                // A fresh generated ID, so the opening entry can never collide with a posted one
+                openings.emplace_back(accountNumber,
+                                      Transaction(TransactionIdGenerator::format(TransactionIdGenerator::next()),
+                                                  fabs(balance), balance > 0 ? 'D' : 'C', "Opening balance", today));
+            }
         }
     }
 
-    // Check if account already exists
-    if (findAccount(accNum)) {
-        return false;
+    if (addedCount == 0) {
+        return added;
+    }
+    // The tree's own chart is saved once, with the opening entries, when the durability policy writes them
+    bool ownChart = !path.empty() && !chartFile.empty() &&
+                    filesystem::absolute(path).lexically_normal() == filesystem::absolute(chartFile).lexically_normal();
+    chartPending = chartPending || ownChart;
+    if (!openings.empty()) {
+        FOREST_TRACE_SPAN("post opening balances");
+        postTransactions(openings);
+    } else {
+        commitIfDue();
     }
 
-    // Add the account under its parent
-    bool success = false;
-    for (NodePtr root: rootAccounts) {
-        if (root->addAccountNode(root, newAccount)) {
-            success = true;
-            break;
+    if (!path.empty() && !ownChart) {
+        // Any other file gets a snapshot right away; it is not tied to the tree's transaction file
+        try {
+            saveToFile(path);
+        } catch (const runtime_error &e) {
+            cerr << "Error: " << e.what() << endl;
         }
     }
-
-    return success;
+    return added;
 }
 
 /**
@@ -306,52 +428,60 @@ bool ForestTree::addAccount(const Account &newAccount, int parentNumber) {
  * If the transaction is successfully added, the method attempts to save the transaction history to a file.
  */
 bool ForestTree::addTransaction(int accountNumber, Transaction &transaction) {
-    // Find the account node and its root
-    NodePtr accountNode = nullptr;
-    NodePtr rootNode = nullptr;
-
-    // Search through all root nodes to find both the account and its root
-    for (NodePtr root: rootAccounts) {
-        accountNode = root->findNode(root, accountNumber);
-        if (accountNode) {
-            rootNode = root;
-            // Keep searching until we find the top-most root
-            while (rootNode->getRightSibling() &&
-                   to_string(rootNode->getRightSibling()->getData().getAccountNumber())[0] ==
-                   to_string(accountNode->getData().getAccountNumber())[0]) {
-                rootNode = rootNode->getRightSibling();
-            }
-            break;
-        }
+    FOREST_METRIC_TIMER(MetricOp::AddTransaction);
+    FOREST_TRACE_SPAN("addTransaction");
+    if (!applyTransaction(accountNumber, transaction)) {
+        return false;
     }
 
+    string line;
+    writeTransactionLine(line, accountNumber, transaction);
+    recordAppend(line, 1);
+    return true;
+}
+
+/**
+ * @brief Posts a transaction to an account and rolls it up the hierarchy, without saving.
+ *
+ * @param accountNumber The account number to which the transaction will be added.
+ * @param transaction The transaction to be added to the account.
+ *
+ * @return bool Returns true if the transaction was applied, false if the account is not found or an error occurs.
+ */
+bool ForestTree::applyTransaction(int accountNumber, Transaction &transaction) {
+    NodePtr accountNode = findAccount(accountNumber);
+
     if (!accountNode) {
         cout << "Error: Account not found for account number: " << accountNumber << endl;
         return false;
     }
 
-    try {
-        // First add the transaction to the account
-        accountNode->getData().addTransaction(transaction);
-
-        // Then update balances starting from the main root of this account's tree
-        for (NodePtr root: rootAccounts) {
-            if (to_string(root->getData().getAccountNumber())[0] ==
-                to_string(accountNumber)[0]) {
-                accountNode->updateBalance(root, transaction);
-                break;
-            }
-        }
+    // A retried posting carries the same ID as the original; applying it again would count it twice
+    if (!transactionIds.insert(transaction)) {
+        cout << "Error: Duplicate transaction ID: " << transaction.getTransactionID() << endl;
+        FOREST_METRIC_ADD(MetricCounter::DuplicateTransactions, 1);
+        return false;
+    }
 
-        try {
-            saveTransactions(getTransactionFilename("accountswithspace.txt"));
-        } catch (const exception &e) {
-            cerr << "Warning: Failed to save transactions: " << e.what() << endl;
+    try {
+        {
+            FOREST_TRACE_SPAN("rollup");
+
+            // First add the transaction to the account
+            accountNode->getData().addTransaction(transaction);
+            rollupPeriodTotals(accountNode, transaction, 1);
+            searchIndex.addTransaction(accountNumber, transaction);
+
+            // Then update the balances of the account and its ancestors
+            rollupBalances(accountNode, transaction, 1);
+            accountNode->getDigest().transactions += LedgerDigest::hashTransaction(transaction);
+            refreshDigests(accountNode);
         }
 
         return true;
     } catch (const exception &e) {
         cerr << "Error: " << e.what() << endl;
+        transactionIds.erase(transaction);
         return false;
     }
 }
@@ -368,24 +498,27 @@ bool ForestTree::addTransaction(int accountNumber, Transaction &transaction) {
  * If the transaction is successfully deleted, the method attempts to save the updated transaction history to a file.
  */
 bool ForestTree::deleteTransaction(int accountNumber, int transactionIndex) {
-    // Find the account node and its root
-    NodePtr accountNode = nullptr;
-    NodePtr rootNode = nullptr;
-
-    // Search through all root nodes to find both the account and its root
-    for (NodePtr root: rootAccounts) {
-        accountNode = root->findNode(root, accountNumber);
-        if (accountNode) {
-            rootNode = root;
-            while (rootNode->getRightSibling() &&
-                   to_string(rootNode->getRightSibling()->getData().getAccountNumber())[0] ==
-                   to_string(accountNode->getData().getAccountNumber())[0]) {
-                rootNode = rootNode->getRightSibling();
-            }
-            break;
-        }
+    FOREST_METRIC_TIMER(MetricOp::DeleteTransaction);
+    FOREST_TRACE_SPAN("deleteTransaction");
+    if (!applyDeletion(accountNumber, transactionIndex)) {
+        return false;
     }
 
+    recordRewrite(1);
+    return true;
+}
+
+/**
+ * @brief Removes a transaction from an account and reverses it up the hierarchy, without saving.
+ *
+ * @param accountNumber The account number from which the transaction will be deleted.
+ * @param transactionIndex The index of the transaction to delete.
+ *
+ * @return bool Returns true if the transaction was removed, false if the account or transaction is not found or an error occurs.
+ */
+bool ForestTree::applyDeletion(int accountNumber, int transactionIndex) {
+    NodePtr accountNode = findAccount(accountNumber);
+
     if (!accountNode) {
         cout << "Error: Account not found for account number: " << accountNumber << endl;
         return false;
@@ -402,37 +535,25 @@ bool ForestTree::deleteTransaction(int accountNumber, int transactionIndex) {
     }
 
     try {
-        // Get the transaction before removing it to update balances
-        Transaction deletedTransaction = transactions[transactionIndex];
-
-        // Create an inverse transaction to update balances
-        Transaction inverseTransaction(
-                deletedTransaction.getTransactionID(),
-                deletedTransaction.getAmount(),
-                deletedTransaction.getDebitCredit() == 'D' ? 'C' : 'D'  // Invert D to C and C to D
-        );
-
-        // Remove the transaction from the account
-        account.removeTransaction(transactionIndex);
-
-        // Update balances through the hierarchy using the inverse transaction
-        for (NodePtr root: rootAccounts) {
-            if (to_string(root->getData().getAccountNumber())[0] ==
-                to_string(accountNumber)[0]) {
-                accountNode->updateBalance(root, inverseTransaction);
-                break;
-            }
-        }
-
-        try {
-            saveTransactions(getTransactionFilename("accountswithspace.txt"));
-        } catch (const exception &e) {
-            cerr << "Warning: Failed to save transactions: " << e.what() << endl;
+        // Keep the transaction past its removal to reverse it through the indexes and balances
+        const Transaction deletedTransaction = transactions[transactionIndex];
+
+        {
+            FOREST_TRACE_SPAN("rollup");
+
+            // Remove the transaction from the account
+            account.removeTransaction(transactionIndex);
+            rollupPeriodTotals(accountNode, deletedTransaction, -1);
+            searchIndex.removeTransaction(accountNumber, deletedTransaction);
+            transactionIds.erase(deletedTransaction);
+
+            // Reverse the transaction's effect on the balances through the hierarchy
+            rollupBalances(accountNode, deletedTransaction, -1);
+            accountNode->getDigest().transactions -= LedgerDigest::hashTransaction(deletedTransaction);
+            refreshDigests(accountNode);
         }
 
         return true;
-
-        return true;
     } catch (const exception &e) {
         cerr << "Error while deleting transaction: " << e.what() << endl;
         return false;
@@ -440,80 +561,149 @@ bool ForestTree::deleteTransaction(int accountNumber, int transactionIndex) {
 }
 
 /**
- * @brief Saves the current state of the tree to a file, updating account balances.
+ * @brief Posts a batch of transactions and saves the transaction file once.
  *
- * @param filename The name of the file to which the tree data should be saved.
+ * @param postings The (account number, transaction) pairs to post, applied in order.
  *
- * @return void
+ * @return vector<bool> One entry per posting: true if it was applied, false if its account was not found.
  *
- * @details This method reads all lines from the specified file into memory, processes each line to update account balances,
- * and then writes the updated data back to the file. Each account's balance is retrieved from the tree and updated in the file
- * accordingly. If an account is found in the tree, the balance is updated; otherwise, the original line is retained.
- * The method handles file reading, line processing, and file writing in a structured manner.
+ * @details Each posting is applied exactly as `addTransaction` would apply it, but the transaction file is written
+ * once for the whole batch instead of once per posting.
  */
-void ForestTree::saveToFile(const string &filename) const {
-    // First, read all lines from the file into memory
-    ifstream inFile(filename);
-    if (!inFile) {
-        throw runtime_error("Unable to open file for reading: " + filename);
+vector<bool> ForestTree::postTransactions(vector<Posting> &postings) {
+    FOREST_METRIC_TIMER(MetricOp::PostTransactions);
+    FOREST_TRACE_SPAN("postTransactions");
+    vector<bool> applied(postings.size(), false);
+    string lines;
+    size_t appliedCount = 0;
+    for (size_t i = 0; i < postings.size(); ++i) {
+        applied[i] = applyTransaction(postings[i].first, postings[i].second);
+        if (applied[i]) {
+            writeTransactionLine(lines, postings[i].first, postings[i].second);
+            ++appliedCount;
+        }
     }
 
-    vector<string> lines;
-    string line;
-
-    while (getline(inFile, line)) {
-        lines.push_back(line);
+    if (appliedCount > 0) {
+        recordAppend(lines, appliedCount);
     }
-    inFile.close();
+    return applied;
+}
 
-    // Update balances in the lines
-    for (auto &line: lines) {
-        istringstream iss(line);
-        int accountNum;
-        string description;
+/**
+ * @brief Checks whether a transaction ID is already in the forest.
+ *
+ * @param transactionID The transaction ID.
+ *
+ * @return bool True if a transaction with this ID was posted or loaded and not deleted since.
+ */
+bool ForestTree::hasTransactionId(const string &transactionID) const {
+    return transactionIds.contains(transactionID);
+}
 
-        if (!(iss >> accountNum)) {
-            continue; // Skip invalid lines
+/**
+ * @brief Deletes a batch of transactions and saves the transaction file once.
+ *
+ * @param deletions The (account number, transaction index) pairs to delete.
+ *
+ * @return vector<bool> One entry per deletion: true if it was applied, false if the account or index was invalid
+ * or the same transaction was listed twice.
+ *
+ * @details Every index refers to the account's transactions as they were before the batch. Deletions are applied
+ * from the highest index down within each account, so removing one transaction never shifts the index of another
+ * transaction in the same batch.
+ */
+vector<bool> ForestTree::deleteTransactions(const vector<pair<int, int>> &deletions) {
+    FOREST_METRIC_TIMER(MetricOp::DeleteTransactions);
+    FOREST_TRACE_SPAN("deleteTransactions");
+    vector<size_t> order(deletions.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&deletions](size_t a, size_t b) {
+        if (deletions[a].first != deletions[b].first) {
+            return deletions[a].first < deletions[b].first;
         }
-
-        // Find this account in our tree
-        NodePtr accountNode = findAccount(accountNum);
-        if (!accountNode) {
-            continue; // Account not found, keep original line
+        return deletions[a].second > deletions[b].second;
+    });
+
+    vector<bool> applied(deletions.size(), false);
+    size_t appliedCount = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i > 0 && deletions[order[i]] == deletions[order[i - 1]]) {
+            continue;  // Already deleted by the previous entry
         }
-
-        // Read until the last number (current balance)
-        string word;
-        vector<string> words;
-        while (iss >> word) {
-            words.push_back(word);
+        applied[order[i]] = applyDeletion(deletions[order[i]].first, deletions[order[i]].second);
+        if (applied[order[i]]) {
+            ++appliedCount;
         }
+    }
 
-        if (!words.empty()) {
-            // Remove the last word (old balance)
-            words.pop_back();
+    if (appliedCount > 0) {
+        recordRewrite(appliedCount);
+    }
+    return applied;
+}
 
-            // Create new line with updated balance
-            ostringstream newLine;
-            newLine << accountNum;
-            for (const auto &w: words) {
-                newLine << " " << w;
-            }
-            newLine << " " << fixed << setprecision(2) << accountNode->getData().getBalance();
+/**
+ * @brief Saves the current state of the tree to a file.
+ *
+ * @param filename The name of the file to which the tree data should be saved.
+ *
+ * @return void
+ *
+ * @throws runtime_error If the file cannot be written. The previous contents are then left untouched.
+ *
+ * @details The chart is serialized straight from memory, one checksummed `number description balance` line per
+ * account and a closing section trailer: roots in account number order, each subtree in pre-order, so every parent
+ * precedes its children as `buildFromFile` expects. Lines go through a large buffer into a temp file, which is
+ * fsynced and renamed over `filename`; a crash mid-save leaves either the old file or the new one, never a torn mix.
+ */
+void ForestTree::saveToFile(const string &filename) const {
+    FOREST_METRIC_TIMER(MetricOp::SaveToFile);
+    FOREST_TRACE_SPAN("saveToFile");
+    AtomicFileWriter writer(filename);
+    ChecksumSection section;
+
+    {
+        FOREST_TRACE_SPAN("serialize accounts");
+        string record;
+        string sealed;
+        vector<NodePtr> roots = rootAccounts;
+        sort(roots.begin(), roots.end(), [](NodePtr a, NodePtr b) {
+            return a->getData().getAccountNumber() < b->getData().getAccountNumber();
+        });
+
+        for (NodePtr root: roots) {
+            for (const TreeNode &node: preOrder(root)) {
+                const Account &account = node.getData();
+                record = to_string(account.getAccountNumber());
+                record += ' ';
+                string_view description = account.getDescription();
+                if (!description.empty()) {
+                    record += description;
+                    record += ' ';
+                }
+                char balance[352];  // Enough for any double in fixed notation with two decimals
+                to_chars_result formatted = to_chars(balance, balance + sizeof(balance), account.getBalance(),
+                                                     chars_format::fixed, 2);
+                if (formatted.ec != errc()) {
+                    throw runtime_error("Unable to format the balance of account " +
+                                        to_string(account.getAccountNumber()));
+                }
+                record.append(balance, formatted.ptr);
 
-            line = newLine.str();
+                sealed.clear();
+                RecordChecksum::seal(sealed, record);
+                section.add(sealed);
+                writer.write(sealed);
+            }
         }
     }
 
-    // Write updated content back to file
-    ofstream outFile(filename);
-    if (!outFile) {
-        throw runtime_error("Unable to open file for writing: " + filename);
-    }
-
-    for (const auto &line: lines) {
-        outFile << line << endl;
-    }
+    writer.write(section.trailer());
+    FOREST_TRACE_SPAN("write accounts file");
+    FOREST_METRIC_ADD(MetricCounter::BytesWritten, writer.commit());
 }
 
 /**
@@ -525,273 +715,1303 @@ void ForestTree::saveToFile(const string &filename) const {
  *
  * @details This method traverses the entire tree, saving all transactions for each account to the specified file.
  * Each transaction is saved in the format: account number, transaction ID, amount, debit/credit, date, and description.
- * The method uses a queue to traverse the tree level by level, ensuring that all accounts and their respective transactions
+ * The method traverses the tree level by level, ensuring that all accounts and their respective transactions
  * are processed and saved.
  */
-void ForestTree::saveTransactions(const string &filename) const {
+void ForestTree::saveTransactions(const string &filename) {
+    FOREST_METRIC_TIMER(MetricOp::SaveTransactions);
+    FOREST_TRACE_SPAN("saveTransactions");
+
+    // The tree's own file also receives the pending changes (through the background writer, if any); writing it
+    // here directly would race with them or be followed by duplicate appends
+    if (!transactionsFile.empty() && filesystem::absolute(filename).lexically_normal() ==
+                                     filesystem::absolute(transactionsFile).lexically_normal()) {
+        recordRewrite(0);
+        if (!writePending()) {
+            throw runtime_error("Unable to write transaction file: " + filename);
+        }
+        return;
+    }
+
     ofstream file(filename);
     if (!file) {
         throw runtime_error("Unable to open transaction file for writing: " + filename);
     }
+    writeTransactions(file);
+    FOREST_METRIC_ADD(MetricCounter::BytesWritten, static_cast<uint64_t>(file.tellp()));
+    file.close();
+}
+
+/**
+ * @brief Writes every transaction in the forest, one sealed `account|id|amount|type|date|description` line each,
+ * followed by the section trailer.
+ *
+ * @param file The stream to write to.
+ *
+ * @return void
+ */
+void ForestTree::writeTransactions(ostream &file) const {
+    ChecksumSection section;
+    string lines;
 
     // For each account in the tree
     for (NodePtr root: rootAccounts) {
-        if (!root) continue;
-
-        // Use a queue to traverse all nodes
-        queue<NodePtr> nodeQueue;
-        nodeQueue.push(root);
-
-        while (!nodeQueue.empty()) {
-            NodePtr current = nodeQueue.front();
-            nodeQueue.pop();
-
+        // Traverse all nodes level by level
+        for (const TreeNode &node: levelOrder(root)) {
             // Save transactions for current account
-            const Account &account = current->getData();
+            const Account &account = node.getData();
             const vector<Transaction> &transactions = account.getTransactions();
 
+            lines.clear();
             for (const Transaction &t: transactions) {
-                file << account.getAccountNumber() << "|"
-                     << t.getTransactionID() << "|"
-                     << t.getAmount() << "|"
-                     << t.getDebitCredit() << "|"
-                     << t.getDate() << "|"
-                     << t.getDescription() << endl;
+                writeTransactionLine(lines, account.getAccountNumber(), t);
             }
-
-            // Add child and sibling to queue
-            if (current->getLeftChild()) nodeQueue.push(current->getLeftChild());
-            if (current->getRightSibling()) nodeQueue.push(current->getRightSibling());
+            section.add(lines);
+            file << lines;
         }
     }
-    file.close();
+    file << section.trailer();
 }
 
 /**
- * @brief Loads transactions from a file into the tree structure.
+ * @brief Appends one transaction in the transaction file format, sealed with its checksum.
  *
- * @param filename The name of the file from which transaction data should be loaded.
+ * @param out The text being built.
+ * @param accountNumber The account that owns the transaction.
+ * @param t The transaction.
  *
  * @return void
+ */
+void ForestTree::writeTransactionLine(string &out, int accountNumber, const Transaction &t) {
+    // Built in place from the packed fields; the amount is written from its exact cents
+    int64_t cents = t.getAmountCents();
+    char amount[32];
+    char *end = to_chars(amount, amount + sizeof(amount) - 4, cents / 100).ptr;
+    *end++ = '.';
+    *end++ = static_cast<char>('0' + cents % 100 / 10);
+    *end++ = static_cast<char>('0' + cents % 10);
+
+    string record = to_string(accountNumber);
+    record += '|';
+    t.appendTransactionID(record);
+    record += '|';
+    record.append(amount, end);
+    record += '|';
+    record += t.getDebitCredit();
+    record += '|';
+    LedgerDate::append(record, t.getDayKey());
+    record += '|';
+    record += t.getDescription();
+    RecordChecksum::seal(out, record);
+}
+
+/**
+ * @brief Records newly posted transactions as pending, then writes them if the durability policy says so.
  *
- * @details This method reads each transaction from the specified file and attempts to add it to the corresponding account in
- * the tree. Each line in the file is expected to contain transaction data in the format: account number, transaction ID,
- * amount, debit/credit, date, and description. If the account number exists in the tree, the transaction is added to that account.
- * If the account cannot be found, the transaction is skipped. The method handles file reading and transaction parsing,
- * with error handling for invalid lines.
+ * @param lines The new transactions, in the transaction file format.
+ * @param changes The number of postings the lines hold.
+ *
+ * @return void
  */
-void ForestTree::loadTransactions(const string &filename) {
-    ifstream file(filename);
-    if (!file) {
-        return; // It's okay if the file doesn't exist yet
+void ForestTree::recordAppend(const string &lines, size_t changes) {
+    if (repairPending) {
+        recordRewrite(changes);
+        return;
     }
-
-    string line;
-    while (getline(file, line)) {
-        istringstream iss(line);
-        string field;
-        vector<string> fields;
-
-        // Split line by '|'
-        while (getline(iss, field, '|')) {
-            fields.push_back(field);
-        }
-
-        if (fields.size() < 6) continue; // Skip invalid lines
-
-        try {
-            int accountNum = stoi(fields[0]);
-            NodePtr accountNode = findAccount(accountNum);
-            if (!accountNode) continue;
-
-            // Create and add transaction
-            Transaction t(fields[1],                    // ID
-                          stod(fields[2]),               // Amount
-                          fields[3][0],                  // Debit/Credit
-                          fields[5],                     // Description
-                          fields[4]);                    // Date
-
-            // Add transaction without updating file
-            accountNode->getData().addTransaction(t);
-            //accountNode->updateBalance(findRootForAccount(accountNum), t);
-
-        } catch (const exception &e) {
-            cerr << "Error loading transaction: " << e.what() << endl;
-            continue;
-        }
+    if (pendingChanges == 0 && !rewritePending) {
+        oldestPendingChange = chrono::steady_clock::now();
     }
-    file.close();
+    // A pending rewrite serializes every transaction anyway
+    if (!rewritePending) {
+        pendingAppends += lines;
+    }
+    pendingChanges += changes;
+    chartPending = chartPending || changes > 0;
+    commitIfDue();
 }
 
 /**
- * @brief Finds the root node for an account based on the first digit of the account number.
- *
- * @param accountNumber The account number for which the root node is to be found.
+ * @brief Records a change that needs the whole transaction file rewritten, then writes it if the durability policy
+ * says so.
  *
- * @return NodePtr A pointer to the root node of the account if found, or nullptr if not found.
+ * @param changes The number of changes made.
  *
- * @details This method attempts to find the root node of the account by comparing the first digit of the account number
- * with the first digit of the account numbers of all root accounts in the tree. If a match is found, the corresponding root node
- * is returned. If no match is found, nullptr is returned. This method assumes that accounts with the same first digit are
- * grouped together in the forest structure.
+ * @return void
  */
-NodePtr ForestTree::findRootForAccount(int accountNumber) const {
-    string accStr = to_string(accountNumber);
-    char firstDigit = accStr[0];
-    for (NodePtr root: rootAccounts) {
-        if (root && to_string(root->getData().getAccountNumber())[0] == firstDigit) {
-            return root;
-        }
+void ForestTree::recordRewrite(size_t changes) {
+    if (pendingChanges == 0 && !rewritePending) {
+        oldestPendingChange = chrono::steady_clock::now();
     }
-    return nullptr;
+    rewritePending = true;
+    pendingAppends.clear();
+    pendingChanges += changes;
+    chartPending = chartPending || changes > 0;
+    commitIfDue();
 }
 
 /**
- * @brief Generates a transaction filename based on the provided accounts file name.
+ * @brief Writes the pending changes: queued for the background writer if it is enabled, otherwise written and
+ * fsynced on the calling thread. The chart is then saved with the new balances once the transactions are durable.
  *
- * @param accountsFile The name of the accounts file.
- *
- * @return string The generated transaction file name, which appends "_transactions.txt" to the accounts file name.
+ * @return bool True if the changes were written or queued and the chart saved or left waiting for them. On failure
+ * they stay pending, the transactions as a full rewrite.
  *
- * @details This method takes the provided accounts file name and creates a corresponding transaction file name by
- * removing the file extension and appending "_transactions.txt". This helps to link the transaction file with the
- * respective accounts file in a consistent manner.
+ * @details Postings since the last write go out as one append. After a deletion the whole file is rewritten, but
+ * only the accounts flagged dirty are formatted again; every other account's lines are reused from the last rewrite.
+ * The chart is saved only after the transactions it sums are on disk, so after a crash it never holds balances the
+ * transaction file lacks. A queued background write leaves the chart to a later write or `commit`, once the writer
+ * has caught up. A tree without a transaction file has nowhere to write, so its changes are simply dropped.
  */
-string ForestTree::getTransactionFilename(const string &accountsFile) const {
-    return accountsFile.substr(0, accountsFile.find_last_of('.')) + "_transactions.txt";
-}
-
-bool ForestTree::addAccountWithFile(int accountNumber, const string &description, double balance, string path) {
-    Account newAccount;
-    newAccount.setAccountNumber(accountNumber);
-    newAccount.setDescription(description);
-    newAccount.setBalance(balance);  // Set initial balance directly
+bool ForestTree::writePending() {
+    if (transactionsFile.empty()) {
+        pendingAppends.clear();
+        rewritePending = false;
+        repairPending = false;
+        pendingChanges = 0;
+        return true;
+    }
+    // After a failed background write the file may be torn, so it is rewritten whole even with nothing new pending
+    bool repairWrite = persistence && persistence->hasFailed();
+    if (pendingChanges == 0 && !rewritePending && !repairWrite) {
+        return writePendingChart();
+    }
+    FOREST_TRACE_SPAN("write pending changes");
 
-    // Automatically determine parent account based on account number
-    string accStr = to_string(accountNumber);
-    int parentNumber = accStr.length() > 1 ? stoi(accStr.substr(0, accStr.length() - 1)) : -1;
+    bool replace = rewritePending || repairWrite;
+    size_t changes = pendingChanges;
+    string contents;
+    if (replace) {
+        serializeTransactions(contents);
+    } else {
+        contents.swap(pendingAppends);
+    }
+    pendingAppends.clear();
+    rewritePending = false;
+    repairPending = repairPending && !replace;
+    pendingChanges = 0;
+
+    // Close the batch with a section trailer, so a loader can tell whether all of it arrived
+    ChecksumSection section;
+    section.add(contents);
+    contents += section.trailer();
+
+    if (persistence) {
+        chartSequence = persistence->submit(replace ? ChangeRecord::Replace : ChangeRecord::Append, move(contents));
+        return writePendingChart();
+    }
 
-    if (!addAccount(newAccount, parentNumber)) {
+    bool written = replace ? PersistenceWorker::writeChanges(transactionsFile, true, contents, true, "")
+                           : PersistenceWorker::writeChanges(transactionsFile, true, "", false, contents);
+    if (!written) {
+        // A failed append may have left part of a line behind, so the retry rewrites the whole file
+        cerr << "Warning: Failed to save transactions to " << transactionsFile << endl;
+        rewritePending = true;
+        pendingChanges = changes;
         return false;
     }
+    return writePendingChart();
+}
 
-    // If this account has an initial balance and is not a root account, update all ancestor balances
-    if (balance != 0 && parentNumber != -1) {
-        string currentNum = accStr;
-        while (currentNum.length() > 1) {
-            currentNum = currentNum.substr(0, currentNum.length() - 1);
-            int ancestorNum = stoi(currentNum);
-            NodePtr ancestorNode = findAccount(ancestorNum);
-            if (ancestorNode) {
-                ancestorNode->getData().setBalance(ancestorNode->getData().getBalance() + balance);
-            }
-        }
+/**
+ * @brief Saves the chart to `chartFile` if a balance changed since it was last written and the background write
+ * of the transactions behind it is durable.
+ *
+ * @return bool True if the chart is up to date or still waiting for that write, false if it could not be written;
+ * it then stays pending.
+ */
+bool ForestTree::writePendingChart() {
+    if (!chartPending || chartFile.empty()) {
+        return true;
     }
+    if (persistence && persistence->durableSequence() < chartSequence) {
+        return true;
+    }
+    try {
+        saveToFile(chartFile);
+    } catch (const runtime_error &e) {
+        cerr << "Warning: Failed to save the chart of accounts to " << chartFile << ": " << e.what() << endl;
+        chartWriteFailed = true;
+        return false;
+    }
+    chartPending = false;
+    chartWriteFailed = false;
+    return true;
+}
 
-    // Read all lines from the file
-    vector<string> lines;
-    string line;
-    ifstream inFile(path);
-    if (!inFile) {
-        cerr << "Error opening file for reading" << endl;
+/**
+ * @brief Builds the whole transaction file, re-serializing only dirty accounts.
+ *
+ * @param contents Receives the file contents, in the same account order as `writeTransactions`.
+ *
+ * @return void
+ */
+void ForestTree::serializeTransactions(string &contents) {
+    FOREST_TRACE_SPAN("serialize transactions");
+    for (NodePtr root: rootAccounts) {
+        for (TreeNode &node: levelOrder(root)) {
+            Account &account = node.getData();
+            int accountNumber = account.getAccountNumber();
+            if (account.isDirty()) {
+                if (account.getTransactionCount() == 0) {
+                    transactionBlocks.erase(accountNumber);
+                } else {
+                    string lines;
+                    for (const Transaction &t: account.getTransactions()) {
+                        writeTransactionLine(lines, accountNumber, t);
+                    }
+                    transactionBlocks[accountNumber] = move(lines);
+                }
+                account.clearDirty();
+                FOREST_METRIC_ADD(MetricCounter::AccountsSerialized, 1);
+            }
+
+            unordered_map<int, string>::const_iterator block = transactionBlocks.find(accountNumber);
+            if (block != transactionBlocks.end()) {
+                contents += block->second;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Chooses when changes are written to the transaction file and the chart.
+ *
+ * @param policy The durability mode and its group commit thresholds.
+ *
+ * @return void
+ */
+void ForestTree::setDurabilityPolicy(const DurabilityPolicy &policy) {
+    durability = policy;
+    commitIfDue();
+}
+
+/**
+ * @brief Returns the current durability policy.
+ *
+ * @return const DurabilityPolicy& The policy.
+ */
+const DurabilityPolicy &ForestTree::getDurabilityPolicy() const {
+    return durability;
+}
+
+/**
+ * @brief Writes every pending change to the transaction file and the chart, and waits until it is on disk.
+ *
+ * @return bool True once the changes are durable, false if they could not be written.
+ */
+bool ForestTree::commit() {
+    FOREST_METRIC_TIMER(MetricOp::Commit);
+    FOREST_TRACE_SPAN("commit");
+    if (!writePending() || !waitDurable(getLastChangeSequence())) {
         return false;
     }
+    // The transactions are durable now, so the chart can follow
+    return writePendingChart();
+}
 
-    while (getline(inFile, line)) {
-        lines.push_back(line);
+/**
+ * @brief Writes the pending changes if the durability policy says they are due.
+ *
+ * @return bool False if a write was due and failed, true otherwise.
+ */
+bool ForestTree::commitIfDue() {
+    if (pendingChanges == 0 && !rewritePending && !chartPending) {
+        return true;
     }
-    inFile.close();
+    switch (durability.mode) {
+        case DurabilityMode::EveryOperation:
+            return writePending();
+        case DurabilityMode::GroupCommit:
+            if (pendingChanges >= durability.maxPendingChanges ||
+                chrono::steady_clock::now() - oldestPendingChange >=
+                chrono::milliseconds(durability.maxPendingMillis)) {
+                return writePending();
+            }
+            return true;
+        default:
+            return true;
+    }
+}
 
-    // Find the correct position to insert the new account
-    vector<string>::iterator insertPos = lines.end();
-    string accNumStr = to_string(accountNumber);
-    string parentStr = accStr.length() > 1 ? accStr.substr(0, accStr.length() - 1) : "";
+/**
+ * @brief Checks whether the chart file is behind the balances in memory.
+ *
+ * @return bool True if a balance changed since the chart was last written, for example because saving it failed.
+ */
+bool ForestTree::hasUnsavedChart() const {
+    return chartPending;
+}
 
-    // First, find the parent's position
-    vector<string>::iterator parentPos = lines.begin();
-    for (; parentPos != lines.end(); ++parentPos) {
-        istringstream iss(*parentPos);
-        int currentAccNum;
-        if (iss >> currentAccNum && currentAccNum == parentNumber) {
-            break;
+/**
+ * @brief Checks whether the last attempt to save the chart failed.
+ *
+ * @return bool True until the chart is saved again.
+ */
+bool ForestTree::hasChartWriteFailed() const {
+    return chartWriteFailed;
+}
+
+/**
+ * @brief Returns the number of changes not yet written to the transaction file.
+ *
+ * @return size_t The number of pending changes.
+ */
+size_t ForestTree::getPendingChanges() const {
+    return pendingChanges;
+}
+
+/**
+ * @brief Returns the transaction file the tree keeps in step with its changes.
+ *
+ * @return const string& The file loaded by `buildFromFile`, or the background writer's file once enabled; empty
+ * before either.
+ */
+const string &ForestTree::getTransactionsFile() const {
+    return transactionsFile;
+}
+
+/**
+ * @brief Returns what checking the records of the last loaded chart and transaction files found.
+ *
+ * @return const IntegrityReport& The counts of intact, unchecked and corrupt records, and where the first corrupt one
+ * is.
+ */
+const IntegrityReport &ForestTree::getLoadIntegrity() const {
+    return loadIntegrity;
+}
+
+/**
+ * @brief Moves transaction file writes onto a background I/O thread.
+ *
+ * @param transactionsFile The transaction file to maintain. It should already match the tree, e.g. because it was
+ * just loaded by `buildFromFile`.
+ * @param syncWrites Whether each write is fsynced before it counts as durable.
+ *
+ * @return void
+ *
+ * @details Once enabled, every write the durability policy makes is queued for the I/O thread: postings as appends,
+ * deletions as a full rewrite, and the call returns as soon as the tree is updated. Changes still pending are first
+ * written to the previous file, and any earlier background writer is flushed and replaced.
+ */
+void ForestTree::enableBackgroundPersistence(const string &transactionsFile, bool syncWrites) {
+    commit();
+    persistence.reset();
+    // Sequence numbers start over with the new writer
+    chartSequence = 0;
+    persistence.reset(new PersistenceWorker(transactionsFile, syncWrites));
+    this->transactionsFile = transactionsFile;
+}
+
+/**
+ * @brief Returns the sequence number of the most recent change queued for the background writer.
+ *
+ * @return uint64_t The sequence number, or 0 if background persistence is not enabled.
+ */
+uint64_t ForestTree::getLastChangeSequence() const {
+    return persistence ? persistence->lastSequence() : 0;
+}
+
+/**
+ * @brief Blocks until a queued change, and every change before it, has reached the disk.
+ *
+ * @param sequence A value returned by `getLastChangeSequence`.
+ *
+ * @return bool True once the change is durable (immediately when background persistence is not enabled, since
+ * every change is then written synchronously), false if the background writer failed.
+ */
+bool ForestTree::waitDurable(uint64_t sequence) const {
+    return persistence ? persistence->waitDurable(sequence) : true;
+}
+
+/**
+ * @brief Loads transactions from a file into the tree structure.
+ *
+ * @param filename The name of the file from which transaction data should be loaded.
+ *
+ * @return void
+ *
+ * @details This method reads each transaction from the specified file and attempts to add it to the corresponding account in
+ * the tree. Each line in the file is expected to contain transaction data in the format: account number, transaction ID,
+ * amount, debit/credit, date, and description. If the account number exists in the tree, the transaction is added to that account.
+ * If the account cannot be found, the transaction is skipped. The method handles file reading and transaction parsing,
+ * with error handling for invalid lines. Every record's checksum and every section trailer is verified first; corrupt
+ * records are skipped and counted in `getLoadIntegrity()`, and the next write rewrites the file without them.
+ */
+void ForestTree::loadTransactions(const string &filename) {
+    FOREST_METRIC_TIMER(MetricOp::LoadTransactions);
+    FOREST_TRACE_SPAN("loadTransactions");
+    ifstream file(filename);
+    if (!file) {
+        return; // It's okay if the file doesn't exist yet
+    }
+
+    RecordReader records(file, filename, loadIntegrity);
+    size_t duplicates = 0;
+    string line;
+    while (records.next(line)) {
+        istringstream iss(line);
+        string field;
+        vector<string> fields;
+
+        // Split line by '|'
+        while (getline(iss, field, '|')) {
+            fields.push_back(field);
+        }
+
+        if (fields.size() < 6) continue; // Skip invalid lines
+
+        try {
+            int accountNum = stoi(fields[0]);
+            NodePtr accountNode = findAccount(accountNum);
+            if (!accountNode) continue;
+
+            // Create and add transaction
+            Transaction t(fields[1],                    // ID
+                          stod(fields[2]),               // Amount
+                          fields[3][0],                  // Debit/Credit
+                          fields[5],                     // Description
+                          fields[4]);                    // Date
+            if (!t.isValid()) {
+                // Say which line it was rather than load it with its date blanked
+                cerr << "Error loading transaction: invalid date, amount or type in " << filename << ": " << line
+                     << endl;
+                continue;
+            }
+
+            // A ledger loaded twice, or a posting both appended and kept by a rewrite, must count once
+            if (!transactionIds.insert(t)) {
+                ++duplicates;
+                continue;
+            }
+
+            // Add transaction without updating file
+            accountNode->getData().addTransaction(t);
+            rollupPeriodTotals(accountNode, t, 1);
+            searchIndex.addTransaction(accountNum, t);
+            accountNode->getDigest().transactions += LedgerDigest::hashTransaction(t);
+            refreshDigests(accountNode);
+        } catch (const exception &e) {
+            cerr << "Error loading transaction: " << e.what() << endl;
+            continue;
         }
     }
+    file.close();
 
-    // If we found the parent, start searching from there
-    if (parentPos != lines.end()) {
-        insertPos = parentPos + 1;
-        for (; insertPos != lines.end(); ++insertPos) {
-            istringstream iss(*insertPos);
-            int currentAccNum;
-            if (iss >> currentAccNum) {
-                string currStr = to_string(currentAccNum);
-                if (currStr.length() > parentStr.length() &&
-                    currStr.substr(0, parentStr.length()) == parentStr) {
-                    if (currStr.length() == accNumStr.length() &&
-                        currentAccNum > accountNumber) {
-                        break;
-                    }
-                } else if (currStr.length() <= parentStr.length() ||
-                           currStr.substr(0, parentStr.length()) != parentStr) {
-                    break;
-                }
+    if (duplicates > 0) {
+        cerr << "Warning: " << duplicates << " duplicate transactions skipped in " << filename << endl;
+        FOREST_METRIC_ADD(MetricCounter::DuplicateTransactions, duplicates);
+    }
+    if (!records.intact()) {
+        // Appending after a torn or corrupt line would glue the next record onto it
+        repairPending = true;
+    }
+}
+
+/**
+ * @brief Records a transaction in the period buckets of its account and every ancestor.
+ *
+ * @param accountNode The node of the account that owns the transaction.
+ * @param t The transaction being posted or deleted.
+ * @param sign +1 when the transaction is posted, -1 when it is deleted.
+ *
+ * @return void
+ *
+ * @details Ancestors are found through the same account-number prefixes used for balance propagation, so each
+ * ancestor's buckets always cover its whole subtree.
+ */
+void ForestTree::rollupPeriodTotals(NodePtr accountNode, const Transaction &t, int sign) {
+    accountNode->getData().recordPeriodTotals(t, sign);
+    size_t steps = 0;
+    for (int number = parentAccountNumber(accountNode->getData().getAccountNumber()); number != -1;
+         number = parentAccountNumber(number)) {
+        unordered_map<int, NodePtr>::const_iterator found = accountIndex.find(number);
+        if (found != accountIndex.end()) {
+            found->second->getData().recordPeriodTotals(t, sign);
+            ++steps;
+        }
+    }
+    FOREST_METRIC_ADD(MetricCounter::Rollups, 1);
+    FOREST_METRIC_ADD(MetricCounter::RollupSteps, steps);
+}
+
+/**
+ * @brief Applies a transaction to the balance of an account and of every ancestor, and re-indexes those balances.
+ *
+ * @param accountNode The node of the account that owns the transaction.
+ * @param t The transaction being posted or deleted.
+ * @param sign +1 when the transaction is posted, -1 when it is deleted.
+ *
+ * @return void
+ *
+ * @details The ancestors are reached by dropping digits and looking each number up in the account index, so the walk
+ * allocates nothing and touches only the nodes whose balance changes.
+ */
+void ForestTree::rollupBalances(NodePtr accountNode, const Transaction &t, int sign) {
+    double delta = sign * t.getSignedCents() / 100.0;
+    Account &account = accountNode->getData();
+    account.setBalance(account.getBalance() + delta);
+    balanceIndex.update(account.getAccountNumber(), account.getBalance());
+    for (int number = parentAccountNumber(account.getAccountNumber()); number != -1;
+         number = parentAccountNumber(number)) {
+        unordered_map<int, NodePtr>::const_iterator found = accountIndex.find(number);
+        if (found != accountIndex.end()) {
+            Account &ancestor = found->second->getData();
+            ancestor.setBalance(ancestor.getBalance() + delta);
+            balanceIndex.update(number, ancestor.getBalance());
+        }
+    }
+}
+
+/**
+ * @brief Returns the number of an account's parent, which is the account number without its last digit.
+ *
+ * @param accountNumber The account number.
+ *
+ * @return int The parent account number, or -1 for a single-digit (root) account.
+ */
+int ForestTree::parentAccountNumber(int accountNumber) {
+    return accountNumber >= 10 ? accountNumber / 10 : -1;
+}
+
+/**
+ * @brief Registers a newly linked node in the account, balance and search indexes.
+ *
+ * @param node The new node.
+ *
+ * @return void
+ */
+void ForestTree::indexAccount(NodePtr node) {
+    const Account &account = node->getData();
+    accountIndex[account.getAccountNumber()] = node;
+    balanceIndex.update(account.getAccountNumber(), account.getBalance());
+    searchIndex.addAccount(account.getAccountNumber(), account.getDescription());
+
+    SubtreeDigest &digest = node->getDigest();
+    for (const Transaction &t: account.getTransactions()) {
+        digest.transactions += LedgerDigest::hashTransaction(t);
+        transactionIds.insert(t);
+    }
+    refreshDigests(node);
+}
+
+/**
+ * @brief Returns the metrics registry.
+ *
+ * @return const ForestMetrics& The process-wide counters and latency histograms.
+ */
+const ForestMetrics &ForestTree::getMetrics() const {
+    return ForestMetrics::global();
+}
+
+/**
+ * @brief Writes the current metrics to a file in Prometheus text format.
+ *
+ * @param filename The file to write, e.g. a path scraped by the node exporter's textfile collector.
+ *
+ * @return void
+ *
+ * @throws runtime_error If the file cannot be opened.
+ */
+void ForestTree::dumpMetrics(const string &filename) const {
+    ForestMetrics::global().writePrometheus(filename);
+}
+
+/**
+ * @brief Returns the description search index.
+ *
+ * @return const SearchIndex& The index, kept up to date as accounts and transactions are added and deleted.
+ */
+const SearchIndex &ForestTree::getSearchIndex() const {
+    return searchIndex;
+}
+
+/**
+ * @brief Returns the order-statistic index of account balances.
+ *
+ * @return const BalanceIndex& The index, kept up to date with every balance change made through the forest.
+ */
+const BalanceIndex &ForestTree::getBalanceIndex() const {
+    return balanceIndex;
+}
+
+/**
+ * @brief Returns the debit and credit totals of an account's subtree over a range of days.
+ *
+ * @param accountNumber The account at the top of the subtree.
+ * @param fromDate The first day of the period, in `DD-MM-YY` form.
+ * @param toDate The last day of the period, in `DD-MM-YY` form.
+ *
+ * @return PeriodTotals The totals over the period, or all zeros if the account does not exist.
+ *
+ * @throws invalid_argument If either date cannot be parsed.
+ */
+PeriodTotals ForestTree::getPeriodTotals(int accountNumber, const string &fromDate, const string &toDate) const {
+    FOREST_METRIC_TIMER(MetricOp::PeriodTotals);
+    // An unparseable date has day key 0, which would quietly widen the period to the start of the ledger
+    int fromDayKey = Transaction::toDayKey(fromDate);
+    int toDayKey = Transaction::toDayKey(toDate);
+    if (fromDayKey == 0 || toDayKey == 0) {
+        throw invalid_argument("Invalid date: " + (fromDayKey == 0 ? fromDate : toDate));
+    }
+    NodePtr accountNode = findAccount(accountNumber);
+    if (!accountNode) {
+        return PeriodTotals();
+    }
+    return accountNode->getData().getTotalsBetween(fromDayKey, toDayKey);
+}
+
+/**
+ * @brief Returns the debit and credit totals of an account's subtree for one calendar month.
+ *
+ * @param accountNumber The account at the top of the subtree.
+ * @param year The four-digit year.
+ * @param month The month (1-12).
+ *
+ * @return PeriodTotals The totals for the month, or all zeros if the account does not exist.
+ */
+PeriodTotals ForestTree::getMonthlyTotals(int accountNumber, int year, int month) const {
+    FOREST_METRIC_TIMER(MetricOp::PeriodTotals);
+    NodePtr accountNode = findAccount(accountNumber);
+    if (!accountNode) {
+        return PeriodTotals();
+    }
+    return accountNode->getData().getMonthlyTotals(year * 100 + month);
+}
+
+/**
+ * @brief Returns the direct children of a node, in sibling order.
+ *
+ * @param node The parent node.
+ *
+ * @return vector<NodePtr> The children of the node.
+ */
+vector<NodePtr> ForestTree::getChildren(NodePtr node) {
+    vector<NodePtr> children;
+    for (NodePtr child = node->getLeftChild(); child; child = child->getRightSibling()) {
+        children.push_back(child);
+    }
+    return children;
+}
+
+/**
+ * @brief Accounts plus transactions below which a walk is cheaper on the calling thread than handed to the pool.
+ */
+static const size_t PARALLEL_MIN_WORK = 4096;
+
+/**
+ * @brief Checks whether the subtrees of a list of nodes hold too little to be worth splitting across threads.
+ *
+ * @param nodes The subtree roots.
+ *
+ * @return bool True if they hold fewer than `PARALLEL_MIN_WORK` accounts and transactions in total.
+ *
+ * @details The count stops as soon as the limit is reached, so a large forest costs only a few thousand steps.
+ */
+bool ForestTree::isSmallWork(const vector<NodePtr> &nodes) {
+    size_t work = 0;
+    for (NodePtr node: nodes) {
+        for (const TreeNode &descendant: preOrder(node)) {
+            work += 1 + descendant.getData().getTransactionCount();
+            if (work >= PARALLEL_MIN_WORK) {
+                return false;
             }
         }
-    } else {
-        for (insertPos = lines.begin(); insertPos != lines.end(); ++insertPos) {
-            istringstream iss(*insertPos);
-            int currentAccNum;
-            if (iss >> currentAccNum) {
-                string currStr = to_string(currentAccNum);
-                if (currStr[0] > accNumStr[0] ||
-                    (currStr[0] == accNumStr[0] && currentAccNum > accountNumber)) {
-                    break;
-                }
+    }
+    return true;
+}
+
+/**
+ * @brief Runs a task for each node in a list, spread over the shared worker pool.
+ *
+ * @param nodes The nodes to process, typically the children of a subtree root.
+ * @param work The task, called with the index of the node in `nodes` and the node itself.
+ *
+ * @return void
+ *
+ * @details The calling thread works alongside the pool's fixed set of helpers, each taking chunks of nodes, so the
+ * thread count does not grow with the number of children. Small subtrees are processed on the calling thread alone.
+ */
+void ForestTree::runInParallel(const vector<NodePtr> &nodes, const function<void(size_t, NodePtr)> &work) {
+    if (nodes.size() <= 1 || isSmallWork(nodes)) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            work(i, nodes[i]);
+        }
+        return;
+    }
+    WorkerPool::parallelFor(nodes.size(), [&nodes, &work](size_t i) { work(i, nodes[i]); });
+}
+
+/**
+ * @brief Runs a task for each node in a list on the worker pool, handing each result over in list order.
+ *
+ * @param nodes The nodes to process, typically the children of a subtree root.
+ * @param work The task, called with the index of the node in `nodes` and the node itself.
+ * @param deliver Called on the calling thread with each index, once its task and every earlier one are done.
+ * Returns false to stop starting further tasks.
+ *
+ * @return bool True if every result was delivered, false if `deliver` stopped early.
+ *
+ * @details Small subtrees are processed on the calling thread alone, each result delivered before the next task.
+ */
+bool ForestTree::runInOrder(const vector<NodePtr> &nodes, const function<void(size_t, NodePtr)> &work,
+                            const function<bool(size_t)> &deliver) {
+    if (nodes.size() <= 1 || isSmallWork(nodes)) {
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            work(i, nodes[i]);
+            if (!deliver(i)) {
+                return false;
             }
         }
+        return true;
     }
+    return WorkerPool::parallelForOrdered(nodes.size(), [&nodes, &work](size_t i) { work(i, nodes[i]); }, deliver);
+}
 
-    // Update all balances in the lines based on the tree's current state
-    for (auto &line: lines) {
-        istringstream iss(line);
-        int lineAccNum;
-        if (iss >> lineAccNum) {
-            NodePtr accNode = findAccount(lineAccNum);
-            if (accNode) {
-                string word;
-                vector<string> words;
-                while (iss >> word) {
-                    words.push_back(word);
+/**
+ * @brief Largest difference between a stored and a computed balance that `audit` still accepts. Balances are kept
+ * to the cent in the chart file, so anything under half a cent is rounding.
+ */
+static const double BALANCE_TOLERANCE = 0.005;
+
+/**
+ * @brief Recomputes the balances of a subtree bottom-up, in one post-order pass.
+ *
+ * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+ * @param repair Whether to overwrite each mismatched balance with the computed one.
+ * @param report Receives the number of accounts checked and the mismatches, in chart order.
+ *
+ * @return void
+ *
+ * @details The walk uses an explicit stack of frames, each summing its node's transactions and then its children's
+ * totals as they complete, so every account and every transaction is visited exactly once.
+ */
+void ForestTree::auditSubtree(NodePtr subtree, bool repair, AuditReport &report) {
+    struct Frame {
+        NodePtr node;       // The account being totalled
+        NodePtr nextChild;  // The next child to descend into, or null once every child is done
+        int64_t total;      // Own transactions plus the children finished so far, in cents
+        size_t order;       // Position of the account in pre-order, so mismatches come out in chart order
+    };
+
+    vector<pair<size_t, BalanceMismatch>> found;
+    size_t visited = 0;
+
+    auto open = [&visited](NodePtr node) {
+        return Frame{node, node->getLeftChild(), node->getData().getNetCents(), visited++};
+    };
+
+    vector<Frame> stack;
+    stack.push_back(open(subtree));
+    while (!stack.empty()) {
+        if (stack.back().nextChild) {
+            NodePtr child = stack.back().nextChild;
+            stack.back().nextChild = child->getRightSibling();
+            stack.push_back(open(child));
+            continue;
+        }
+
+        // Every child is done: the account's total is final
+        Frame done = stack.back();
+        stack.pop_back();
+        Account &account = done.node->getData();
+        double computed = static_cast<double>(done.total) / 100.0;
+        if (fabs(account.getBalance() - computed) > BALANCE_TOLERANCE) {
+            found.push_back(make_pair(done.order, BalanceMismatch{account.getAccountNumber(), account.getBalance(),
+                                                                  computed}));
+            if (repair) {
+                account.setBalance(computed);
+            }
+        }
+        if (!stack.empty()) {
+            stack.back().total += done.total;
+        }
+    }
+
+    sort(found.begin(), found.end(), [](const pair<size_t, BalanceMismatch> &a,
+                                        const pair<size_t, BalanceMismatch> &b) { return a.first < b.first; });
+    report.accountsChecked += visited;
+    for (const pair<size_t, BalanceMismatch> &mismatch: found) {
+        report.mismatches.push_back(mismatch.second);
+    }
+}
+
+/**
+ * @brief Runs `auditSubtree` over every root subtree in parallel and merges the reports in chart order.
+ *
+ * @param roots The root accounts.
+ * @param repair Whether to overwrite each mismatched balance with the computed one.
+ *
+ * @return AuditReport The merged report.
+ */
+AuditReport ForestTree::auditForest(const vector<NodePtr> &roots, bool repair) {
+    vector<NodePtr> sortedRoots = roots;
+    sort(sortedRoots.begin(), sortedRoots.end(), [](NodePtr a, NodePtr b) {
+        return a->getData().getAccountNumber() < b->getData().getAccountNumber();
+    });
+
+    // Root subtrees share no nodes, so they are audited (and repaired) in parallel
+    vector<AuditReport> partial(sortedRoots.size());
+    if (!sortedRoots.empty()) {
+        runInParallel(sortedRoots, [&partial, repair](size_t i, NodePtr root) {
+            auditSubtree(root, repair, partial[i]);
+        });
+    }
+
+    AuditReport report;
+    for (const AuditReport &part: partial) {
+        report.accountsChecked += part.accountsChecked;
+        report.mismatches.insert(report.mismatches.end(), part.mismatches.begin(), part.mismatches.end());
+    }
+    return report;
+}
+
+/**
+ * @brief Recomputes every balance from the transactions and reports the accounts that disagree.
+ *
+ * @return AuditReport The number of accounts checked and every mismatch, in chart order.
+ */
+AuditReport ForestTree::audit() const {
+    FOREST_METRIC_TIMER(MetricOp::Audit);
+    FOREST_TRACE_SPAN("audit");
+    return auditForest(rootAccounts, false);
+}
+
+/**
+ * @brief Resets every balance to the value its transactions add up to.
+ *
+ * @return AuditReport The accounts that were corrected, with their old and new balances.
+ *
+ * @details The balance index is brought up to date afterwards, on the calling thread.
+ */
+AuditReport ForestTree::rebuildBalances() {
+    FOREST_METRIC_TIMER(MetricOp::RebuildBalances);
+    FOREST_TRACE_SPAN("rebuildBalances");
+    AuditReport report = auditForest(rootAccounts, true);
+    for (const BalanceMismatch &mismatch: report.mismatches) {
+        balanceIndex.update(mismatch.accountNumber, mismatch.computed);
+        refreshDigests(findAccount(mismatch.accountNumber));
+    }
+    return report;
+}
+
+/**
+ * @brief Returns a digest of the whole ledger: every account, balance and transaction.
+ *
+ * @return uint64_t The fingerprint. Two forests with the same fingerprint hold the same ledger.
+ *
+ * @details The roots are summed, so the fingerprint does not depend on the order the roots were added in.
+ */
+uint64_t ForestTree::fingerprint() const {
+    uint64_t roots = 0;
+    for (const NodePtr &root: rootAccounts) {
+        roots += root->getDigest().subtree;
+    }
+    return LedgerDigest::combine(0, roots);
+}
+
+/**
+ * @brief Returns the Merkle digest of one account's subtree.
+ *
+ * @param accountNumber The account at the top of the subtree.
+ *
+ * @return uint64_t The digest, or 0 if the account does not exist.
+ */
+uint64_t ForestTree::getSubtreeDigest(int accountNumber) const {
+    NodePtr node = findAccount(accountNumber);
+    return node ? node->getDigest().subtree : 0;
+}
+
+/**
+ * @brief Lists the accounts that differ between this forest and another.
+ *
+ * @param other The forest to compare against.
+ *
+ * @return vector<LedgerDifference> The differing accounts, each parent before its children.
+ *
+ * @details Pairs with equal subtree digests are skipped whole. The walk uses an explicit stack, so deep charts do
+ * not grow the call stack.
+ */
+vector<LedgerDifference> ForestTree::diff(const ForestTree &other) const {
+    FOREST_METRIC_TIMER(MetricOp::Diff);
+    FOREST_TRACE_SPAN("diff");
+    vector<LedgerDifference> differences;
+
+    // Children are kept in account number order, the roots only in insertion order
+    auto byNumber = [](const NodePtr &a, const NodePtr &b) {
+        return a->getData().getAccountNumber() < b->getData().getAccountNumber();
+    };
+    vector<NodePtr> here = rootAccounts;
+    vector<NodePtr> there = other.rootAccounts;
+    sort(here.begin(), here.end(), byNumber);
+    sort(there.begin(), there.end(), byNumber);
+
+    vector<pair<NodePtr, NodePtr>> differing;
+    matchSiblings(here, there, differences, differing);
+    vector<pair<NodePtr, NodePtr>> stack(differing.rbegin(), differing.rend());
+
+    while (!stack.empty()) {
+        pair<NodePtr, NodePtr> current = stack.back();
+        stack.pop_back();
+
+        if (current.first->getDigest().own != current.second->getDigest().own) {
+            differences.push_back({current.first->getData().getAccountNumber(), LedgerDifference::Changed});
+        }
+        if (current.first->getDigest().children == current.second->getDigest().children) {
+            continue;
+        }
+
+        differing.clear();
+        matchSiblings(getChildren(current.first), getChildren(current.second), differences, differing);
+        // Push in reverse so the lowest-numbered child is visited first
+        stack.insert(stack.end(), differing.rbegin(), differing.rend());
+    }
+    return differences;
+}
+
+/**
+ * @brief Recomputes a node's digest after its account changed, then carries the change up to the root.
+ *
+ * @param node The node whose fields, transactions or children changed.
+ *
+ * @return void
+ *
+ * @details A parent's child digest is a sum, so each level only swaps the child's old subtree digest for the new one.
+ */
+void ForestTree::refreshDigests(NodePtr node) {
+    SubtreeDigest &digest = node->getDigest();
+    uint64_t previous = digest.subtree;
+    digest.own = LedgerDigest::hashAccount(node->getData(), digest.transactions);
+    digest.subtree = LedgerDigest::combine(digest.own, digest.children);
+    uint64_t current = digest.subtree;
+
+    for (int number = parentAccountNumber(node->getData().getAccountNumber()); number != -1;
+         number = parentAccountNumber(number)) {
+        NodePtr ancestor = findAccount(number);
+        if (!ancestor) {
+            continue;
+        }
+        SubtreeDigest &above = ancestor->getDigest();
+        above.children += current - previous;
+        above.own = LedgerDigest::hashAccount(ancestor->getData(), above.transactions);
+        previous = above.subtree;
+        above.subtree = LedgerDigest::combine(above.own, above.children);
+        current = above.subtree;
+    }
+}
+
+/**
+ * @brief Pairs up two sorted lists of sibling nodes by account number for `diff`.
+ *
+ * @param here Nodes of this forest, in account number order.
+ * @param there Nodes of the other forest, in account number order.
+ * @param differences Receives the accounts found on one side only.
+ * @param differing Receives the pairs present on both sides whose subtree digests differ.
+ *
+ * @return void
+ */
+void ForestTree::matchSiblings(const vector<NodePtr> &here, const vector<NodePtr> &there,
+                               vector<LedgerDifference> &differences, vector<pair<NodePtr, NodePtr>> &differing) {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < here.size() || j < there.size()) {
+        int hereNumber = i < here.size() ? here[i]->getData().getAccountNumber() : INT_MAX;
+        int thereNumber = j < there.size() ? there[j]->getData().getAccountNumber() : INT_MAX;
+        if (j == there.size() || (i < here.size() && hereNumber < thereNumber)) {
+            differences.push_back({hereNumber, LedgerDifference::OnlyHere});
+            ++i;
+        } else if (i == here.size() || thereNumber < hereNumber) {
+            differences.push_back({thereNumber, LedgerDifference::OnlyThere});
+            ++j;
+        } else {
+            if (here[i]->getDigest().subtree != there[j]->getDigest().subtree) {
+                differing.emplace_back(here[i], there[j]);
+            }
+            ++i;
+            ++j;
+        }
+    }
+}
+
+/**
+ * @brief Collects the matching transactions of a node and all of its descendants.
+ *
+ * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+ * @param filter The query filters.
+ * @param out Receives the matching (account, transaction) pairs in pre-order.
+ * @param stopped Checked before each account; once set, the walk gives up.
+ *
+ * @return void
+ *
+ * @details The walk is iterative, so deep charts and long sibling lists do not grow the call stack.
+ */
+void ForestTree::collectMatches(NodePtr subtree, const TransactionQuery &filter,
+                                vector<pair<const Account *, const Transaction *>> &out, const atomic<bool> &stopped) {
+    for (const TreeNode &node: preOrder(subtree)) {
+        if (stopped.load(memory_order_relaxed)) {
+            return;
+        }
+        const Account &account = node.getData();
+        if (filter.mayMatch(account)) {
+            for (const Transaction &t: account.getTransactions()) {
+                if (filter.matches(t)) {
+                    out.emplace_back(&account, &t);
                 }
-                if (!words.empty()) {
-                    words.pop_back(); // Remove old balance
-                    ostringstream newLine;
-                    newLine << lineAccNum;
-                    for (const auto &w: words) {
-                        newLine << " " << w;
-                    }
-                    newLine << " " << fixed << setprecision(2) << accNode->getData().getBalance();
-                    line = newLine.str();
+            }
+        }
+    }
+}
+
+/**
+ * @brief Streams every transaction in a subtree that matches a query.
+ *
+ * @param subtreeRoot The account at the top of the subtree to search.
+ * @param filter The date, amount, type and description filters to apply.
+ * @param callback Invoked once per matching transaction, on the calling thread. Returning false stops the query.
+ *
+ * @return size_t The number of matching transactions delivered.
+ */
+size_t ForestTree::query(int subtreeRoot, const TransactionQuery &filter, const TransactionCallback &callback) const {
+    FOREST_METRIC_TIMER(MetricOp::Query);
+    NodePtr rootNode = findAccount(subtreeRoot);
+    if (!rootNode) {
+        return 0;
+    }
+
+    typedef vector<pair<const Account *, const Transaction *>> MatchList;
+
+    // The subtree root's own transactions are checked and delivered inline
+    size_t count = 0;
+    const Account &rootAccount = rootNode->getData();
+    if (filter.mayMatch(rootAccount)) {
+        for (const Transaction &t: rootAccount.getTransactions()) {
+            if (filter.matches(t)) {
+                ++count;
+                if (!callback(rootAccount, t)) {
+                    return count;
                 }
             }
         }
     }
 
-    // Create and insert the new line
-    ostringstream newLine;
-    newLine << accountNumber << " " << description << " " << fixed << setprecision(2) << balance;
-    lines.insert(insertPos, newLine.str());
+    // Each child subtree is searched in parallel; its matches are delivered in chart order on the calling thread as
+    // soon as it and every child before it are done, then released
+    vector<NodePtr> children = getChildren(rootNode);
+    vector<MatchList> childMatches(children.size());
+    atomic<bool> stopped(false);
+    runInOrder(children, [&](size_t i, NodePtr child) {
+        collectMatches(child, filter, childMatches[i], stopped);
+    }, [&](size_t i) {
+        for (const auto &match: childMatches[i]) {
+            ++count;
+            if (!callback(*match.first, *match.second)) {
+                stopped = true;
+                return false;
+            }
+        }
+        MatchList().swap(childMatches[i]);
+        return true;
+    });
+    return count;
+}
 
-    // Write all lines back to the file
-    ofstream outFile(path);
-    if (!outFile) {
-        cerr << "Error opening file for writing" << endl;
-        return false;
+/**
+ * @brief Orders top-K candidates so that the heap top is the weakest entry kept so far.
+ */
+struct TopCandidateGreater {
+    template<typename Candidate>
+    bool operator()(const Candidate &a, const Candidate &b) const {
+        return a.first > b.first;
+    }
+};
+
+/**
+ * @brief Offers the transactions of one account to a bounded top-K min-heap.
+ *
+ * @param account The account whose transactions are offered.
+ * @param k The number of transactions to keep.
+ * @param filter The query filters.
+ * @param heap The bounded min-heap (ordered by amount) receiving the candidates.
+ *
+ * @return void
+ *
+ * @details Once the heap is full, an account whose largest amount cannot beat the current minimum is skipped using
+ * its max-amount summary.
+ */
+void ForestTree::offerTopTransactions(const Account &account, size_t k, const TransactionQuery &filter,
+                                      vector<TransactionCandidate> &heap) {
+    if (!filter.mayMatch(account) || (heap.size() >= k && account.getMaxAmount() <= heap.front().first)) {
+        return;
     }
 
-    for (const string &l: lines) {
-        outFile << l << endl;
+    for (const Transaction &t: account.getTransactions()) {
+        if (!filter.matches(t)) {
+            continue;
+        }
+        if (heap.size() < k) {
+            heap.emplace_back(t.getAmount(), make_pair(&account, &t));
+            push_heap(heap.begin(), heap.end(), TopCandidateGreater());
+        } else if (t.getAmount() > heap.front().first) {
+            pop_heap(heap.begin(), heap.end(), TopCandidateGreater());
+            heap.back() = make_pair(t.getAmount(), make_pair(&account, &t));
+            push_heap(heap.begin(), heap.end(), TopCandidateGreater());
+        }
     }
-    outFile.close();
-    return true;
+}
+
+/**
+ * @brief Keeps the K largest transactions of a subtree in a bounded min-heap.
+ *
+ * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+ * @param k The number of transactions to keep.
+ * @param filter The query filters.
+ * @param heap The bounded min-heap (ordered by amount) receiving the candidates.
+ *
+ * @return void
+ */
+void ForestTree::collectTopTransactions(NodePtr subtree, size_t k, const TransactionQuery &filter,
+                                        vector<TransactionCandidate> &heap) {
+    for (const TreeNode &node: preOrder(subtree)) {
+        offerTopTransactions(node.getData(), k, filter, heap);
+    }
+}
+
+/**
+ * @brief Keeps the K accounts with the largest absolute balance in a subtree in a bounded min-heap.
+ *
+ * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+ * @param k The number of accounts to keep.
+ * @param leavesOnly Whether to skip accounts that have children.
+ * @param heap The bounded min-heap (ordered by absolute balance) receiving the candidates.
+ *
+ * @return void
+ */
+void ForestTree::collectTopAccounts(NodePtr subtree, size_t k, bool leavesOnly, vector<AccountCandidate> &heap) {
+    for (TreeNode &node: preOrder(subtree)) {
+        if (leavesOnly && node.getLeftChild()) {
+            continue;
+        }
+        double key = fabs(node.getData().getBalance());
+        if (heap.size() < k) {
+            heap.emplace_back(key, &node);
+            push_heap(heap.begin(), heap.end(), TopCandidateGreater());
+        } else if (key > heap.front().first) {
+            pop_heap(heap.begin(), heap.end(), TopCandidateGreater());
+            heap.back() = make_pair(key, &node);
+            push_heap(heap.begin(), heap.end(), TopCandidateGreater());
+        }
+    }
+}
+
+/**
+ * @brief Returns the K largest transactions in a subtree.
+ *
+ * @param subtreeRoot The account at the top of the subtree.
+ * @param k The maximum number of transactions to return.
+ * @param filter Optional filters, e.g. a date range for "this month".
+ *
+ * @return vector<TransactionHit> The transactions, largest amount first.
+ */
+vector<TransactionHit> ForestTree::topTransactions(int subtreeRoot, size_t k, const TransactionQuery &filter) const {
+    FOREST_METRIC_TIMER(MetricOp::TopTransactions);
+    vector<TransactionHit> result;
+    NodePtr rootNode = findAccount(subtreeRoot);
+    if (!rootNode || k == 0) {
+        return result;
+    }
+
+    // One bounded heap for the root's own transactions, one per child subtree
+    vector<NodePtr> children = getChildren(rootNode);
+    vector<vector<TransactionCandidate>> heaps(children.size() + 1);
+    offerTopTransactions(rootNode->getData(), k, filter, heaps[0]);
+    runInParallel(children, [&](size_t i, NodePtr child) {
+        collectTopTransactions(child, k, filter, heaps[i + 1]);
+    });
+
+    // Merge the partial heaps
+    vector<TransactionCandidate> merged;
+    for (const vector<TransactionCandidate> &heap: heaps) {
+        merged.insert(merged.end(), heap.begin(), heap.end());
+    }
+    size_t count = min(k, merged.size());
+    partial_sort(merged.begin(), merged.begin() + count, merged.end(),
+                 [](const TransactionCandidate &a, const TransactionCandidate &b) { return a.first > b.first; });
+
+    for (size_t i = 0; i < count; ++i) {
+        const Transaction &t = *merged[i].second.second;
+        result.push_back({merged[i].second.first->getAccountNumber(), t.getTransactionID(), t.getAmountCents(),
+                          t.getDebitCredit(), t.getDate(), string(t.getDescription())});
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the K accounts with the largest absolute balance below a subtree root.
+ *
+ * @param subtreeRoot The account at the top of the subtree. It is not itself ranked.
+ * @param k The maximum number of accounts to return.
+ * @param leavesOnly Whether to rank only accounts without children.
+ *
+ * @return vector<NodePtr> The account nodes, largest absolute balance first.
+ */
+vector<NodePtr> ForestTree::topAccountsByBalance(int subtreeRoot, size_t k, bool leavesOnly) const {
+    FOREST_METRIC_TIMER(MetricOp::TopAccounts);
+    vector<NodePtr> result;
+    NodePtr rootNode = findAccount(subtreeRoot);
+    if (!rootNode || k == 0) {
+        return result;
+    }
+
+    vector<NodePtr> children = getChildren(rootNode);
+    vector<vector<AccountCandidate>> heaps(children.size());
+    runInParallel(children, [&](size_t i, NodePtr child) {
+        collectTopAccounts(child, k, leavesOnly, heaps[i]);
+    });
+
+    vector<AccountCandidate> merged;
+    for (const vector<AccountCandidate> &heap: heaps) {
+        merged.insert(merged.end(), heap.begin(), heap.end());
+    }
+    size_t count = min(k, merged.size());
+    partial_sort(merged.begin(), merged.begin() + count, merged.end(),
+                 [](const AccountCandidate &a, const AccountCandidate &b) { return a.first > b.first; });
+
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(merged[i].second);
+    }
+    return result;
+}
+
+/**
+ * @brief Generates a transaction filename based on the provided accounts file name.
+ *
+ * @param accountsFile The name of the accounts file.
+ *
+ * @return string The generated transaction file name, which appends "_transactions.txt" to the accounts file name.
+ *
+ * @details This method takes the provided accounts file name and creates a corresponding transaction file name by
+ * removing the file extension and appending "_transactions.txt". This helps to link the transaction file with the
+ * respective accounts file in a consistent manner.
+ */
+string ForestTree::getTransactionFilename(const string &accountsFile) const {
+    return accountsFile.substr(0, accountsFile.find_last_of('.')) + "_transactions.txt";
+}
+
+/**
+ * @brief Adds a new account to both the tree structure and the file.
+ *
+ * @param accountNumber The account number
+ * @param description The account description
+ * @param balance The initial balance, posted as an opening entry
+ * @param path The chart of accounts file to rewrite
+ * @return bool Returns true if the account was added, false otherwise. Whether the chart could be saved is reported
+ * on stderr and by `hasChartWriteFailed`.
+ */
+bool ForestTree::addAccountWithFile(int accountNumber, const string &description, double balance, string path) {
+    FOREST_METRIC_TIMER(MetricOp::AddAccountWithFile);
+    vector<Account> batch(1);
+    batch[0].setAccountNumber(accountNumber);
+    batch[0].setDescription(description);
+    batch[0].setBalance(balance);  // Posted as an opening entry by addAccounts
+
+    return addAccounts(move(batch), path)[0];
 }
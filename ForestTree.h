@@ -8,12 +8,113 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <atomic>
 #include "TreeNode.h"
 #include "Account.h"
 #include "Transaction.h"
+#include "TransactionQuery.h"
+#include "BalanceIndex.h"
+#include "SearchIndex.h"
+#include "TransactionIdIndex.h"
+#include "ForestMetrics.h"
+#include "ForestTrace.h"
+#include "PersistenceWorker.h"
+#include "RecordChecksum.h"
 
 using namespace std;
 
+/**
+ * @brief Callback receiving each transaction matched by `ForestTree::query`, together with its owning account.
+ * Returns false to stop the query.
+ */
+typedef function<bool(const Account &, const Transaction &)> TransactionCallback;
+
+/**
+ * @brief A posting for `ForestTree::postTransactions`: the account number and the transaction to post to it.
+ */
+typedef pair<int, Transaction> Posting;
+
+/**
+ * @brief When the changes made to a `ForestTree` are written to its transaction file and its chart.
+ */
+enum class DurabilityMode {
+    EveryOperation,  ///< Write each change before the call that made it returns
+    GroupCommit,     ///< Write pending changes together once enough have accumulated or the oldest is old enough
+    Manual           ///< Write only on `ForestTree::commit()`, and when the tree is destroyed
+};
+
+/**
+ * @struct DurabilityPolicy
+ * @brief A durability mode and its group commit thresholds.
+ *
+ * Under `GroupCommit`, a crash loses at most the changes made since the last write: fewer than
+ * `maxPendingChanges` changes, made within the last `maxPendingMillis` milliseconds of activity.
+ */
+struct DurabilityPolicy {
+    DurabilityMode mode = DurabilityMode::EveryOperation; ///< When changes are written
+    size_t maxPendingChanges = 1024;    ///< GroupCommit: write once this many changes are pending
+    unsigned maxPendingMillis = 200;    ///< GroupCommit: write once the oldest pending change is this old
+};
+
+/**
+ * @struct BalanceMismatch
+ * @brief An account whose stored balance differs from the balance its ledger adds up to.
+ */
+struct BalanceMismatch {
+    int accountNumber;  ///< The account
+    double stored;      ///< The balance held in the tree (as loaded or posted)
+    double computed;    ///< Its own transactions plus the computed balances of its children
+};
+
+/**
+ * @struct AuditReport
+ * @brief The result of `ForestTree::audit` or `ForestTree::rebuildBalances`.
+ */
+struct AuditReport {
+    size_t accountsChecked = 0;         ///< Accounts whose balance was recomputed
+    vector<BalanceMismatch> mismatches; ///< Accounts found out of step, in chart order
+
+    /**
+     * @brief Checks whether every balance matched its ledger.
+     *
+     * @return True if no mismatch was found
+     */
+    bool clean() const { return mismatches.empty(); }
+};
+
+/**
+ * @struct LedgerDifference
+ * @brief One account that differs between two forests, as found by `ForestTree::diff`.
+ */
+struct LedgerDifference {
+    /**
+     * @brief How the account differs.
+     */
+    enum Kind {
+        OnlyHere,   ///< The account (and its whole subtree) exists only in this forest
+        OnlyThere,  ///< The account (and its whole subtree) exists only in the other forest
+        Changed     ///< The account exists in both, but its description, balance or transactions differ
+    };
+
+    int accountNumber;  ///< The account
+    Kind kind;          ///< How it differs
+};
+
+/**
+ * @brief A top-K transaction candidate: the amount used for ranking, and the (account, transaction) it refers to.
+ */
+typedef pair<double, pair<const Account *, const Transaction *>> TransactionCandidate;
+
+/**
+ * @brief A top-K account candidate: the absolute balance used for ranking, and the node it refers to.
+ */
+typedef pair<double, NodePtr> AccountCandidate;
+
 /**
  * @class ForestTree
  * @brief Represents a forest tree data structure for managing accounts and transactions.
@@ -33,6 +134,108 @@ private:
      */
     vector<NodePtr> rootAccounts;
 
+    /**
+     * @brief Every node in the forest by account number.
+     *
+     * @details Lets `findAccount`, parent lookups and ancestor walks run in constant time per account instead of
+     * scanning the forest. Maintained by `addAccount` and `addAccounts`, and cleared with the tree.
+     */
+    unordered_map<int, NodePtr> accountIndex;
+
+    /**
+     * @brief Order-statistic index of every account balance in the forest.
+     *
+     * @details Updated whenever an account is added or a posting changes the balance of an account and its
+     * ancestors, so balance range, count and rank queries never walk the tree.
+     */
+    BalanceIndex balanceIndex;
+
+    /**
+     * @brief Trigram index over every account and transaction description in the forest.
+     */
+    SearchIndex searchIndex;
+
+    /**
+     * @brief Every transaction ID in the forest, so a transaction posted or loaded twice is dropped.
+     */
+    TransactionIdIndex transactionIds;
+
+    /**
+     * @brief Background writer of the transaction file, or null while saves are synchronous.
+     */
+    unique_ptr<PersistenceWorker> persistence;
+
+    /**
+     * @brief The transaction file kept in step with the tree: the one `buildFromFile` loaded, or the background
+     * writer's file once it is enabled. Empty until then, and nothing is written.
+     */
+    string transactionsFile;
+
+    /**
+     * @brief The chart of accounts file `buildFromFile` loaded, rewritten with the balances whenever pending changes
+     * are written. Empty until a chart is loaded.
+     */
+    string chartFile;
+
+    /**
+     * @brief When changes are written to `transactionsFile` and `chartFile`.
+     */
+    DurabilityPolicy durability;
+
+    /**
+     * @brief Lines posted since the last write, while they can still be written as an append.
+     */
+    string pendingAppends;
+
+    /**
+     * @brief Whether a change since the last write (such as a deletion) needs the whole file rewritten.
+     */
+    bool rewritePending;
+
+    /**
+     * @brief Whether a balance changed since `chartFile` was last written.
+     */
+    bool chartPending;
+
+    /**
+     * @brief Whether the last attempt to save `chartFile` failed.
+     */
+    bool chartWriteFailed;
+
+    /**
+     * @brief The background write the pending chart's balances depend on; the chart waits until it is durable.
+     */
+    uint64_t chartSequence;
+
+    /**
+     * @brief Whether the loaded transaction file held corrupt records or ended mid-line, so the next write rewrites
+     * it whole rather than appending after the damage.
+     */
+    bool repairPending;
+
+    /**
+     * @brief What the checksums of the files read by the last `buildFromFile` showed.
+     */
+    IntegrityReport loadIntegrity;
+
+    /**
+     * @brief Number of changes made since the last write.
+     */
+    size_t pendingChanges;
+
+    /**
+     * @brief When the oldest change not yet written was made.
+     */
+    chrono::steady_clock::time_point oldestPendingChange;
+
+    /**
+     * @brief Each account's transactions in the transaction file format, as last serialized.
+     *
+     * @details A rewrite re-serializes only the accounts flagged dirty and copies every other account's block from
+     * here, so deleting one transaction costs one account's formatting rather than the whole ledger's.
+     */
+    unordered_map<int, string> transactionBlocks;
+
     /**
      * @brief Cleans up the tree, deleting all nodes.
      *
@@ -46,7 +249,8 @@ public:
      * @brief Default constructor for the ForestTree class.
      *
      * @details Initializes an empty forest with no accounts or nodes. The constructor prepares the object to be used
-     * for further operations such as adding accounts and transactions.
+     * for further operations such as adding accounts and transactions. It has no transaction file until
+     * `buildFromFile` or `enableBackgroundPersistence` sets one, so changes made before that are not written.
      */
     ForestTree();
 
@@ -91,6 +295,45 @@ public:
      */
     bool addAccount(const Account &newAccount, int parentNumber);
 
+    /**
+     * @brief Adds a new account to the tree, moving it into its node instead of copying it.
+     *
+     * @param newAccount The account to be added. Left empty if it was added, untouched otherwise.
+     * @param parentNumber The account number of the parent account.
+     *
+     * @return bool True if the account is successfully added, false otherwise.
+     */
+    bool addAccount(Account &&newAccount, int parentNumber);
+
+    /**
+     * @brief Adds a batch of new accounts, posting their initial balances as opening entries and saving the chart once.
+     *
+     * @param batch The accounts to add, in any order. A parent may be added in the same batch as its children.
+     * @param path The chart of accounts file to rewrite, or empty to leave the chart file alone.
+     *
+     * @return vector<bool> One entry per account, true if it was added. An account is rejected if its number is not
+     * positive, already exists (or repeats an earlier entry of the batch), or its parent exists nowhere.
+     *
+     * @details The batch is sorted so that every parent is linked before its children, and each account is linked
+     * under its parent in one pass. Each non-zero initial balance is posted to its account as an "Opening balance"
+     * transaction dated today, in one `postTransactions` batch, so it reaches the ancestors and the transaction file
+     * like any posting, and `audit` and `rebuildBalances` count it. When `path` is the tree's own chart, the chart is
+     * marked pending and saved once, with those transactions, when the durability policy writes them; a failed save
+     * is printed, reported by `hasChartWriteFailed` and retried by the next write. Any other `path` gets a snapshot
+     * right away. The result says which accounts were added either way.
+     */
+    vector<bool> addAccounts(const vector<Account> &batch, const string &path);
+
+    /**
+     * @brief Adds a batch of new accounts, moving each one into its node instead of copying it.
+     *
+     * @param batch The accounts to add, in any order. The entries that were added are left empty.
+     * @param path The chart of accounts file to rewrite, or empty to leave the chart file alone.
+     *
+     * @return vector<bool> One entry per account, true if it was added, as for the copying overload.
+     */
+    vector<bool> addAccounts(vector<Account> &&batch, const string &path);
+
     /**
      * @brief Adds a transaction to an account.
      *
@@ -100,7 +343,8 @@ public:
      * @return bool True if the transaction is successfully added, false otherwise.
      *
      * @details This method adds a transaction to the account specified by accountNumber. The transaction is appended
-     * to the list of transactions for the account.
+     * to the list of transactions for the account. A transaction whose ID is already in the forest is a duplicate (for
+     * example a client retrying a posting) and is dropped, so posting is idempotent.
      */
     bool addTransaction(int accountNumber, Transaction &transaction);
 
@@ -117,6 +361,91 @@ public:
      */
     bool deleteTransaction(int accountNumber, int transactionIndex);
 
+    /**
+     * @brief Posts a batch of transactions, saving the transaction file once for the whole batch.
+     *
+     * @param postings The (account number, transaction) pairs to post, applied in order.
+     *
+     * @return vector<bool> One entry per posting, true if it was applied; false if its account does not exist or
+     * its transaction ID is already in the forest.
+     */
+    vector<bool> postTransactions(vector<Posting> &postings);
+
+    /**
+     * @brief Checks whether a transaction ID is already in the forest.
+     *
+     * @param transactionID The transaction ID.
+     *
+     * @return bool True if a transaction with this ID was posted or loaded and not deleted since.
+     */
+    bool hasTransactionId(const string &transactionID) const;
+
+    /**
+     * @brief Deletes a batch of transactions, saving the transaction file once for the whole batch.
+     *
+     * @param deletions The (account number, transaction index) pairs to delete. Indices refer to the transactions
+     * as they were before the batch.
+     *
+     * @return vector<bool> One entry per deletion, true if it was applied.
+     */
+    vector<bool> deleteTransactions(const vector<pair<int, int>> &deletions);
+
+    /**
+     * @brief Chooses when changes are written to the transaction file and the chart.
+     *
+     * @param policy The durability mode and its group commit thresholds.
+     *
+     * @return void
+     *
+     * @details Changes already pending are written at once if the new policy says they are due.
+     */
+    void setDurabilityPolicy(const DurabilityPolicy &policy);
+
+    /**
+     * @brief Returns the current durability policy.
+     *
+     * @return const DurabilityPolicy& The policy.
+     */
+    const DurabilityPolicy &getDurabilityPolicy() const;
+
+    /**
+     * @brief Writes every pending change to the transaction file and the chart, and waits until it is on disk.
+     *
+     * @return bool True once the changes are durable, false if they could not be written.
+     */
+    bool commit();
+
+    /**
+     * @brief Writes the pending changes if the durability policy says they are due.
+     *
+     * @return bool False if a write was due and failed, true otherwise.
+     *
+     * @details Group commit thresholds are checked whenever a change is made. A long-running caller that can go
+     * quiet under `GroupCommit` calls this now and then, so the last changes before a pause are not held back.
+     */
+    bool commitIfDue();
+
+    /**
+     * @brief Checks whether the chart file is behind the balances in memory.
+     *
+     * @return bool True if a balance changed since the chart was last written, for example because saving it failed.
+     */
+    bool hasUnsavedChart() const;
+
+    /**
+     * @brief Checks whether the last attempt to save the chart failed.
+     *
+     * @return bool True until the chart is saved again.
+     */
+    bool hasChartWriteFailed() const;
+
+    /**
+     * @brief Returns the number of changes not yet written to the transaction file.
+     *
+     * @return size_t The number of pending changes.
+     */
+    size_t getPendingChanges() const;
+
     /**
      * @brief Prints a detailed report of an account to a file.
      *
@@ -159,8 +488,11 @@ public:
      *
      * @return void
      *
+     * @throws runtime_error If the file cannot be written; the previous contents are then left untouched.
+     *
      * @details This method saves the entire forest tree structure to a file. Each node in the tree is written to the
-     * file, preserving the hierarchy of accounts.
+     * file in pre-order, preserving the hierarchy of accounts. The file is written to a temp file, fsynced and
+     * renamed into place, so it is never left half-written.
      */
     void saveToFile(const string &filename) const;
 
@@ -172,9 +504,10 @@ public:
      * @return void
      *
      * @details This method saves all transactions from all accounts in the forest tree to a file. Each transaction
-     * is saved with relevant details, such as transaction ID, amount, date, and description.
+     * is saved with relevant details, such as transaction ID, amount, date, and description. Saving to the tree's
+     * own transaction file rewrites it with every pending change, exactly like a commit.
      */
-    void saveTransactions(const string &filename) const;
+    void saveTransactions(const string &filename);
 
     /**
      * @brief Loads transactions from a file.
@@ -201,43 +534,506 @@ public:
      */
     string getTransactionFilename(const string &accountsFile) const;
 
+    /**
+     * @brief Returns the transaction file the tree keeps in step with its changes.
+     *
+     * @return const string& The file loaded by `buildFromFile`, or the background writer's file once enabled; empty
+     * before either.
+     */
+    const string &getTransactionsFile() const;
+
+    /**
+     * @brief Returns what checking the records of the last loaded chart and transaction files found.
+     *
+     * @return const IntegrityReport& The counts of intact, unchecked and corrupt records, and where the first corrupt
+     * one is. Corrupt records were skipped.
+     */
+    const IntegrityReport &getLoadIntegrity() const;
+
     /**
      * @brief Adds a new account to both the tree structure and the file.
      *
      * @param accountNumber The account number
      * @param description The account description
-     * @param balance The initial balance
-     * @return bool Returns true if the account was successfully added, false otherwise
+     * @param balance The initial balance, posted as an opening entry
+     * @param path The chart of accounts file to rewrite
+     * @return bool Returns true if the account was added, false otherwise. Whether the chart could be saved is
+     * reported on stderr and by `hasChartWriteFailed`.
      */
     bool addAccountWithFile(int accountNumber, const string &description, double balance, string path);
 
+    /**
+     * @brief Moves transaction file writes onto a background I/O thread.
+     *
+     * @param transactionsFile The transaction file to maintain; it should already match the tree.
+     * @param syncWrites Whether each write is fsynced before it counts as durable.
+     *
+     * @return void
+     *
+     * @details Postings then return at in-memory cost. Use `getLastChangeSequence` and `waitDurable` to wait for a
+     * change to reach the disk, or ignore them to fire and forget. The chart is saved with the new balances by the
+     * first write or `commit` after the transactions behind them are durable.
+     */
+    void enableBackgroundPersistence(const string &transactionsFile, bool syncWrites = true);
+
+    /**
+     * @brief Returns the sequence number of the most recent change queued for the background writer.
+     *
+     * @return uint64_t The sequence number, or 0 if background persistence is not enabled.
+     */
+    uint64_t getLastChangeSequence() const;
+
+    /**
+     * @brief Blocks until a queued change, and every change before it, has reached the disk.
+     *
+     * @param sequence A value returned by `getLastChangeSequence`.
+     *
+     * @return bool True once the change is durable (at once if background persistence is not enabled), false if
+     * the background writer failed.
+     */
+    bool waitDurable(uint64_t sequence) const;
+
+    /**
+     * @brief Returns the debit and credit totals of an account's subtree over a range of days.
+     *
+     * @param accountNumber The account at the top of the subtree.
+     * @param fromDate The first day of the period, in `DD-MM-YY` form.
+     * @param toDate The last day of the period, in `DD-MM-YY` form.
+     *
+     * @return PeriodTotals The totals over the period, or all zeros if the account does not exist.
+     *
+     * @throws invalid_argument If either date cannot be parsed, as the batch `query` command also rejects it.
+     *
+     * @details The totals are read from the day buckets kept up to date as transactions are posted and deleted, so
+     * the cost depends on the number of days in the period rather than the number of transactions in the ledger.
+     */
+    PeriodTotals getPeriodTotals(int accountNumber, const string &fromDate, const string &toDate) const;
+
+    /**
+     * @brief Returns the debit and credit totals of an account's subtree for one calendar month.
+     *
+     * @param accountNumber The account at the top of the subtree.
+     * @param year The four-digit year.
+     * @param month The month (1-12).
+     *
+     * @return PeriodTotals The totals for the month, or all zeros if the account does not exist.
+     */
+    PeriodTotals getMonthlyTotals(int accountNumber, int year, int month) const;
+
+    /**
+     * @brief Streams every transaction in a subtree that matches a query.
+     *
+     * @param subtreeRoot The account at the top of the subtree to search.
+     * @param filter The date, amount, type and description filters to apply.
+     * @param callback Invoked once per matching transaction, on the calling thread. Returning false stops the query.
+     *
+     * @return size_t The number of matching transactions delivered, or 0 if the account does not exist.
+     *
+     * @details Accounts whose min/max date and amount summaries fall outside the filter are skipped without reading
+     * their transactions. The child subtrees of `subtreeRoot` are searched in parallel on the worker pool, and each
+     * child's matches are delivered, in chart order, as soon as it and every child before it are done, so the
+     * callback never needs to be thread-safe and only the children not yet delivered are held in memory. Once the
+     * callback returns false, the searches still running give up and no further child is started.
+     */
+    size_t query(int subtreeRoot, const TransactionQuery &filter, const TransactionCallback &callback) const;
+
+    /**
+     * @brief Returns the K largest transactions in a subtree.
+     *
+     * @param subtreeRoot The account at the top of the subtree.
+     * @param k The maximum number of transactions to return.
+     * @param filter Optional filters, e.g. a date range to restrict the ranking to one month.
+     *
+     * @return vector<TransactionHit> The transactions, largest amount first.
+     *
+     * @details Each child subtree keeps its own bounded min-heap of K entries, filled in parallel on the worker pool,
+     * and the partial heaps are merged at the end, so memory stays O(K × children) however large the ledger is.
+     */
+    vector<TransactionHit> topTransactions(int subtreeRoot, size_t k,
+                                           const TransactionQuery &filter = TransactionQuery()) const;
+
+    /**
+     * @brief Returns the K accounts with the largest absolute balance below a subtree root.
+     *
+     * @param subtreeRoot The account at the top of the subtree. It is not itself ranked, since its balance is the
+     * sum of the accounts being ranked.
+     * @param k The maximum number of accounts to return.
+     * @param leavesOnly Whether to rank only accounts without children (the default). A parent's balance includes
+     * all of its children's, so ranking parents too mostly returns the top of the hierarchy instead of the accounts
+     * actually holding the money.
+     *
+     * @return vector<NodePtr> The account nodes, largest absolute balance first.
+     */
+    vector<NodePtr> topAccountsByBalance(int subtreeRoot, size_t k, bool leavesOnly = true) const;
+
+    /**
+     * @brief Returns the order-statistic index of account balances.
+     *
+     * @return const BalanceIndex& The index, e.g. `getBalanceIndex().accountsBelow(0)` for every overdrawn account
+     * or `getBalanceIndex().rankOf(5110)` for the position of an account by balance.
+     */
+    const BalanceIndex &getBalanceIndex() const;
+
+    /**
+     * @brief Returns the description search index.
+     *
+     * @return const SearchIndex& The index, e.g. `getSearchIndex().search("payroll", 20)` for the best twenty
+     * accounts and transactions mentioning payroll.
+     */
+    const SearchIndex &getSearchIndex() const;
+
+    /**
+     * @brief Returns the metrics registry.
+     *
+     * @return const ForestMetrics& The counters (nodes visited, rollup steps, bytes written) and the latency
+     * histogram of every public operation. All values stay zero unless built with `FOREST_ENABLE_METRICS`.
+     */
+    const ForestMetrics &getMetrics() const;
+
+    /**
+     * @brief Writes the current metrics to a file in Prometheus text format.
+     *
+     * @param filename The file to write.
+     *
+     * @return void
+     *
+     * @throws runtime_error If the file cannot be opened.
+     */
+    void dumpMetrics(const string &filename) const;
+
+    /**
+     * @brief Recomputes every balance from the transactions and reports the accounts that disagree.
+     *
+     * @return AuditReport The number of accounts checked and every mismatch, in chart order.
+     *
+     * @details Each account's balance should equal its own transactions (debits minus credits) plus the balances of
+     * its children. One post-order pass per root subtree computes that bottom-up, so every account is visited once;
+     * the root subtrees are audited in parallel. Initial balances given to `addAccounts` are opening-entry
+     * transactions, so they are counted; any other balance that did not come from a transaction is reported as a
+     * mismatch. Differences under half a cent are ignored.
+     */
+    AuditReport audit() const;
+
+    /**
+     * @brief Resets every balance to the value its transactions add up to.
+     *
+     * @return AuditReport The accounts that were corrected, with their old and new balances.
+     *
+     * @details Runs the same O(n) pass as `audit`, writing the computed balances back as it goes. The chart file is
+     * not rewritten; call `saveToFile` to keep the corrected balances.
+     */
+    AuditReport rebuildBalances();
+
+    /**
+     * @brief Returns a digest of the whole ledger: every account, balance and transaction.
+     *
+     * @return uint64_t The fingerprint. Two forests with the same fingerprint hold the same ledger.
+     *
+     * @details Every node keeps a Merkle digest of its subtree, updated along the ancestor path whenever an account
+     * or transaction is added or removed, so this only combines the root digests.
+     */
+    uint64_t fingerprint() const;
+
+    /**
+     * @brief Returns the Merkle digest of one account's subtree.
+     *
+     * @param accountNumber The account at the top of the subtree.
+     *
+     * @return uint64_t The digest, or 0 if the account does not exist.
+     */
+    uint64_t getSubtreeDigest(int accountNumber) const;
+
+    /**
+     * @brief Lists the accounts that differ between this forest and another.
+     *
+     * @param other The forest to compare against, e.g. a replica or a copy taken before a migration.
+     *
+     * @return vector<LedgerDifference> The differing accounts, each parent before its children. An account whose
+     * balance changed because a descendant changed is listed as well.
+     *
+     * @details The forests are compared top-down by subtree digest, descending only into subtrees whose digests
+     * differ, so the cost grows with the number of changes times the depth rather than with the ledger size.
+     */
+    vector<LedgerDifference> diff(const ForestTree &other) const;
+
 private:
     /**
-     * @brief Helper function to recursively print tree nodes.
+     * @brief Helper function to print tree nodes.
      *
-     * @param node The current node to print.
-     * @param level The current level of the tree.
+     * @param node The first node to print.
+     * @param level The level of the tree the first node is on.
      *
      * @return void
      *
-     * @details This private helper method is used to recursively print the nodes of the tree, starting from the
-     * given node. It prints the structure of the tree, showing each node's account number and level in the hierarchy.
+     * @details This private helper method prints the nodes of the tree in pre-order, starting from the given node,
+     * without recursing. It prints the structure of the tree, showing each node's account number and level in the
+     * hierarchy.
      */
     void printTreeHelper(NodePtr node, int level) const;
 
     /**
-     * @brief Finds the root node for an account based on the first digit of the account number.
+     * @brief Returns the number of an account's parent, which is the account number without its last digit.
+     *
+     * @param accountNumber The account number.
+     *
+     * @return int The parent account number, or -1 for a single-digit (root) account.
+     */
+    static int parentAccountNumber(int accountNumber);
+
+    /**
+     * @brief Registers a newly linked node in the account, balance and search indexes.
+     *
+     * @param node The new node.
+     *
+     * @return void
+     */
+    void indexAccount(NodePtr node);
+
+    /**
+     * @brief Posts a transaction to an account and its ancestors without saving the transaction file.
+     *
+     * @param accountNumber The account number to which the transaction will be added.
+     * @param transaction The transaction to be added.
+     *
+     * @return bool True if the transaction was applied, false otherwise.
+     */
+    bool applyTransaction(int accountNumber, Transaction &transaction);
+
+    /**
+     * @brief Deletes a transaction from an account and its ancestors without saving the transaction file.
      *
-     * @param accountNumber The account number for which the root node is to be found.
+     * @param accountNumber The account number from which the transaction will be deleted.
+     * @param transactionIndex The index of the transaction to be deleted.
      *
-     * @return NodePtr A pointer to the root node of the account if found, or nullptr if not found.
+     * @return bool True if the transaction was removed, false otherwise.
+     */
+    bool applyDeletion(int accountNumber, int transactionIndex);
+
+    /**
+     * @brief Writes every transaction in the forest in the transaction file format.
+     *
+     * @param file The stream to write to.
      *
-     * @details This method attempts to find the root node of the account by comparing the first digit of the account number
-     * with the first digit of the account numbers of all root accounts in the tree. If a match is found, the corresponding root node
-     * is returned. If no match is found, nullptr is returned. This method assumes that accounts with the same first digit are
-     * grouped together in the forest structure.
+     * @return void
+     */
+    void writeTransactions(ostream &file) const;
+
+    /**
+     * @brief Appends one `account|id|amount|type|date|description` line, sealed with its checksum.
+     *
+     * @param out The text being built.
+     * @param accountNumber The account that owns the transaction.
+     * @param t The transaction.
+     *
+     * @return void
+     */
+    static void writeTransactionLine(string &out, int accountNumber, const Transaction &t);
+
+    /**
+     * @brief Records newly posted transactions as pending, then writes them if the durability policy says so.
+     *
+     * @param lines The new transactions, in the transaction file format.
+     * @param changes The number of postings the lines hold.
+     *
+     * @return void
+     */
+    void recordAppend(const string &lines, size_t changes);
+
+    /**
+     * @brief Records a change that needs the whole transaction file rewritten, such as a deletion, then writes it
+     * if the durability policy says so.
+     *
+     * @param changes The number of changes made.
+     *
+     * @return void
+     */
+    void recordRewrite(size_t changes);
+
+    /**
+     * @brief Writes the pending changes: queued for the background writer if it is enabled, otherwise written and
+     * fsynced on the calling thread. The chart is then saved with the new balances once the transactions are durable.
+     *
+     * @return bool True if the changes were written or queued and the chart saved or left waiting for them. On
+     * failure they stay pending, the transactions as a full rewrite. A tree without a transaction file drops them.
+     */
+    bool writePending();
+
+    /**
+     * @brief Saves the chart to `chartFile` if a balance changed since it was last written and the background write
+     * of the transactions behind it is durable.
+     *
+     * @return bool True if the chart is up to date or still waiting for that write, false if it could not be written;
+     * it then stays pending.
+     */
+    bool writePendingChart();
+
+    /**
+     * @brief Builds the whole transaction file, re-serializing only dirty accounts.
+     *
+     * @param contents Receives the file contents.
+     *
+     * @return void
+     */
+    void serializeTransactions(string &contents);
+
+    /**
+     * @brief Records a transaction in the period buckets of its account and every ancestor.
+     *
+     * @param accountNode The node of the account that owns the transaction.
+     * @param t The transaction being posted or deleted.
+     * @param sign +1 when the transaction is posted, -1 when it is deleted.
+     *
+     * @return void
+     */
+    void rollupPeriodTotals(NodePtr accountNode, const Transaction &t, int sign);
+
+    /**
+     * @brief Applies a transaction to the balance of an account and of every ancestor, and re-indexes those balances.
+     *
+     * @param accountNode The node of the account that owns the transaction.
+     * @param t The transaction being posted or deleted.
+     * @param sign +1 when the transaction is posted, -1 when it is deleted.
+     *
+     * @return void
+     */
+    void rollupBalances(NodePtr accountNode, const Transaction &t, int sign);
+
+    /**
+     * @brief Collects the matching transactions of a node and all of its descendants.
+     *
+     * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+     * @param filter The query filters.
+     * @param out Receives the matching (account, transaction) pairs in pre-order.
+     * @param stopped Checked before each account; once set, the walk gives up.
+     *
+     * @return void
+     */
+    static void collectMatches(NodePtr subtree, const TransactionQuery &filter,
+                               vector<pair<const Account *, const Transaction *>> &out, const atomic<bool> &stopped);
+
+    /**
+     * @brief Returns the direct children of a node, in sibling order.
+     *
+     * @param node The parent node.
+     *
+     * @return vector<NodePtr> The children of the node.
+     */
+    static vector<NodePtr> getChildren(NodePtr node);
+
+    /**
+     * @brief Checks whether the subtrees of a list of nodes hold too little to be worth splitting across threads.
+     *
+     * @param nodes The subtree roots.
+     *
+     * @return bool True if they hold only a few thousand accounts and transactions in total.
+     */
+    static bool isSmallWork(const vector<NodePtr> &nodes);
+
+    /**
+     * @brief Runs a task for each node in a list, spread over the shared worker pool.
+     *
+     * @param nodes The nodes to process, typically the children of a subtree root.
+     * @param work The task, called with the index of the node in `nodes` and the node itself.
+     *
+     * @return void
+     */
+    static void runInParallel(const vector<NodePtr> &nodes, const function<void(size_t, NodePtr)> &work);
+
+    /**
+     * @brief Runs a task for each node in a list on the worker pool, handing each result over in list order.
+     *
+     * @param nodes The nodes to process, typically the children of a subtree root.
+     * @param work The task, called with the index of the node in `nodes` and the node itself.
+     * @param deliver Called on the calling thread with each index, once its task and every earlier one are done.
+     * Returns false to stop starting further tasks.
+     *
+     * @return bool True if every result was delivered, false if `deliver` stopped early.
+     */
+    static bool runInOrder(const vector<NodePtr> &nodes, const function<void(size_t, NodePtr)> &work,
+                           const function<bool(size_t)> &deliver);
+
+    /**
+     * @brief Recomputes the balances of a subtree bottom-up, in one post-order pass.
+     *
+     * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+     * @param repair Whether to overwrite each mismatched balance with the computed one.
+     * @param report Receives the number of accounts checked and the mismatches.
+     *
+     * @return void
+     */
+    static void auditSubtree(NodePtr subtree, bool repair, AuditReport &report);
+
+    /**
+     * @brief Runs `auditSubtree` over every root subtree in parallel and merges the reports in chart order.
+     *
+     * @param roots The root accounts.
+     * @param repair Whether to overwrite each mismatched balance with the computed one.
+     *
+     * @return AuditReport The merged report.
+     */
+    static AuditReport auditForest(const vector<NodePtr> &roots, bool repair);
+
+    /**
+     * @brief Recomputes a node's digest after its account changed, then carries the change up to the root.
+     *
+     * @param node The node whose fields, transactions or children changed.
+     *
+     * @return void
+     *
+     * @details Each ancestor is re-hashed on the way up as well, since its balance moves with its descendants.
+     */
+    void refreshDigests(NodePtr node);
+
+    /**
+     * @brief Pairs up two sorted lists of sibling nodes by account number for `diff`.
+     *
+     * @param here Nodes of this forest, in account number order.
+     * @param there Nodes of the other forest, in account number order.
+     * @param differences Receives the accounts found on one side only.
+     * @param differing Receives the pairs present on both sides whose subtree digests differ.
+     *
+     * @return void
+     */
+    static void matchSiblings(const vector<NodePtr> &here, const vector<NodePtr> &there,
+                              vector<LedgerDifference> &differences, vector<pair<NodePtr, NodePtr>> &differing);
+
+    /**
+     * @brief Offers the transactions of one account to a bounded top-K min-heap.
+     *
+     * @param account The account whose transactions are offered.
+     * @param k The number of transactions to keep.
+     * @param filter The query filters.
+     * @param heap The bounded min-heap receiving the candidates.
+     *
+     * @return void
+     */
+    static void offerTopTransactions(const Account &account, size_t k, const TransactionQuery &filter,
+                                     vector<TransactionCandidate> &heap);
+
+    /**
+     * @brief Keeps the K largest transactions of a subtree in a bounded min-heap.
+     *
+     * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+     * @param k The number of transactions to keep.
+     * @param filter The query filters.
+     * @param heap The bounded min-heap receiving the candidates.
+     *
+     * @return void
+     */
+    static void collectTopTransactions(NodePtr subtree, size_t k, const TransactionQuery &filter,
+                                       vector<TransactionCandidate> &heap);
+
+    /**
+     * @brief Keeps the K accounts with the largest absolute balance in a subtree in a bounded min-heap.
+     *
+     * @param subtree The node at the top of the subtree. Its own siblings are not visited.
+     * @param k The number of accounts to keep.
+     * @param leavesOnly Whether to skip accounts that have children.
+     * @param heap The bounded min-heap receiving the candidates.
+     *
+     * @return void
      */
-    NodePtr findRootForAccount(int accountNumber) const;
+    static void collectTopAccounts(NodePtr subtree, size_t k, bool leavesOnly, vector<AccountCandidate> &heap);
 };
 
 #endif // FORESTTREE_H
@@ -0,0 +1,154 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file LedgerDate.cpp
+ * @brief Implements `LedgerDate`, the packed transaction date and its cached clock.
+ */
+
+#include "LedgerDate.h"
+#include <ctime>
+
+using namespace std;
+
+/**
+ * @brief Reads a run of decimal digits.
+ *
+ * @param text The text; the digits read are removed from its front.
+ * @param maxDigits The most digits to read
+ * @param value Receives the number
+ * @return False if `text` does not start with a digit.
+ */
+static bool readNumber(string_view &text, size_t maxDigits, int &value) {
+    size_t digits = 0;
+    value = 0;
+    while (digits < maxDigits && digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+        value = value * 10 + (text[digits] - '0');
+        ++digits;
+    }
+    text.remove_prefix(digits);
+    return digits > 0;
+}
+
+/**
+ * @brief Appends a number as exactly `width` digits, with leading zeros.
+ *
+ * @param out The text being built
+ * @param value The number
+ * @param width The number of digits
+ */
+static void appendDigits(string &out, int value, int width) {
+    char digits[4];
+    for (int i = width - 1; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(digits, width);
+}
+
+/**
+ * @brief Returns the number of days in a month of the Gregorian calendar.
+ *
+ * @param year The year
+ * @param month The month, 1 to 12
+ * @return 28 to 31
+ */
+static int daysInMonth(int year, int month) {
+    static const int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    return month == 2 && leap ? 29 : DAYS[month - 1];
+}
+
+/**
+ * @brief Parses a `DD-MM-YY` (or `DD-MM-YYYY`) date.
+ *
+ * Two-digit years are taken as 20YY. Leading blanks are skipped and anything after the year is ignored. The day must
+ * exist in its month, so `31-02-24` is not a date.
+ *
+ * @param text The date
+ * @return The day key, or 0 if the text is not a date
+ */
+int32_t LedgerDate::parse(string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    int day, month, year;
+    if (!readNumber(text, 2, day) || text.empty() || text.front() != '-') return 0;
+    text.remove_prefix(1);
+    if (!readNumber(text, 2, month) || text.empty() || text.front() != '-') return 0;
+    text.remove_prefix(1);
+    if (!readNumber(text, 4, year)) return 0;
+
+    if (year < 100) {
+        year += 2000;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) {
+        return 0;
+    }
+    return year * 10000 + month * 100 + day;
+}
+
+/**
+ * @brief Appends a day key in `DD-MM-YY` form, or with a four-digit year outside 2000-2099.
+ *
+ * @param out The text being built
+ * @param dayKey The day key; 0 appends nothing
+ */
+void LedgerDate::append(string &out, int32_t dayKey) {
+    if (dayKey <= 0) {
+        return;
+    }
+    int year = dayKey / 10000;
+    appendDigits(out, dayKey % 100, 2);
+    out += '-';
+    appendDigits(out, dayKey / 100 % 100, 2);
+    out += '-';
+    // A two-digit year reads back as 20YY, so any other century keeps all four digits
+    if (year >= 2000 && year <= 2099) {
+        appendDigits(out, year % 100, 2);
+    } else {
+        appendDigits(out, year, 4);
+    }
+}
+
+/**
+ * @brief Formats a day key as `append` does.
+ *
+ * @param dayKey The day key
+ * @return The date text, empty for 0
+ */
+string LedgerDate::format(int32_t dayKey) {
+    string text;
+    append(text, dayKey);
+    return text;
+}
+
+/**
+ * @brief Returns the current local day.
+ *
+ * Each thread remembers the second it last converted and its day, so the calendar conversion runs at most once per
+ * second per thread; every other call is a single `time` read.
+ *
+ * @return Today's day key
+ */
+int32_t LedgerDate::today() {
+    struct CachedDay {
+        time_t second = -1;  ///< The second `day` was computed for
+        int32_t day = 0;     ///< The local day at that second
+    };
+    thread_local CachedDay cache;
+
+    time_t now = time(nullptr);
+    if (now != cache.second) {
+        tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        cache.second = now;
+        cache.day = (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+    }
+    return cache.day;
+}
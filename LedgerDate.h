@@ -0,0 +1,59 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_LEDGERDATE_H
+#define ADS_MIDTERM_PROJECT_LEDGERDATE_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class LedgerDate
+ * @brief Transaction dates packed into one 32-bit integer, with the text conversions and a cached clock.
+ *
+ * A date is stored as its day key, `YYYYMMDD` (0 for no date), so dates compare and sort as plain integers and the
+ * month key is the day key divided by 100. Text is only involved at the edges: `parse` reads the `DD-MM-YY` form
+ * used by the files and commands, and `format`/`append` write it back.
+ *
+ * `today` serves the current day from a per-thread cache that re-reads the local calendar at most once per second,
+ * so stamping a posting with today's date costs a clock read rather than `localtime` and `strftime`.
+ */
+class LedgerDate {
+public:
+    /**
+     * @brief Parses a `DD-MM-YY` (or `DD-MM-YYYY`) date.
+     *
+     * @param text The date
+     * @return The day key, or 0 if the text is not a date
+     */
+    static int32_t parse(string_view text);
+
+    /**
+     * @brief Appends a day key in `DD-MM-YY` form, or with a four-digit year outside 2000-2099.
+     *
+     * @param out The text being built
+     * @param dayKey The day key; 0 appends nothing
+     */
+    static void append(string &out, int32_t dayKey);
+
+    /**
+     * @brief Formats a day key as `append` does.
+     *
+     * @param dayKey The day key
+     * @return The date text, empty for 0
+     */
+    static string format(int32_t dayKey);
+
+    /**
+     * @brief Returns the current local day.
+     *
+     * @return Today's day key
+     */
+    static int32_t today();
+};
+
+#endif //ADS_MIDTERM_PROJECT_LEDGERDATE_H
@@ -0,0 +1,150 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file LedgerDigest.cpp
+ * @brief Implements `LedgerDigest`, the hashing behind the Merkle subtree digests of the forest.
+ */
+
+#include "LedgerDigest.h"
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+/**
+ * @brief FNV-1a 64-bit offset basis.
+ */
+static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+/**
+ * @brief FNV-1a 64-bit prime.
+ */
+static const uint64_t FNV_PRIME = 1099511628211ull;
+
+/**
+ * @brief Folds bytes into an FNV-1a hash.
+ *
+ * @param hash The running hash
+ * @param bytes The bytes
+ * @param size The number of bytes
+ * @return The updated hash
+ */
+static uint64_t fnv(uint64_t hash, const void *bytes, size_t size) {
+    const unsigned char *p = static_cast<const unsigned char *>(bytes);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ p[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Folds a string into an FNV-1a hash, followed by a separator so adjacent fields cannot run together.
+ *
+ * @param hash The running hash
+ * @param text The string
+ * @return The updated hash
+ */
+static uint64_t fnvString(uint64_t hash, string_view text) {
+    hash = fnv(hash, text.data(), text.size());
+    return (hash ^ 0xFF) * FNV_PRIME;
+}
+
+/**
+ * @brief Folds an integer into an FNV-1a hash, byte by byte from the lowest.
+ *
+ * @param hash The running hash
+ * @param value The integer
+ * @return The updated hash
+ */
+static uint64_t fnvInt(uint64_t hash, int64_t value) {
+    uint64_t bits = static_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+        hash = (hash ^ ((bits >> (8 * i)) & 0xFF)) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief Converts an amount to whole cents, the precision the ledger files keep.
+ *
+ * @param amount The amount
+ * @return The amount in cents
+ */
+static int64_t toCents(double amount) {
+    return llround(amount * 100.0);
+}
+
+/**
+ * @brief Scrambles a 64-bit value (SplitMix64 finalizer).
+ *
+ * @param value The value
+ * @return The scrambled value
+ */
+uint64_t LedgerDigest::mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+    return value;
+}
+
+/**
+ * @brief Hashes one transaction.
+ *
+ * @param t The transaction
+ * @return The hash of its ID, amount, type, date and description
+ */
+uint64_t LedgerDigest::hashTransaction(const Transaction &t) {
+    uint64_t hash = FNV_OFFSET;
+    // Generated IDs hash as integers, so they are never rendered to text here
+    hash = t.getNumericID() != 0 ? fnvInt(hash, static_cast<int64_t>(t.getNumericID()))
+                                 : fnvString(hash, t.getTransactionID());
+    hash = fnvInt(hash, t.getAmountCents());
+    hash = fnvInt(hash, t.getDebitCredit());
+    hash = fnvInt(hash, t.getDayKey());
+    hash = fnvString(hash, t.getDescription());
+    return mix(hash);
+}
+
+/**
+ * @brief Hashes an account's own fields together with its transactions.
+ *
+ * @param account The account
+ * @param transactionsHash The sum of the hashes of its transactions
+ * @return The hash of its number, description, balance and transactions
+ */
+uint64_t LedgerDigest::hashAccount(const Account &account, uint64_t transactionsHash) {
+    uint64_t hash = FNV_OFFSET;
+    hash = fnvInt(hash, account.getAccountNumber());
+    hash = fnvString(hash, account.getDescription());
+    hash = fnvInt(hash, toCents(account.getBalance()));
+    hash = fnvInt(hash, static_cast<int64_t>(transactionsHash));
+    return mix(hash);
+}
+
+/**
+ * @brief Combines an account's own hash with the sum of its children's digests.
+ *
+ * @param own The account's own hash
+ * @param children The sum of its children's subtree digests
+ * @return The subtree digest
+ */
+uint64_t LedgerDigest::combine(uint64_t own, uint64_t children) {
+    // Mixing the children's sum on its own first keeps a subtree from cancelling out against its parent's fields
+    return mix(own ^ mix(children + 0x9e3779b97f4a7c15ull));
+}
+
+/**
+ * @brief Formats a digest as 16 lowercase hex digits.
+ *
+ * @param digest The digest
+ * @return The hex string
+ */
+string LedgerDigest::toHex(uint64_t digest) {
+    char text[17];
+    snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(digest));
+    return string(text);
+}
@@ -0,0 +1,83 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_LEDGERDIGEST_H
+#define ADS_MIDTERM_PROJECT_LEDGERDIGEST_H
+
+#include <string>
+#include <cstdint>
+#include "Account.h"
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @struct SubtreeDigest
+ * @brief The Merkle digest parts kept by every `TreeNode`.
+ *
+ * Transactions and children are folded in by addition, so a posting, a deletion or a changed child adjusts its
+ * parent in O(1) and the whole update costs one step per ancestor, along the same path as the balances.
+ */
+struct SubtreeDigest {
+    uint64_t transactions = 0;  ///< Sum of the hashes of the account's transactions, in any order
+    uint64_t own = 0;           ///< Hash of the account fields and `transactions`
+    uint64_t children = 0;      ///< Sum of the children's `subtree` digests
+    uint64_t subtree = 0;       ///< Digest of the account and everything below it; 0 until the node is linked
+};
+
+/**
+ * @class LedgerDigest
+ * @brief The hash functions behind the subtree digests.
+ *
+ * Fields are hashed with 64-bit FNV-1a and then passed through a SplitMix64 finalizer, so sums of hashes stay well
+ * spread. Amounts and balances are hashed in whole cents, the precision the files keep, so two copies of a ledger
+ * that print the same also hash the same. The digests detect accidental differences; they are not cryptographic.
+ */
+class LedgerDigest {
+private:
+    /**
+     * @brief Scrambles a 64-bit value (SplitMix64 finalizer).
+     *
+     * @param value The value
+     * @return The scrambled value
+     */
+    static uint64_t mix(uint64_t value);
+
+public:
+    /**
+     * @brief Hashes one transaction.
+     *
+     * @param t The transaction
+     * @return The hash of its ID, amount, type, date and description
+     */
+    static uint64_t hashTransaction(const Transaction &t);
+
+    /**
+     * @brief Hashes an account's own fields together with its transactions.
+     *
+     * @param account The account
+     * @param transactionsHash The sum of the hashes of its transactions
+     * @return The hash of its number, description, balance and transactions
+     */
+    static uint64_t hashAccount(const Account &account, uint64_t transactionsHash);
+
+    /**
+     * @brief Combines an account's own hash with the sum of its children's digests.
+     *
+     * @param own The account's own hash
+     * @param children The sum of its children's subtree digests
+     * @return The subtree digest
+     */
+    static uint64_t combine(uint64_t own, uint64_t children);
+
+    /**
+     * @brief Formats a digest as 16 lowercase hex digits.
+     *
+     * @param digest The digest
+     * @return The hex string
+     */
+    static string toHex(uint64_t digest);
+};
+
+#endif //ADS_MIDTERM_PROJECT_LEDGERDIGEST_H
@@ -0,0 +1,309 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file LedgerGenerator.cpp
+ * @brief Implements `LedgerGenerator` and `ZipfSampler`, used to build synthetic datasets for benchmarks.
+ */
+
+#include "LedgerGenerator.h"
+#include "RecordChecksum.h"
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <stdexcept>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+namespace {
+    const char *const ACCOUNT_WORDS[] = {
+            "Cash", "Bank", "Petty", "Receivables", "Payables", "Inventory", "Prepaid", "Equipment", "Vehicles",
+            "Buildings", "Depreciation", "Loans", "Accrued", "Wages", "Payroll", "Taxes", "Deferred", "Revenue",
+            "Sales", "Services", "Returns", "Discounts", "Rent", "Utilities", "Insurance", "Marketing", "Travel",
+            "Supplies", "Maintenance", "Consulting", "Interest", "Dividends", "Capital", "Reserves", "Retained",
+            "Earnings", "Domestic", "Foreign", "Regional", "Operating"
+    };
+    const size_t ACCOUNT_WORD_COUNT = sizeof(ACCOUNT_WORDS) / sizeof(ACCOUNT_WORDS[0]);
+
+    const char *const TRANSACTION_DESCRIPTIONS[] = {
+            "Monthly rent", "Payroll", "Office supplies", "Electricity bill", "Water bill", "Internet service",
+            "Client payment", "Vendor invoice", "Bank fee", "Loan repayment", "Interest accrual", "Tax payment",
+            "Insurance premium", "Travel expenses", "Fuel", "Equipment purchase", "Software license",
+            "Consulting fee", "Refund", "Sales receipt", "Inventory restock", "Maintenance", "Advertising",
+            "Dividend payout"
+    };
+    const size_t TRANSACTION_DESCRIPTION_COUNT =
+            sizeof(TRANSACTION_DESCRIPTIONS) / sizeof(TRANSACTION_DESCRIPTIONS[0]);
+
+    int digitCount(int number) {
+        int digits = 1;
+        while (number >= 10) {
+            number /= 10;
+            ++digits;
+        }
+        return digits;
+    }
+}
+
+/**
+ * @brief Creates a generator and lays out the chart of accounts.
+ *
+ * @param config The dataset shape.
+ */
+LedgerGenerator::LedgerGenerator(const GeneratorConfig &config) : config(config), rng(config.seed) {
+    this->config.roots = max(1, min(9, config.roots));
+    this->config.depth = max(1, min(9, config.depth));
+    this->config.fanout = max(1, min(10, config.fanout));
+    this->config.minDescriptionWords = max(1, config.minDescriptionWords);
+    this->config.maxDescriptionWords = max(this->config.minDescriptionWords, config.maxDescriptionWords);
+    this->config.years = max(1, config.years);
+    generateChart();
+}
+
+/**
+ * @brief Returns the generated account numbers, in pre-order.
+ *
+ * @return The account numbers.
+ */
+const vector<int> &LedgerGenerator::getAccounts() const {
+    return accounts;
+}
+
+/**
+ * @brief Generates the account numbers breadth-first, then orders them for output.
+ *
+ * Breadth-first growth keeps the chart balanced when the account limit cuts generation short. The accounts are
+ * then sorted into pre-order, which is the order of the chart file, and the leaves are shuffled so that the most
+ * active accounts are spread across the chart.
+ */
+void LedgerGenerator::generateChart() {
+    vector<int> frontier;
+    vector<int> parents;
+    for (int root = 1; root <= config.roots && (long long) accounts.size() < config.accounts; ++root) {
+        accounts.push_back(root);
+        frontier.push_back(root);
+    }
+
+    for (int level = 2; level <= config.depth && (long long) accounts.size() < config.accounts; ++level) {
+        vector<int> next;
+        for (int parent: frontier) {
+            int children = drawFanout();
+            for (int digit = 0; digit < children && (long long) accounts.size() < config.accounts; ++digit) {
+                int child = parent * 10 + digit;
+                accounts.push_back(child);
+                next.push_back(child);
+            }
+            if (children > 0 && !next.empty() && next.back() / 10 == parent) {
+                parents.push_back(parent);
+            }
+        }
+        frontier.swap(next);
+    }
+
+    // Pre-order: pad every number to the full depth, parents sort before their first child
+    int depth = config.depth;
+    auto preOrderKey = [depth](int account) {
+        long long padded = account;
+        for (int d = digitCount(account); d < depth; ++d) padded *= 10;
+        return make_pair(padded, digitCount(account));
+    };
+    sort(accounts.begin(), accounts.end(), [&](int a, int b) { return preOrderKey(a) < preOrderKey(b); });
+
+    sort(parents.begin(), parents.end());
+    for (int account: accounts) {
+        if (!binary_search(parents.begin(), parents.end(), account)) {
+            leaves.push_back(account);
+        }
+    }
+    shuffle(leaves.begin(), leaves.end(), rng);
+}
+
+/**
+ * @brief Draws how many children an account gets.
+ *
+ * With no skew every account gets `fanout` children. With skew k the count is fanout × u^k for uniform u, so
+ * larger skews give most accounts few children and a handful of accounts many.
+ *
+ * @return The number of children, between 1 and `fanout`.
+ */
+int LedgerGenerator::drawFanout() {
+    if (config.fanoutSkew <= 0.0) {
+        return config.fanout;
+    }
+    double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+    int children = static_cast<int>(ceil(config.fanout * pow(u, config.fanoutSkew)));
+    return max(1, min(config.fanout, children));
+}
+
+/**
+ * @brief Builds an account description from the vocabulary.
+ *
+ * @return The description.
+ */
+string LedgerGenerator::drawDescription() {
+    int words = uniform_int_distribution<int>(config.minDescriptionWords, config.maxDescriptionWords)(rng);
+    string description;
+    for (int i = 0; i < words; ++i) {
+        if (i > 0) description += ' ';
+        description += ACCOUNT_WORDS[rng() % ACCOUNT_WORD_COUNT];
+    }
+    return description;
+}
+
+/**
+ * @brief Writes the ledger and the chart of accounts.
+ *
+ * The ledger is written first while the net amount of every leaf is accumulated in cents; those amounts are then
+ * rolled up so every parent balance is the sum of its children when the chart is written.
+ *
+ * @param accountsFile The chart file; the ledger is written to the matching `_transactions.txt` file.
+ * @return The number of transactions written.
+ * @throws runtime_error If either file cannot be written.
+ */
+long long LedgerGenerator::writeFiles(const string &accountsFile) {
+    string ledgerFile = accountsFile.substr(0, accountsFile.find_last_of('.')) + "_transactions.txt";
+    vector<char> buffer(1 << 20);
+
+    unordered_map<int, long long> cents;
+    cents.reserve(accounts.size());
+    for (int account: accounts) {
+        cents[account] = 0;
+    }
+
+    // Ledger
+    {
+        ofstream ledger;
+        ledger.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        ledger.open(ledgerFile, ios::binary);
+        if (!ledger) {
+            throw runtime_error("Unable to open ledger file for writing: " + ledgerFile);
+        }
+
+        ZipfSampler activity(static_cast<long long>(leaves.size()), config.zipfExponent);
+        uniform_real_distribution<double> logAmount(log(100.0), log(10000000.0));
+        ChecksumSection section;
+        string sealed;
+        char line[256];
+        for (long long i = 0; i < config.transactions && !leaves.empty(); ++i) {
+            int account = leaves[activity.sample(rng) - 1];
+            long long amount = llround(exp(logAmount(rng)));
+            char type = (rng() % 10 < 6) ? 'D' : 'C';
+            int year = config.startYear + static_cast<int>(rng() % config.years);
+            int month = 1 + static_cast<int>(rng() % 12);
+            int day = 1 + static_cast<int>(rng() % 28);
+
+            int length = snprintf(line, sizeof(line), "%d|G%lld|%lld.%02lld|%c|%02d-%02d-%02d|%s",
+                                  account, i, amount / 100, amount % 100, type, day, month, year % 100,
+                                  TRANSACTION_DESCRIPTIONS[rng() % TRANSACTION_DESCRIPTION_COUNT]);
+            sealed.clear();
+            RecordChecksum::seal(sealed, string_view(line, length));
+            section.add(sealed);
+            ledger << sealed;
+            cents[account] += (type == 'D') ? amount : -amount;
+        }
+        ledger << section.trailer();
+        if (!ledger) {
+            throw runtime_error("Error while writing ledger file: " + ledgerFile);
+        }
+    }
+
+    // Roll leaf amounts up; reverse pre-order visits every child before its parent
+    for (auto it = accounts.rbegin(); it != accounts.rend(); ++it) {
+        if (*it >= 10) {
+            cents[*it / 10] += cents[*it];
+        }
+    }
+
+    // Chart
+    ofstream chart;
+    chart.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    chart.open(accountsFile, ios::binary);
+    if (!chart) {
+        throw runtime_error("Unable to open chart file for writing: " + accountsFile);
+    }
+    ChecksumSection section;
+    string record;
+    string sealed;
+    char line[64];
+    for (int account: accounts) {
+        long long balance = cents[account];
+        long long whole = llabs(balance) / 100;
+        int length = snprintf(line, sizeof(line), " %s%lld.%02lld", balance < 0 ? "-" : "", whole,
+                              llabs(balance) % 100);
+        record = to_string(account) + ' ' + drawDescription();
+        record.append(line, length);
+        sealed.clear();
+        RecordChecksum::seal(sealed, record);
+        section.add(sealed);
+        chart << sealed;
+    }
+    chart << section.trailer();
+    if (!chart) {
+        throw runtime_error("Error while writing chart file: " + accountsFile);
+    }
+    return leaves.empty() ? 0 : config.transactions;
+}
+
+/**
+ * @brief Creates a sampler over ranks 1..n.
+ *
+ * @param n The number of ranks.
+ * @param exponent The Zipf exponent (0 for uniform).
+ */
+ZipfSampler::ZipfSampler(long long n, double exponent) : n(max(1LL, n)), exponent(exponent) {
+    hIntegralX1 = hIntegral(1.5) - 1.0;
+    hIntegralN = hIntegral(this->n + 0.5);
+    s = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+}
+
+/**
+ * @brief Draws one rank.
+ *
+ * @param rng The random source.
+ * @return A rank in 1..n.
+ */
+long long ZipfSampler::sample(mt19937_64 &rng) const {
+    if (exponent <= 0.0) {
+        return 1 + static_cast<long long>(rng() % static_cast<uint64_t>(n));
+    }
+
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    while (true) {
+        double u = hIntegralN + uniform(rng) * (hIntegralX1 - hIntegralN);
+        double x = hIntegralInverse(u);
+        long long k = static_cast<long long>(x + 0.5);
+        if (k < 1) k = 1;
+        else if (k > n) k = n;
+        if (k - x <= s || u >= hIntegral(k + 0.5) - h(static_cast<double>(k))) {
+            return k;
+        }
+    }
+}
+
+double ZipfSampler::h(double x) const {
+    return exp(-exponent * log(x));
+}
+
+double ZipfSampler::hIntegral(double x) const {
+    double logX = log(x);
+    return helper2((1.0 - exponent) * logX) * logX;
+}
+
+double ZipfSampler::hIntegralInverse(double x) const {
+    double t = x * (1.0 - exponent);
+    if (t < -1.0) {
+        t = -1.0;  // Guard against rounding just past the domain
+    }
+    return exp(helper1(t) * x);
+}
+
+double ZipfSampler::helper1(double x) {
+    return fabs(x) > 1e-8 ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+double ZipfSampler::helper2(double x) {
+    return fabs(x) > 1e-8 ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
@@ -0,0 +1,132 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_LEDGERGENERATOR_H
+#define ADS_MIDTERM_PROJECT_LEDGERGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @struct GeneratorConfig
+ * @brief Shape of a synthetic chart of accounts and ledger.
+ */
+struct GeneratorConfig {
+    uint64_t seed = 42;               ///< Seed; the same seed always produces the same files
+    int roots = 9;                    ///< Number of root accounts (1-9)
+    int depth = 5;                    ///< Maximum number of digits in an account number (1-9)
+    int fanout = 10;                  ///< Maximum children per account (1-10, one per trailing digit)
+    double fanoutSkew = 0.0;          ///< 0 gives every account `fanout` children; larger values favour fewer
+    long long accounts = 10000;       ///< Number of accounts to generate (upper bound)
+    int minDescriptionWords = 1;      ///< Shortest account description, in words
+    int maxDescriptionWords = 4;      ///< Longest account description, in words
+    long long transactions = 100000;  ///< Number of ledger transactions to generate
+    double zipfExponent = 1.1;        ///< Skew of account activity; 0 is uniform
+    int startYear = 2024;             ///< First year of transaction dates
+    int years = 1;                    ///< Number of years the dates are spread over
+};
+
+/**
+ * @class LedgerGenerator
+ * @brief Writes realistic, reproducible charts of accounts and ledgers for scale testing.
+ *
+ * The chart is written in the exact format read by `Account::operator>>` (account number, description, balance),
+ * in pre-order so every parent precedes its children. The ledger is written next to it in the
+ * `<name>_transactions.txt` format read by `ForestTree::loadTransactions`. Transactions are posted to leaf accounts
+ * with Zipf-distributed activity, and every balance in the chart equals the rollup of its ledger, so a generated
+ * dataset is internally consistent. Both files are streamed, so the ledger size is bounded only by disk space.
+ */
+class LedgerGenerator {
+private:
+    GeneratorConfig config;  ///< The dataset shape
+    vector<int> accounts;    ///< Generated account numbers, in pre-order
+    vector<int> leaves;      ///< Accounts without children, shuffled so activity rank does not follow numbering
+    mt19937_64 rng;          ///< Deterministic random source
+
+public:
+    /**
+     * @brief Creates a generator and lays out the chart of accounts.
+     *
+     * @param config The dataset shape
+     */
+    explicit LedgerGenerator(const GeneratorConfig &config);
+
+    /**
+     * @brief Returns the generated account numbers, in pre-order.
+     *
+     * @return The account numbers
+     */
+    const vector<int> &getAccounts() const;
+
+    /**
+     * @brief Writes the ledger and the chart of accounts.
+     *
+     * @param accountsFile The chart file; the ledger is written to the matching `_transactions.txt` file
+     * @return The number of transactions written
+     * @throws runtime_error If either file cannot be written
+     */
+    long long writeFiles(const string &accountsFile);
+
+private:
+    /**
+     * @brief Generates the account numbers breadth-first, then orders them for output.
+     */
+    void generateChart();
+
+    /**
+     * @brief Draws how many children an account gets, applying the fan-out skew.
+     */
+    int drawFanout();
+
+    /**
+     * @brief Builds a description of `minDescriptionWords`-`maxDescriptionWords` words.
+     */
+    string drawDescription();
+};
+
+/**
+ * @class ZipfSampler
+ * @brief Draws ranks 1..n with probability proportional to 1 / rank^exponent in O(1) per sample.
+ *
+ * Uses rejection-inversion sampling (Hörmann and Derflinger), which needs no table, so it scales to millions of
+ * ranks.
+ */
+class ZipfSampler {
+private:
+    long long n;               ///< Number of ranks
+    double exponent;           ///< Zipf exponent
+    double hIntegralX1;        ///< H(1.5) - 1
+    double hIntegralN;         ///< H(n + 0.5)
+    double s;                  ///< Acceptance shortcut threshold
+
+public:
+    /**
+     * @brief Creates a sampler over ranks 1..n.
+     *
+     * @param n The number of ranks
+     * @param exponent The Zipf exponent (0 for uniform)
+     */
+    ZipfSampler(long long n, double exponent);
+
+    /**
+     * @brief Draws one rank.
+     *
+     * @param rng The random source
+     * @return A rank in 1..n
+     */
+    long long sample(mt19937_64 &rng) const;
+
+private:
+    double h(double x) const;
+    double hIntegral(double x) const;
+    double hIntegralInverse(double x) const;
+    static double helper1(double x);
+    static double helper2(double x);
+};
+
+#endif //ADS_MIDTERM_PROJECT_LEDGERGENERATOR_H
@@ -0,0 +1,318 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file PersistenceWorker.cpp
+ * @brief Implements `PersistenceWorker`, the background I/O thread behind asynchronous saves.
+ */
+
+#include "PersistenceWorker.h"
+#include "ForestMetrics.h"
+#include "ForestTrace.h"
+#include "AtomicFileWriter.h"
+#include <iostream>
+#include <cstdio>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Largest number of bytes the I/O thread coalesces into one batch.
+ */
+static const size_t MAX_BATCH_BYTES = 8u << 20;
+
+/**
+ * @brief Flushes a stdio stream and optionally forces its data to the device.
+ *
+ * @param file The open stream.
+ * @param sync Whether to fsync after flushing.
+ * @return True on success.
+ */
+static bool flushFile(FILE *file, bool sync) {
+    return fflush(file) == 0 && (!sync || AtomicFileWriter::syncFile(file));
+}
+
+/**
+ * @brief Starts the I/O thread for a file.
+ *
+ * @param filename The file to maintain. It is only created once the first change is written.
+ * @param syncWrites Whether each batch is fsynced before it counts as durable.
+ */
+PersistenceWorker::PersistenceWorker(const string &filename, bool syncWrites)
+        : filename(filename), syncWrites(syncWrites), nextSequence(1), running(true), sleeping(false), durable(0),
+          failed(false), failedUpTo(0) {
+    tail = new Node();
+    head.store(tail);
+    ioThread = thread(&PersistenceWorker::run, this);
+}
+
+/**
+ * @brief Writes everything still queued, then stops the I/O thread.
+ *
+ * A replacement kept from a failed write is tried once more first; if it fails again, that is reported on stderr.
+ */
+PersistenceWorker::~PersistenceWorker() {
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        running = false;
+    }
+    wakeup.notify_one();
+    ioThread.join();
+    delete tail;
+}
+
+/**
+ * @brief Queues a change without waiting for it to be written. Safe to call from any thread.
+ *
+ * @param kind Whether to append `text` or replace the file with it.
+ * @param text The bytes to append, or the new file contents.
+ * @return The sequence number of the change, for `waitDurable`.
+ */
+uint64_t PersistenceWorker::submit(ChangeRecord::Kind kind, string text) {
+    Node *node = new Node();
+    node->record.kind = kind;
+    node->record.text = move(text);
+    node->record.sequence = nextSequence.fetch_add(1);
+    uint64_t sequence = node->record.sequence;
+
+    // Vyukov MPSC push: swap in the new head, then link the previous head to it
+    Node *previous = head.exchange(node);
+    previous->next.store(node);
+
+    // The I/O thread sets `sleeping` before its final emptiness check, so either it sees this node or we see it asleep
+    if (sleeping.load()) {
+        lock_guard<mutex> lock(sleepMutex);
+        wakeup.notify_one();
+    }
+    return sequence;
+}
+
+/**
+ * @brief Removes the oldest record from the queue. I/O thread only.
+ *
+ * @param record Receives the record.
+ * @return False if the queue is empty (or a push is still being linked).
+ */
+bool PersistenceWorker::pop(ChangeRecord &record) {
+    Node *next = tail->next.load();
+    if (!next) {
+        return false;
+    }
+    record = move(next->record);
+    delete tail;
+    tail = next;  // The popped node becomes the new stub
+    return true;
+}
+
+/**
+ * @brief Checks whether the queue has a record ready to pop. I/O thread only.
+ *
+ * @return True if `pop` would succeed.
+ */
+bool PersistenceWorker::hasPending() const {
+    return tail->next.load() != nullptr;
+}
+
+/**
+ * @brief I/O thread body: drain, coalesce, write, publish, repeat until stopped and empty.
+ */
+void PersistenceWorker::run() {
+    // Records can be dequeued out of sequence order when producers race, so durability is published only up to
+    // the highest sequence number below which nothing is still outstanding
+    priority_queue<uint64_t, vector<uint64_t>, greater<uint64_t>> written;
+    uint64_t durableUpTo = 0;
+
+    // The batch being written. It is only cleared once written, so a failed batch is carried into the next attempt.
+    string replacement;
+    string appended;
+    bool replace = false;
+    vector<uint64_t> sequences;
+    bool retriedOnStop = false;
+
+    while (true) {
+        if (!hasPending()) {
+            if (!running) {
+                // A producer may have swapped the head but not linked it yet; only stop once the queue is settled
+                if (head.load() != tail) {
+                    this_thread::yield();
+                    continue;
+                }
+                if (!(failed && replace) || retriedOnStop) {
+                    if (failed) {
+                        cerr << "Error: stopping with changes to " << filename << " that could not be written" << endl;
+                    }
+                    return;
+                }
+                // A kept replacement gets one last attempt before the thread stops
+                retriedOnStop = true;
+            } else {
+                {
+                    unique_lock<mutex> lock(sleepMutex);
+                    sleeping.store(true);
+                    if (!hasPending() && running) {
+                        wakeup.wait_for(lock, chrono::milliseconds(50));
+                    }
+                    sleeping.store(false);
+                }
+                // A failed replacement is retried after the pause even when nothing new has arrived
+                if (!(failed && replace)) {
+                    continue;
+                }
+            }
+        }
+
+        FOREST_TRACE_SPAN("persist batch");
+        // After a failed append the file may end in a torn line, so appends wait for a replacement, which makes them
+        // redundant anyway; until then they are not even kept, only their sequence numbers
+        bool awaitingReplace = failed && !replace;
+        ChangeRecord record;
+        while ((awaitingReplace || replacement.size() + appended.size() < MAX_BATCH_BYTES) && pop(record)) {
+            sequences.push_back(record.sequence);
+            if (record.kind == ChangeRecord::Replace) {
+                // A full replacement makes every append queued before it redundant
+                replacement = move(record.text);
+                appended.clear();
+                replace = true;
+                awaitingReplace = false;
+            } else if (!awaitingReplace) {
+                appended += record.text;
+            }
+        }
+        if (awaitingReplace) {
+            continue;
+        }
+
+        if (!writeChanges(filename, syncWrites, replacement, replace, appended)) {
+            cerr << "Error: failed to persist changes to " << filename << endl;
+            if (!replace) {
+                appended.clear();
+            }
+            lock_guard<mutex> lock(durableMutex);
+            failed = true;
+            failedUpTo = max(failedUpTo.load(), *max_element(sequences.begin(), sequences.end()));
+            durableChanged.notify_all();
+            continue;
+        }
+
+        for (uint64_t sequence: sequences) {
+            written.push(sequence);
+        }
+        replacement.clear();
+        appended.clear();
+        replace = false;
+        sequences.clear();
+        while (!written.empty() && written.top() == durableUpTo + 1) {
+            durableUpTo = written.top();
+            written.pop();
+        }
+        {
+            lock_guard<mutex> lock(durableMutex);
+            durable = durableUpTo;
+            failed = false;
+        }
+        durableChanged.notify_all();
+    }
+}
+
+/**
+ * @brief Writes one coalesced batch of changes to a file on the calling thread.
+ *
+ * @param filename The file to change.
+ * @param syncWrites Whether to fsync before returning.
+ * @param replacement The new file contents, if `replace` is set.
+ * @param replace Whether the file is replaced (through a temp file and a rename) rather than appended to.
+ * @param appended Bytes to append after the replacement (or to the existing file).
+ * @return True if the batch reached the disk.
+ */
+bool PersistenceWorker::writeChanges(const string &filename, bool syncWrites, const string &replacement, bool replace,
+                                     const string &appended) {
+    if (replace) {
+        // Write the new contents beside the file and rename over it, so a crash leaves the old or the new file
+        try {
+            AtomicFileWriter writer(filename, syncWrites);
+            writer.write(replacement);
+            writer.write(appended);
+            FOREST_METRIC_ADD(MetricCounter::BytesWritten, writer.commit());
+            return true;
+        } catch (const runtime_error &e) {
+            cerr << "Error: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    if (appended.empty()) {
+        return true;
+    }
+    FILE *file = fopen(filename.c_str(), "ab");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(appended.data(), 1, appended.size(), file) == appended.size() && flushFile(file, syncWrites);
+    ok = fclose(file) == 0 && ok;
+    if (ok) {
+        FOREST_METRIC_ADD(MetricCounter::BytesWritten, appended.size());
+    }
+    return ok;
+}
+
+/**
+ * @brief Blocks until a change, and every change before it, is on disk.
+ *
+ * @param sequence A sequence number returned by `submit`.
+ * @return True once it is durable, false if a write holding it failed first.
+ */
+bool PersistenceWorker::waitDurable(uint64_t sequence) {
+    unique_lock<mutex> lock(durableMutex);
+    durableChanged.wait(lock, [this, sequence] { return durable >= sequence || failedUpTo >= sequence; });
+    return durable >= sequence;
+}
+
+/**
+ * @brief Checks whether the last write failed, so the next change should replace the whole file.
+ *
+ * @return True until a write succeeds again.
+ */
+bool PersistenceWorker::hasFailed() const {
+    return failed.load();
+}
+
+/**
+ * @brief Blocks until every change submitted so far is on disk.
+ *
+ * @return True once they are durable, false if a write failed first.
+ */
+bool PersistenceWorker::flush() {
+    return waitDurable(lastSequence());
+}
+
+/**
+ * @brief Returns the highest sequence number known to be on disk, with every change before it.
+ *
+ * @return The sequence number, or 0 if nothing has been written yet.
+ */
+uint64_t PersistenceWorker::durableSequence() const {
+    return durable.load();
+}
+
+/**
+ * @brief Returns the sequence number of the most recently submitted change.
+ *
+ * @return The sequence number, or 0 if nothing has been submitted.
+ */
+uint64_t PersistenceWorker::lastSequence() const {
+    return nextSequence.load() - 1;
+}
+
+/**
+ * @brief Returns the file this worker maintains.
+ *
+ * @return The file name.
+ */
+const string &PersistenceWorker::getFilename() const {
+    return filename;
+}
@@ -0,0 +1,190 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_PERSISTENCEWORKER_H
+#define ADS_MIDTERM_PROJECT_PERSISTENCEWORKER_H
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @struct ChangeRecord
+ * @brief One change to a persisted file, as queued for the I/O thread.
+ */
+struct ChangeRecord {
+    /**
+     * @brief What the record does to the file.
+     */
+    enum Kind {
+        Append,   ///< Append `text` to the end of the file
+        Replace   ///< Replace the whole file with `text`
+    };
+
+    Kind kind = Append;     ///< What the record does
+    uint64_t sequence = 0;  ///< Assigned by `PersistenceWorker::submit`, increasing by one per record
+    string text;            ///< The bytes to append, or the new file contents
+};
+
+/**
+ * @class PersistenceWorker
+ * @brief Owns one file and writes the changes queued for it on a dedicated I/O thread.
+ *
+ * Producers call `submit` with an append or a full replacement and get a sequence number back immediately; the record
+ * goes onto a lock-free multi-producer queue, so posting never waits for the disk. The I/O thread drains everything
+ * queued, coalesces it (a replacement discards the appends queued before it) and issues one large write per batch:
+ * an `O_APPEND` write for appends, or a temp file plus rename for a replacement, followed by an fsync when
+ * `syncWrites` is set. It then publishes the highest sequence number whose record, and every record before it, is
+ * on disk.
+ *
+ * A batch that fails to write is kept rather than dropped. A failed replacement is retried as it is. After a failed
+ * append the file may end in a torn line, so nothing more is written until a replacement arrives; `hasFailed` tells
+ * the producer to send one. The kept records become durable with the first write that succeeds.
+ *
+ * Callers choose per change whether to wait (`waitDurable`) or fire and forget.
+ */
+class PersistenceWorker {
+private:
+    /**
+     * @brief Queue node. The queue always holds one node whose record has already been consumed (the stub).
+     */
+    struct Node {
+        atomic<Node *> next{nullptr};   ///< The next node, published by the producer that linked it
+        ChangeRecord record;            ///< The queued change
+    };
+
+    string filename;                    ///< The file being maintained
+    bool syncWrites;                    ///< Whether each batch is fsynced before it counts as durable
+
+    atomic<Node *> head;                ///< Most recently pushed node, swapped in by producers
+    Node *tail;                         ///< Stub node, owned by the I/O thread
+    atomic<uint64_t> nextSequence;      ///< The sequence number of the next submitted record
+
+    atomic<bool> running;               ///< Cleared by the destructor
+    atomic<bool> sleeping;              ///< Set while the I/O thread is parked on `wakeup`
+    mutex sleepMutex;                   ///< Guards parking and waking the I/O thread
+    condition_variable wakeup;          ///< Wakes the I/O thread when records arrive
+
+    atomic<uint64_t> durable;           ///< Every record up to this sequence number is on disk
+    atomic<bool> failed;                ///< Set while the last write failed, cleared once one succeeds
+    atomic<uint64_t> failedUpTo;        ///< The highest sequence number held by a batch whose write failed
+    mutex durableMutex;                 ///< Guards waiting on `durableChanged`
+    condition_variable durableChanged;  ///< Signalled whenever `durable` advances or a write fails
+
+    thread ioThread;                    ///< The I/O thread
+
+    /**
+     * @brief Removes the oldest record from the queue. I/O thread only.
+     *
+     * @param record Receives the record.
+     * @return False if the queue is empty (or a push is still being linked).
+     */
+    bool pop(ChangeRecord &record);
+
+    /**
+     * @brief Checks whether the queue has a record ready to pop. I/O thread only.
+     *
+     * @return True if `pop` would succeed.
+     */
+    bool hasPending() const;
+
+    /**
+     * @brief I/O thread body: drain, coalesce, write, publish, repeat until stopped and empty.
+     */
+    void run();
+
+public:
+    /**
+     * @brief Starts the I/O thread for a file.
+     *
+     * @param filename The file to maintain. It is only created once the first change is written.
+     * @param syncWrites Whether each batch is fsynced before it counts as durable.
+     */
+    explicit PersistenceWorker(const string &filename, bool syncWrites = true);
+
+    /**
+     * @brief Writes everything still queued, then stops the I/O thread.
+     *
+     * A replacement kept from a failed write is tried once more first; if it fails again, that is reported on stderr.
+     */
+    ~PersistenceWorker();
+
+    PersistenceWorker(const PersistenceWorker &) = delete;
+    PersistenceWorker &operator=(const PersistenceWorker &) = delete;
+
+    /**
+     * @brief Queues a change without waiting for it to be written. Safe to call from any thread.
+     *
+     * @param kind Whether to append `text` or replace the file with it.
+     * @param text The bytes to append, or the new file contents.
+     * @return The sequence number of the change, for `waitDurable`.
+     */
+    uint64_t submit(ChangeRecord::Kind kind, string text);
+
+    /**
+     * @brief Blocks until a change, and every change before it, is on disk.
+     *
+     * @param sequence A sequence number returned by `submit`.
+     * @return True once it is durable, false if a write holding it failed first.
+     */
+    bool waitDurable(uint64_t sequence);
+
+    /**
+     * @brief Checks whether the last write failed, so the next change should replace the whole file.
+     *
+     * @return True until a write succeeds again.
+     */
+    bool hasFailed() const;
+
+    /**
+     * @brief Blocks until every change submitted so far is on disk.
+     *
+     * @return True once they are durable, false if a write failed first.
+     */
+    bool flush();
+
+    /**
+     * @brief Returns the highest sequence number known to be on disk, with every change before it.
+     *
+     * @return The sequence number, or 0 if nothing has been written yet.
+     */
+    uint64_t durableSequence() const;
+
+    /**
+     * @brief Returns the sequence number of the most recently submitted change.
+     *
+     * @return The sequence number, or 0 if nothing has been submitted.
+     */
+    uint64_t lastSequence() const;
+
+    /**
+     * @brief Returns the file this worker maintains.
+     *
+     * @return The file name.
+     */
+    const string &getFilename() const;
+
+    /**
+     * @brief Writes one coalesced batch of changes to a file on the calling thread.
+     *
+     * The I/O thread uses this for every batch; it is also how changes are written when no worker is running.
+     *
+     * @param filename The file to change.
+     * @param syncWrites Whether to fsync before returning.
+     * @param replacement The new file contents, if `replace` is set.
+     * @param replace Whether the file is replaced (through a temp file and a rename) rather than appended to.
+     * @param appended Bytes to append after the replacement (or to the existing file).
+     * @return True if the batch reached the disk.
+     */
+    static bool writeChanges(const string &filename, bool syncWrites, const string &replacement, bool replace,
+                             const string &appended);
+};
+
+#endif //ADS_MIDTERM_PROJECT_PERSISTENCEWORKER_H
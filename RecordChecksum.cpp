@@ -0,0 +1,256 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file RecordChecksum.cpp
+ * @brief Implements the checksum trailers of persisted records and file sections, and `RecordReader`.
+ */
+
+#include "RecordChecksum.h"
+#include "Crc32c.h"
+#include <iostream>
+
+using namespace std;
+
+/**
+ * @brief Marks the start of a record's checksum trailer.
+ */
+static const char RECORD_MARK[] = "|#";
+
+/**
+ * @brief Length of a record's checksum trailer: the mark and eight hex digits.
+ */
+static const size_t RECORD_TRAILER_SIZE = 10;
+
+/**
+ * @brief Starts a section trailer line.
+ */
+static const char SECTION_MARK[] = "#section ";
+
+/**
+ * @brief Appends a checksum as eight lowercase hex digits.
+ *
+ * @param out The text being built
+ * @param crc The checksum
+ */
+static void appendHex(string &out, uint32_t crc) {
+    static const char DIGITS[] = "0123456789abcdef";
+    for (int shift = 28; shift >= 0; shift -= 4) {
+        out += DIGITS[(crc >> shift) & 0xF];
+    }
+}
+
+/**
+ * @brief Parses eight hex digits.
+ *
+ * @param text The digits
+ * @param crc Receives the value
+ * @return False if `text` is not exactly eight hex digits.
+ */
+static bool parseHex(string_view text, uint32_t &crc) {
+    if (text.size() != 8) {
+        return false;
+    }
+    crc = 0;
+    for (char c: text) {
+        uint32_t digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else return false;
+        crc = (crc << 4) | digit;
+    }
+    return true;
+}
+
+/**
+ * @brief Adds written record lines to the section.
+ *
+ * @param lines Whole lines, each ending in a newline.
+ */
+void ChecksumSection::add(string_view lines) {
+    crc = Crc32c::extend(crc, lines.data(), lines.size());
+    bytes += lines.size();
+}
+
+/**
+ * @brief Adds one line read back without its newline.
+ *
+ * @param line The line, as returned by `getline`.
+ */
+void ChecksumSection::addLine(string_view line) {
+    crc = Crc32c::extend(crc, line.data(), line.size());
+    crc = Crc32c::extend(crc, "\n", 1);
+    bytes += line.size() + 1;
+}
+
+/**
+ * @brief Formats the trailer line that closes the section.
+ *
+ * @return `#section <bytes> <crc>` followed by a newline.
+ */
+string ChecksumSection::trailer() const {
+    string line = SECTION_MARK;
+    line += to_string(bytes);
+    line += ' ';
+    appendHex(line, crc);
+    line += '\n';
+    return line;
+}
+
+/**
+ * @brief Checks a trailer line read back against the lines added since the last reset.
+ *
+ * @param line The trailer line, without its newline.
+ * @return True if its byte count and checksum match.
+ */
+bool ChecksumSection::matches(string_view line) const {
+    string_view mark(SECTION_MARK);
+    if (line.substr(0, mark.size()) != mark) {
+        return false;
+    }
+    line.remove_prefix(mark.size());
+    size_t space = line.find(' ');
+    uint32_t expected;
+    return space != string_view::npos && line.substr(0, space) == to_string(bytes) &&
+           parseHex(line.substr(space + 1), expected) && expected == crc;
+}
+
+/**
+ * @brief Starts a new section.
+ */
+void ChecksumSection::reset() {
+    bytes = 0;
+    crc = 0;
+}
+
+/**
+ * @brief Appends a record with its checksum trailer and a newline.
+ *
+ * @param out The text being built
+ * @param record The record, without a newline
+ */
+void RecordChecksum::seal(string &out, string_view record) {
+    out.append(record.data(), record.size());
+    out += RECORD_MARK;
+    appendHex(out, Crc32c::compute(record));
+    out += '\n';
+}
+
+/**
+ * @brief Checks a line read back and strips its checksum trailer.
+ *
+ * @param line The line, without its newline. On `Valid`, it is shortened to the record text.
+ * @return Whether the line carried a checksum, and whether it matched.
+ */
+RecordChecksum::Status RecordChecksum::open(string &line) {
+    if (line.size() < RECORD_TRAILER_SIZE || line.compare(line.size() - RECORD_TRAILER_SIZE, 2, RECORD_MARK) != 0) {
+        // A line cut short inside its trailer still shows the mark; anything else predates checksums
+        return line.find(RECORD_MARK) == string::npos ? Unchecked : Corrupt;
+    }
+    size_t recordSize = line.size() - RECORD_TRAILER_SIZE;
+    uint32_t expected;
+    if (!parseHex(string_view(line).substr(recordSize + 2), expected) ||
+        Crc32c::compute(string_view(line.data(), recordSize)) != expected) {
+        return Corrupt;
+    }
+    line.resize(recordSize);
+    return Valid;
+}
+
+/**
+ * @brief Starts reading a file.
+ *
+ * @param in The open file
+ * @param filename Its name, for messages
+ * @param report Receives the counts
+ */
+RecordReader::RecordReader(istream &in, const string &filename, IntegrityReport &report)
+        : in(in), filename(filename), report(report) {}
+
+/**
+ * @brief Reads the next intact record.
+ *
+ * @param record Receives the record text, without its checksum trailer or newline.
+ * @return False once the file is exhausted.
+ */
+bool RecordReader::next(string &record) {
+    while (getline(in, record)) {
+        ++lineNumber;
+        if (in.eof() && !record.empty()) {
+            // getline only stops at the end of the file when the last line has no newline
+            report.tornTail = true;
+            torn = true;
+            cerr << "Warning: " << filename << " ends in the middle of line " << lineNumber << endl;
+        }
+
+        if (RecordChecksum::isSectionTrailer(record)) {
+            if (section.matches(record)) {
+                ++report.sections;
+            } else {
+                ++report.badSections;
+                noteCorrupt("section trailer");
+            }
+            section.reset();
+            checkedInSection = false;
+            continue;
+        }
+
+        section.addLine(record);
+        if (record.empty()) {
+            continue;
+        }
+        switch (RecordChecksum::open(record)) {
+            case RecordChecksum::Corrupt:
+                ++report.corrupt;
+                noteCorrupt("record");
+                continue;
+            case RecordChecksum::Valid:
+                checkedInSection = true;
+                break;
+            case RecordChecksum::Unchecked:
+                // Only sealed records belong to a section; a batch appended to an older file starts after this line
+                ++report.unchecked;
+                section.reset();
+                checkedInSection = false;
+                break;
+        }
+        ++report.records;
+        return true;
+    }
+    finish();
+    return false;
+}
+
+/**
+ * @brief Counts a corrupt record or section, reporting the first one of the file.
+ *
+ * @param what What was corrupt, for the message.
+ */
+void RecordReader::noteCorrupt(const char *what) {
+    if (report.firstCorruptLine == 0) {
+        report.firstCorruptFile = filename;
+        report.firstCorruptLine = lineNumber;
+    }
+    if (corruptHere++ == 0) {
+        cerr << "Error: corrupt " << what << " at " << filename << ":" << lineNumber << endl;
+    }
+}
+
+/**
+ * @brief Checks the end of the file for an unterminated section and reports the totals.
+ */
+void RecordReader::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+    if (!section.empty() && checkedInSection) {
+        // Files written before checksums existed have no trailers at all; only a checksummed section must have one
+        ++report.badSections;
+        noteCorrupt("unterminated section");
+    }
+    if (corruptHere > 1) {
+        cerr << "Error: " << corruptHere << " corrupt records or sections skipped in " << filename << endl;
+    }
+}
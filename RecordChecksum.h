@@ -0,0 +1,193 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_RECORDCHECKSUM_H
+#define ADS_MIDTERM_PROJECT_RECORDCHECKSUM_H
+
+#include <string>
+#include <string_view>
+#include <istream>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @struct IntegrityReport
+ * @brief What checking the records of the chart and transaction files found while loading them.
+ */
+struct IntegrityReport {
+    size_t records = 0;         ///< Intact records loaded
+    size_t unchecked = 0;       ///< Records without a checksum (written before checksums existed), loaded as is
+    size_t corrupt = 0;         ///< Records whose checksum did not match; they were skipped
+    size_t sections = 0;        ///< Section trailers that matched the records before them
+    size_t badSections = 0;     ///< Section trailers that did not match, or a final section left without one
+    bool tornTail = false;      ///< Whether a file ended in the middle of a line
+    string firstCorruptFile;    ///< File holding the first corrupt record or section, if any
+    size_t firstCorruptLine = 0;///< 1-based line of the first corrupt record or section; 0 if none
+
+    /**
+     * @brief Checks whether every record and section was intact.
+     *
+     * @return True if nothing was corrupt, torn or unterminated.
+     */
+    bool clean() const { return corrupt == 0 && badSections == 0 && !tornTail; }
+};
+
+/**
+ * @class ChecksumSection
+ * @brief Running CRC-32C and byte count over the record lines of one file section.
+ *
+ * A section is the set of lines written in one go: a whole saved file, or one batch appended to the transaction file.
+ * It ends with a trailer line `#section <bytes> <crc>`, which lets a loader notice records that are missing,
+ * duplicated or reordered even though each one is intact on its own.
+ */
+class ChecksumSection {
+private:
+    uint64_t bytes = 0;         ///< Bytes of record lines so far, newlines included
+    uint32_t crc = 0;           ///< CRC-32C of those bytes
+
+public:
+    /**
+     * @brief Adds written record lines to the section.
+     *
+     * @param lines Whole lines, each ending in a newline.
+     */
+    void add(string_view lines);
+
+    /**
+     * @brief Adds one line read back without its newline.
+     *
+     * @param line The line, as returned by `getline`.
+     */
+    void addLine(string_view line);
+
+    /**
+     * @brief Checks whether any line was added since the last reset.
+     *
+     * @return True if the section is empty.
+     */
+    bool empty() const { return bytes == 0; }
+
+    /**
+     * @brief Formats the trailer line that closes the section.
+     *
+     * @return `#section <bytes> <crc>` followed by a newline.
+     */
+    string trailer() const;
+
+    /**
+     * @brief Checks a trailer line read back against the lines added since the last reset.
+     *
+     * @param line The trailer line, without its newline.
+     * @return True if its byte count and checksum match.
+     */
+    bool matches(string_view line) const;
+
+    /**
+     * @brief Starts a new section.
+     */
+    void reset();
+};
+
+/**
+ * @class RecordChecksum
+ * @brief Seals single records with a CRC-32C trailer and checks them when they are read back.
+ *
+ * A sealed record is the record text followed by `|#` and eight lowercase hex digits of the CRC-32C of the text. Lines
+ * without the trailer are accepted as unchecked, so files written before checksums existed still load.
+ */
+class RecordChecksum {
+public:
+    /**
+     * @brief How a record read back compares to its checksum.
+     */
+    enum Status {
+        Unchecked,  ///< The line has no checksum trailer
+        Valid,      ///< The checksum matches
+        Corrupt     ///< The checksum does not match
+    };
+
+    /**
+     * @brief Appends a record with its checksum trailer and a newline.
+     *
+     * @param out The text being built
+     * @param record The record, without a newline
+     */
+    static void seal(string &out, string_view record);
+
+    /**
+     * @brief Checks a line read back and strips its checksum trailer.
+     *
+     * @param line The line, without its newline. On `Valid`, it is shortened to the record text.
+     * @return Whether the line carried a checksum, and whether it matched.
+     */
+    static Status open(string &line);
+
+    /**
+     * @brief Checks whether a line is a section trailer rather than a record.
+     *
+     * @param line The line
+     * @return True if it starts with `#`.
+     */
+    static bool isSectionTrailer(string_view line) { return !line.empty() && line[0] == '#'; }
+};
+
+/**
+ * @class RecordReader
+ * @brief Reads the records of a chart or transaction file, verifying every checksum and section trailer.
+ *
+ * Corrupt records are skipped; the first one in each file is reported on `cerr` with its line number, and the totals
+ * are accumulated into an `IntegrityReport`.
+ */
+class RecordReader {
+private:
+    istream &in;                ///< The file being read
+    string filename;            ///< Its name, for messages
+    IntegrityReport &report;    ///< Receives the counts
+    ChecksumSection section;    ///< The section being read
+    size_t lineNumber = 0;      ///< Lines read so far
+    size_t corruptHere = 0;     ///< Corrupt records and sections found in this file
+    bool checkedInSection = false; ///< Whether the current section holds any checksummed record
+    bool torn = false;          ///< Whether this file ends in the middle of a line
+    bool finished = false;      ///< Whether the end of the file was reached and checked
+
+    /**
+     * @brief Counts a corrupt record or section, reporting the first one of the file.
+     *
+     * @param what What was corrupt, for the message.
+     */
+    void noteCorrupt(const char *what);
+
+    /**
+     * @brief Checks the end of the file for an unterminated section and reports the totals.
+     */
+    void finish();
+
+public:
+    /**
+     * @brief Starts reading a file.
+     *
+     * @param in The open file
+     * @param filename Its name, for messages
+     * @param report Receives the counts
+     */
+    RecordReader(istream &in, const string &filename, IntegrityReport &report);
+
+    /**
+     * @brief Reads the next intact record.
+     *
+     * @param record Receives the record text, without its checksum trailer or newline.
+     * @return False once the file is exhausted.
+     */
+    bool next(string &record);
+
+    /**
+     * @brief Checks whether everything read from this file so far was intact.
+     *
+     * @return True if no record or section was corrupt and the file did not end mid-line.
+     */
+    bool intact() const { return corruptHere == 0 && !torn; }
+};
+
+#endif //ADS_MIDTERM_PROJECT_RECORDCHECKSUM_H
@@ -0,0 +1,261 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file SearchIndex.cpp
+ * @brief Implements `SearchIndex`, the trigram index behind description search.
+ */
+
+#include "SearchIndex.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cctype>
+
+using namespace std;
+
+/**
+ * @brief Creates an empty index.
+ */
+SearchIndex::SearchIndex() : liveCount(0), deadCount(0) {}
+
+/**
+ * @brief Indexes (or re-indexes) the description of an account.
+ *
+ * @param accountNumber The account number.
+ * @param description The account description.
+ */
+void SearchIndex::addAccount(int accountNumber, string_view description) {
+    removeAccount(accountNumber);
+    accountDocuments[accountNumber] = addDocument(false, accountNumber, "", description);
+}
+
+/**
+ * @brief Removes an account description from the index.
+ *
+ * @param accountNumber The account number.
+ */
+void SearchIndex::removeAccount(int accountNumber) {
+    auto it = accountDocuments.find(accountNumber);
+    if (it == accountDocuments.end()) {
+        return;
+    }
+    uint32_t id = it->second;
+    accountDocuments.erase(it);
+    removeDocument(id);
+}
+
+/**
+ * @brief Indexes the description of a transaction.
+ *
+ * @param accountNumber The account that owns the transaction.
+ * @param t The transaction.
+ */
+void SearchIndex::addTransaction(int accountNumber, const Transaction &t) {
+    uint32_t id = addDocument(true, accountNumber, t.getTransactionID(), t.getDescription());
+    transactionDocuments.emplace(transactionKey(accountNumber, t.getTransactionID()), id);
+}
+
+/**
+ * @brief Removes one transaction description from the index.
+ *
+ * If several transactions of the account share the same ID, only one of them is removed.
+ *
+ * @param accountNumber The account that owns the transaction.
+ * @param t The transaction.
+ */
+void SearchIndex::removeTransaction(int accountNumber, const Transaction &t) {
+    auto it = transactionDocuments.find(transactionKey(accountNumber, t.getTransactionID()));
+    if (it == transactionDocuments.end()) {
+        return;
+    }
+    uint32_t id = it->second;
+    transactionDocuments.erase(it);
+    removeDocument(id);
+}
+
+/**
+ * @brief Removes every document from the index.
+ */
+void SearchIndex::clear() {
+    documents.clear();
+    postings.clear();
+    accountDocuments.clear();
+    transactionDocuments.clear();
+    liveCount = deadCount = 0;
+}
+
+/**
+ * @brief Returns the number of indexed descriptions.
+ *
+ * @return The live document count.
+ */
+size_t SearchIndex::size() const {
+    return liveCount;
+}
+
+/**
+ * @brief Searches account and transaction descriptions.
+ *
+ * @param text The text to look for.
+ * @param limit The maximum number of hits to return.
+ * @param prefixOnly True to only match descriptions containing a word that starts with `text`.
+ * @return The hits, best first.
+ */
+vector<SearchHit> SearchIndex::search(const string &text, size_t limit, bool prefixOnly) const {
+    vector<SearchHit> hits;
+    string query = fold(text);
+    if (query.empty() || limit == 0) {
+        return hits;
+    }
+
+    // Narrow the candidates through the posting lists, shortest list first
+    vector<uint32_t> candidates;
+    if (query.size() >= 3) {
+        vector<const vector<uint32_t> *> lists;
+        for (uint32_t gram: trigrams(query)) {
+            auto it = postings.find(gram);
+            if (it == postings.end()) {
+                return hits;  // A gram that never occurs cannot match
+            }
+            lists.push_back(&it->second);
+        }
+        sort(lists.begin(), lists.end(),
+             [](const vector<uint32_t> *a, const vector<uint32_t> *b) { return a->size() < b->size(); });
+
+        candidates = *lists[0];
+        for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+            vector<uint32_t> narrowed;
+            set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                             back_inserter(narrowed));
+            candidates.swap(narrowed);
+        }
+    } else {
+        // Queries shorter than a trigram fall back to checking every document
+        candidates.resize(documents.size());
+        for (uint32_t id = 0; id < documents.size(); ++id) {
+            candidates[id] = id;
+        }
+    }
+
+    // Verify and score the candidates
+    vector<pair<int, uint32_t>> scored;
+    for (uint32_t id: candidates) {
+        const Document &doc = documents[id];
+        if (!doc.live) {
+            continue;
+        }
+        int s = score(StringPool::view(doc.folded), query, prefixOnly);
+        if (s > 0) {
+            scored.emplace_back(s, id);
+        }
+    }
+
+    auto better = [this](const pair<int, uint32_t> &a, const pair<int, uint32_t> &b) {
+        if (a.first != b.first) return a.first > b.first;
+        const Document &docA = documents[a.second];
+        const Document &docB = documents[b.second];
+        size_t sizeA = StringPool::view(docA.folded).size();
+        size_t sizeB = StringPool::view(docB.folded).size();
+        if (sizeA != sizeB) return sizeA < sizeB;
+        return docA.accountNumber < docB.accountNumber;
+    };
+    size_t count = min(limit, scored.size());
+    partial_sort(scored.begin(), scored.begin() + count, scored.end(), better);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Document &doc = documents[scored[i].second];
+        hits.push_back({doc.isTransaction, doc.accountNumber, doc.transactionID,
+                        string(StringPool::view(doc.description)), scored[i].first});
+    }
+    return hits;
+}
+
+string SearchIndex::fold(string_view text) {
+    string folded(text);
+    for (char &c: folded) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return folded;
+}
+
+vector<uint32_t> SearchIndex::trigrams(string_view folded) {
+    vector<uint32_t> grams;
+    for (size_t i = 0; i + 3 <= folded.size(); ++i) {
+        grams.push_back((static_cast<uint32_t>(static_cast<unsigned char>(folded[i])) << 16) |
+                        (static_cast<uint32_t>(static_cast<unsigned char>(folded[i + 1])) << 8) |
+                        static_cast<uint32_t>(static_cast<unsigned char>(folded[i + 2])));
+    }
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+int SearchIndex::score(string_view folded, string_view query, bool prefixOnly) {
+    if (folded == query) {
+        return 400;
+    }
+
+    int best = 0;
+    for (size_t pos = folded.find(query); pos != string_view::npos; pos = folded.find(query, pos + 1)) {
+        if (pos == 0) {
+            return 300;  // Description prefix
+        }
+        if (!isalnum(static_cast<unsigned char>(folded[pos - 1]))) {
+            best = 200;  // Word prefix
+        } else if (!prefixOnly && best == 0) {
+            best = 100;  // Plain substring
+        }
+    }
+    return best;
+}
+
+uint32_t SearchIndex::addDocument(bool isTransaction, int accountNumber, const string &transactionID,
+                                  string_view description) {
+    uint32_t id = static_cast<uint32_t>(documents.size());
+    uint32_t folded = StringPool::intern(fold(description));
+    documents.push_back({isTransaction, true, accountNumber, transactionID, StringPool::intern(description), folded});
+    for (uint32_t gram: trigrams(StringPool::view(folded))) {
+        postings[gram].push_back(id);  // IDs only grow, so every list stays sorted
+    }
+    ++liveCount;
+    return id;
+}
+
+void SearchIndex::removeDocument(uint32_t id) {
+    if (id >= documents.size() || !documents[id].live) {
+        return;
+    }
+    documents[id].live = false;
+    --liveCount;
+    ++deadCount;
+
+    if (deadCount > 1024 && deadCount > liveCount) {
+        compact();
+    }
+}
+
+void SearchIndex::compact() {
+    vector<Document> live;
+    live.reserve(liveCount);
+    for (Document &doc: documents) {
+        if (doc.live) {
+            live.push_back(move(doc));
+        }
+    }
+
+    clear();
+    for (const Document &doc: live) {
+        uint32_t id = addDocument(doc.isTransaction, doc.accountNumber, doc.transactionID,
+                                  StringPool::view(doc.description));
+        if (doc.isTransaction) {
+            transactionDocuments.emplace(transactionKey(doc.accountNumber, doc.transactionID), id);
+        } else {
+            accountDocuments[doc.accountNumber] = id;
+        }
+    }
+}
+
+string SearchIndex::transactionKey(int accountNumber, const string &transactionID) {
+    return to_string(accountNumber) + "|" + transactionID;
+}
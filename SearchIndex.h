@@ -0,0 +1,156 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_SEARCHINDEX_H
+#define ADS_MIDTERM_PROJECT_SEARCHINDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @struct SearchHit
+ * @brief One account or transaction whose description matched a search.
+ */
+struct SearchHit {
+    bool isTransaction;   ///< False for an account description, true for a transaction description
+    int accountNumber;    ///< The account (or the account owning the transaction)
+    string transactionID; ///< The transaction ID, empty for accounts
+    string description;   ///< The original description
+    int score;            ///< Relevance score, higher is better
+};
+
+/**
+ * @class SearchIndex
+ * @brief An in-memory trigram index over account and transaction descriptions.
+ *
+ * Every description is lowercased and broken into overlapping three-character grams. A substring search intersects
+ * the posting lists of the query's grams, starting from the shortest, and only the surviving candidates are compared
+ * against the query. Deleted entries are tombstoned and the index is compacted once tombstones outnumber live
+ * entries.
+ */
+class SearchIndex {
+private:
+    struct Document {
+        bool isTransaction;   ///< Kind of document
+        bool live;            ///< False once removed
+        int accountNumber;    ///< Owning account
+        string transactionID; ///< Transaction ID, empty for accounts
+        uint32_t description; ///< `StringPool` handle of the original description
+        uint32_t folded;      ///< `StringPool` handle of the lowercased description used for matching
+    };
+
+    vector<Document> documents;                           ///< All documents, indexed by document ID
+    unordered_map<uint32_t, vector<uint32_t>> postings;   ///< Trigram -> ascending document IDs
+    unordered_map<int, uint32_t> accountDocuments;        ///< Account number -> document ID
+    unordered_multimap<string, uint32_t> transactionDocuments; ///< "account|transactionID" -> document IDs
+    size_t liveCount;                                     ///< Number of live documents
+    size_t deadCount;                                     ///< Number of tombstoned documents
+
+public:
+    /**
+     * @brief Creates an empty index.
+     */
+    SearchIndex();
+
+    /**
+     * @brief Indexes (or re-indexes) the description of an account.
+     *
+     * @param accountNumber The account number
+     * @param description The account description
+     */
+    void addAccount(int accountNumber, string_view description);
+
+    /**
+     * @brief Removes an account description from the index.
+     *
+     * @param accountNumber The account number
+     */
+    void removeAccount(int accountNumber);
+
+    /**
+     * @brief Indexes the description of a transaction.
+     *
+     * @param accountNumber The account that owns the transaction
+     * @param t The transaction
+     */
+    void addTransaction(int accountNumber, const Transaction &t);
+
+    /**
+     * @brief Removes one transaction description from the index.
+     *
+     * @param accountNumber The account that owns the transaction
+     * @param t The transaction
+     */
+    void removeTransaction(int accountNumber, const Transaction &t);
+
+    /**
+     * @brief Removes every document from the index.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of indexed descriptions.
+     *
+     * @return The live document count
+     */
+    size_t size() const;
+
+    /**
+     * @brief Searches account and transaction descriptions.
+     *
+     * Matching is case-insensitive. Results are ranked: exact description, then description prefix, then word
+     * prefix, then any substring, with shorter descriptions first within each group.
+     *
+     * @param text The text to look for
+     * @param limit The maximum number of hits to return
+     * @param prefixOnly True to only match descriptions containing a word that starts with `text`
+     * @return The hits, best first
+     */
+    vector<SearchHit> search(const string &text, size_t limit, bool prefixOnly = false) const;
+
+private:
+    /**
+     * @brief Lowercases a string.
+     */
+    static string fold(string_view text);
+
+    /**
+     * @brief Returns the distinct trigrams of a folded string.
+     */
+    static vector<uint32_t> trigrams(string_view folded);
+
+    /**
+     * @brief Scores a candidate, returning 0 if it does not match.
+     */
+    static int score(string_view folded, string_view query, bool prefixOnly);
+
+    /**
+     * @brief Stores a new document and adds it to the posting lists.
+     */
+    uint32_t addDocument(bool isTransaction, int accountNumber, const string &transactionID,
+                         string_view description);
+
+    /**
+     * @brief Tombstones a document, compacting the index when tombstones dominate.
+     */
+    void removeDocument(uint32_t id);
+
+    /**
+     * @brief Rebuilds the document table and posting lists without tombstones.
+     */
+    void compact();
+
+    /**
+     * @brief Builds the lookup key of a transaction document.
+     */
+    static string transactionKey(int accountNumber, const string &transactionID);
+};
+
+#endif //ADS_MIDTERM_PROJECT_SEARCHINDEX_H
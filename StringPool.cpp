@@ -0,0 +1,201 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file StringPool.cpp
+ * @brief Implements `StringPool`, the interned text shared by every account and transaction.
+ */
+
+#include "StringPool.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Handles per chunk, as a power of two.
+ */
+static const unsigned CHUNK_BITS = 14;
+
+/**
+ * @brief Handles per chunk.
+ */
+static const size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+
+/**
+ * @brief Chunks needed to cover every 32-bit handle.
+ */
+static const size_t MAX_CHUNKS = size_t(1) << (32 - CHUNK_BITS);
+
+/**
+ * @brief Size of the blocks text is copied into.
+ */
+static const size_t BLOCK_SIZE = 64 * 1024;
+
+/**
+ * @brief The text of every handle. A chunk is published once and never moves, so readers need no lock.
+ */
+static atomic<string_view *> chunks[MAX_CHUNKS];
+
+/**
+ * @brief Everything interning touches, guarded by `lock`.
+ */
+struct PoolState {
+    mutex lock;                                 ///< Serialises interning
+    unordered_map<string_view, uint32_t> index; ///< Text to handle
+    vector<unique_ptr<char[]>> blocks;          ///< The stored text
+    vector<unique_ptr<string_view[]>> owned;    ///< The chunks, for ownership
+    char *cursor = nullptr;                     ///< Free space in the current block
+    size_t remaining = 0;                       ///< Bytes left after `cursor`
+    uint64_t next = 1;                          ///< The next handle to give out
+    size_t textBytes = 0;                       ///< Bytes of text stored
+};
+
+/**
+ * @brief Returns the pool's state. It is never destroyed, so texts stay valid during static destruction too.
+ *
+ * @return The state
+ */
+static PoolState &state() {
+    static PoolState *pool = new PoolState;
+    return *pool;
+}
+
+/**
+ * @brief Copies a text into the pool's blocks.
+ *
+ * @param pool The pool, locked
+ * @param text The text
+ * @return The stored copy
+ */
+static string_view copyText(PoolState &pool, string_view text) {
+    char *copy;
+    if (text.size() > BLOCK_SIZE / 4) {
+        // Long texts get their own allocation so they do not waste the tail of a block
+        pool.blocks.emplace_back(new char[text.size()]);
+        copy = pool.blocks.back().get();
+    } else {
+        if (text.size() > pool.remaining) {
+            pool.blocks.emplace_back(new char[BLOCK_SIZE]);
+            pool.cursor = pool.blocks.back().get();
+            pool.remaining = BLOCK_SIZE;
+        }
+        copy = pool.cursor;
+        pool.cursor += text.size();
+        pool.remaining -= text.size();
+    }
+    memcpy(copy, text.data(), text.size());
+    pool.textBytes += text.size();
+    return string_view(copy, text.size());
+}
+
+/**
+ * @brief Copies a text into the pool under the next handle.
+ *
+ * @param pool The pool, locked
+ * @param text The text, not empty
+ * @return The new handle
+ *
+ * @throws length_error If every handle is taken.
+ */
+static uint32_t addText(PoolState &pool, string_view text) {
+    if (pool.next > UINT32_MAX) {
+        throw length_error("String pool is full");
+    }
+    uint32_t handle = static_cast<uint32_t>(pool.next++);
+    string_view stored = copyText(pool, text);
+    atomic<string_view *> &slot = chunks[handle >> CHUNK_BITS];
+    string_view *chunk = slot.load(memory_order_relaxed);
+    if (!chunk) {
+        pool.owned.emplace_back(new string_view[CHUNK_SIZE]);
+        chunk = pool.owned.back().get();
+        chunk[handle & (CHUNK_SIZE - 1)] = stored;
+        slot.store(chunk, memory_order_release);
+    } else {
+        // Readers only ever see this entry through the returned handle, which reaches them after this write
+        chunk[handle & (CHUNK_SIZE - 1)] = stored;
+    }
+    return handle;
+}
+
+/**
+ * @brief Returns the handle of a text, storing the text if it is new.
+ *
+ * @param text The text
+ * @return Its handle; 0 for the empty string
+ *
+ * @throws length_error If the pool already holds 2^32 - 1 distinct texts.
+ */
+uint32_t StringPool::intern(string_view text) {
+    if (text.empty()) {
+        return 0;
+    }
+    PoolState &pool = state();
+    lock_guard<mutex> guard(pool.lock);
+    auto found = pool.index.find(text);
+    if (found != pool.index.end()) {
+        return found->second;
+    }
+    uint32_t handle = addText(pool, text);
+    pool.index.emplace(view(handle), handle);
+    return handle;
+}
+
+/**
+ * @brief Stores a text under a new handle without looking for an earlier copy.
+ *
+ * @param text The text
+ * @return Its handle; 0 for the empty string
+ *
+ * @throws length_error If the pool already holds 2^32 - 1 texts.
+ */
+uint32_t StringPool::store(string_view text) {
+    if (text.empty()) {
+        return 0;
+    }
+    PoolState &pool = state();
+    lock_guard<mutex> guard(pool.lock);
+    return addText(pool, text);
+}
+
+/**
+ * @brief Returns the text of a handle. Safe to call from any thread, without locks.
+ *
+ * @param handle A handle returned by `intern` or `store`
+ * @return The text, valid for the life of the process
+ */
+string_view StringPool::view(uint32_t handle) {
+    if (handle == 0) {
+        return string_view();
+    }
+    return chunks[handle >> CHUNK_BITS].load(memory_order_acquire)[handle & (CHUNK_SIZE - 1)];
+}
+
+/**
+ * @brief Returns the number of texts in the pool, the empty string excluded.
+ *
+ * @return The text count
+ */
+size_t StringPool::size() {
+    PoolState &pool = state();
+    lock_guard<mutex> guard(pool.lock);
+    return static_cast<size_t>(pool.next - 1);
+}
+
+/**
+ * @brief Returns the bytes of text the pool holds.
+ *
+ * @return The text bytes
+ */
+size_t StringPool::bytes() {
+    PoolState &pool = state();
+    lock_guard<mutex> guard(pool.lock);
+    return pool.textBytes;
+}
@@ -0,0 +1,73 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_STRINGPOOL_H
+#define ADS_MIDTERM_PROJECT_STRINGPOOL_H
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class StringPool
+ * @brief The process-wide pool of interned descriptions and text IDs, addressed by 32-bit handles.
+ *
+ * Ledgers repeat the same few descriptions ("Monthly rent", "Payroll") across millions of transactions, so accounts
+ * and transactions store a 4-byte handle instead of their own `string`. Each distinct text is stored once and never
+ * moves or goes away, so a `string_view` of it stays valid for the life of the process.
+ *
+ * Interning takes a mutex to look the text up. Reading a handle back takes no lock: handles index fixed-size chunks
+ * that are published once and never reallocated, so `view` is two loads. Handle 0 is always the empty string.
+ */
+class StringPool {
+public:
+    /**
+     * @brief Returns the handle of a text, storing the text if it is new.
+     *
+     * @param text The text
+     * @return Its handle; 0 for the empty string
+     *
+     * @throws length_error If the pool already holds 2^32 - 1 distinct texts.
+     */
+    static uint32_t intern(string_view text);
+
+    /**
+     * @brief Stores a text under a new handle without looking for an earlier copy.
+     *
+     * For texts that rarely repeat, such as external transaction IDs, this skips the lookup and keeps them out of the
+     * deduplication index. `intern` never returns a handle made here.
+     *
+     * @param text The text
+     * @return Its handle; 0 for the empty string
+     *
+     * @throws length_error If the pool already holds 2^32 - 1 texts.
+     */
+    static uint32_t store(string_view text);
+
+    /**
+     * @brief Returns the text of a handle. Safe to call from any thread, without locks.
+     *
+     * @param handle A handle returned by `intern` or `store`
+     * @return The text, valid for the life of the process
+     */
+    static string_view view(uint32_t handle);
+
+    /**
+     * @brief Returns the number of texts in the pool, the empty string excluded.
+     *
+     * @return The text count
+     */
+    static size_t size();
+
+    /**
+     * @brief Returns the bytes of text the pool holds.
+     *
+     * @return The text bytes
+     */
+    static size_t bytes();
+};
+
+#endif //ADS_MIDTERM_PROJECT_STRINGPOOL_H
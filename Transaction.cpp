@@ -11,9 +11,12 @@
  */
 
 #include "Transaction.h"
+#include "TransactionIdGenerator.h"
+#include "LedgerDate.h"
+#include "StringPool.h"
 #include <iomanip>
-#include <ctime>
 #include <limits>
+#include <cmath>
 
 using namespace std;
 
@@ -22,13 +25,13 @@ using namespace std;
  * @brief Default constructor for the `Transaction` class.
  *
  * Initializes the transaction with default values:
- * - transactionID: an empty string
- * - amount: 0.0
+ * - transactionID: empty (no numeric ID)
+ * - amount: 0 cents
  * - debitCredit: 'D' (Debit)
- * - date: an empty string
- * - description: an empty string
+ * - date: none (day key 0)
+ * - description: an empty string (pool handle 0)
  */
-Transaction::Transaction() : transactionID(""), amount(0.0), debitCredit('D'), date(""), description("") {}
+Transaction::Transaction() : numericID(0), cents(0), dayKey(0), transactionID(0), description(0), debitCredit('D') {}
 
 // Parameterized Constructor
 /**
@@ -44,18 +47,13 @@ Transaction::Transaction() : transactionID(""), amount(0.0), debitCredit('D'), d
  * @param desc The description of the transaction (optional, default is empty string)
  * @param dateStr The date of the transaction (optional, default is empty string)
  */
-Transaction::Transaction(const string &id, double amt, char type, const string &desc, const string &dateStr) {
+Transaction::Transaction(const string &id, double amt, char type, string_view desc, const string &dateStr) {
 
-    transactionID = id;
-    date = dateStr;
-    description = desc;
+    assignID(id);
+    dayKey = dateStr.empty() ? 0 : dateKeyOf(dateStr);
+    description = StringPool::intern(desc);
 
-    if (amt >= 0) {
-        amount = amt;
-    } else {
-        cerr << "Amount must be non-negative. Setting to 0." << endl;
-        amount = 0.0;
-    }
+    setAmount(amt);
 
     if (type == 'D' || type == 'C') {
         debitCredit = type;
@@ -70,10 +68,34 @@ Transaction::Transaction(const string &id, double amt, char type, const string &
 /**
  * @brief Returns the transaction ID.
  *
- * @return The transaction ID
+ * Numeric IDs are only rendered to text here, on output.
+ *
+ * @return The transaction ID, rendered as `FMR<decimal>` when it is numeric
  */
 string Transaction::getTransactionID() const {
-    return transactionID;
+    return numericID != 0 ? TransactionIdGenerator::format(numericID) : string(StringPool::view(transactionID));
+}
+
+/**
+ * @brief Returns the transaction ID as an integer.
+ *
+ * @return The generated ID, or 0 if the ID is not numeric
+ */
+uint64_t Transaction::getNumericID() const {
+    return numericID;
+}
+
+/**
+ * @brief Appends the transaction ID to a text without building a temporary string.
+ *
+ * @param out The text being built
+ */
+void Transaction::appendTransactionID(string &out) const {
+    if (numericID != 0) {
+        TransactionIdGenerator::append(out, numericID);
+    } else {
+        out += StringPool::view(transactionID);
+    }
 }
 
 /**
@@ -82,7 +104,16 @@ string Transaction::getTransactionID() const {
  * @return The transaction amount
  */
 double Transaction::getAmount() const {
-    return amount;
+    return static_cast<double>(cents) / 100.0;
+}
+
+/**
+ * @brief Returns the transaction amount in cents, exactly as stored.
+ *
+ * @return The amount in cents
+ */
+int64_t Transaction::getAmountCents() const {
+    return cents;
 }
 
 /**
@@ -97,50 +128,98 @@ char Transaction::getDebitCredit() const {
 /**
  * @brief Returns the date of the transaction.
  *
- * @return The transaction date
+ * The date is kept as a day key and only rendered to text here, on output.
+ *
+ * @return The transaction date in `DD-MM-YY` form, empty if undated
  */
 string Transaction::getDate() const {
-    return date;
+    return LedgerDate::format(dayKey);
 }
 
 /**
  * @brief Returns the description of the transaction.
  *
- * @return The transaction description
+ * @return The transaction description, valid for the life of the process
+ */
+string_view Transaction::getDescription() const {
+    return StringPool::view(description);
+}
+
+/**
+ * @brief Returns the transaction date as a sortable day key.
+ *
+ * @return The day key, or 0 if the transaction is undated
+ */
+int Transaction::getDayKey() const {
+    return dayKey;
+}
+
+/**
+ * @brief Converts a `DD-MM-YY` date string into a `YYYYMMDD` day key.
+ *
+ * @param dateStr The date to convert
+ * @return The day key, or 0 if the date cannot be parsed
+ */
+int Transaction::toDayKey(const string &dateStr) {
+    return LedgerDate::parse(dateStr);
+}
+
+/**
+ * @brief Returns the transaction month as a sortable month key.
+ *
+ * @return The month key in `YYYYMM` form, or 0 if the transaction is undated
  */
-string Transaction::getDescription() const {
-    return description;
+int Transaction::getMonthKey() const {
+    return dayKey / 100;
 }
 
 // Setters
 
+/**
+ * @brief Stores a transaction ID, as an integer when it is the text form of a generated ID.
+ *
+ * Any other text (IDs from outside, or written before IDs were numeric) goes to the string pool as it is. IDs are
+ * unique, so they are stored without looking for an earlier copy.
+ *
+ * @param id The transaction ID
+ */
+void Transaction::assignID(const string &id) {
+    if (TransactionIdGenerator::parse(id, numericID)) {
+        transactionID = 0;
+    } else {
+        numericID = 0;
+        transactionID = StringPool::store(id);
+    }
+}
+
 /**
  * @brief Sets the transaction ID.
  *
- * @param id The new transaction ID
+ * @param id The new transaction ID; when empty, a new unique ID is generated
  */
 void Transaction::setTransactionID(const string &id) {
     if (id.empty()) {
-        time_t now = time(nullptr);
-        transactionID = "FMR" + to_string(now);
+        numericID = TransactionIdGenerator::next();
+        transactionID = 0;
     } else {
-        transactionID = id;
+        assignID(id);
     }
 }
 
 /**
  * @brief Sets the transaction amount.
  *
- * If the amount is negative, it will be set to 0, and a message will be displayed.
+ * The amount is rounded to whole cents, the precision the ledger keeps. If the amount is negative, it will be set
+ * to 0, and a message will be displayed.
  *
  * @param amt The new transaction amount
  */
 void Transaction::setAmount(double amt) {
     if (amt >= 0) {
-        amount = amt;
+        cents = llround(amt * 100.0);
     } else {
         cerr << "Amount must be non-negative. Setting to 0." << endl;
-        amount = 0.0;
+        cents = 0;
     }
 }
 
@@ -157,19 +236,24 @@ void Transaction::setDebitCredit(char type) {
 /**
  * @brief Sets the date of the transaction.
  *
- * If the date is not provided (empty string), the current date will be used.
+ * If the date is not provided (empty string), the current date will be used. A date that cannot be parsed makes the
+ * transaction invalid.
  *
  * @param dateStr The new transaction date
  */
 void Transaction::setDate(const string &dateStr) {
-    if (dateStr.empty()) {
-        time_t now = time(nullptr);
-        char buffer[11];  // DD-MM-YY\0 needs 9 chars + safety
-        strftime(buffer, sizeof(buffer), "%d-%m-%y", localtime(&now));
-        date = buffer;
-    } else {
-        date = dateStr;
-    }
+    dayKey = dateStr.empty() ? LedgerDate::today() : dateKeyOf(dateStr);
+}
+
+/**
+ * @brief Parses supplied date text into the stored day key.
+ *
+ * @param dateStr The date text, not empty
+ * @return The day key, or `INVALID_DAY` if the text is not a date
+ */
+int32_t Transaction::dateKeyOf(const string &dateStr) {
+    int32_t key = LedgerDate::parse(dateStr);
+    return key != 0 ? key : INVALID_DAY;
 }
 
 /**
@@ -177,8 +261,8 @@ void Transaction::setDate(const string &dateStr) {
  *
  * @param desc The new transaction description
  */
-void Transaction::setDescription(const string &desc) {
-    description = desc;
+void Transaction::setDescription(string_view desc) {
+    description = StringPool::intern(desc);
 }
 
 // Validation
@@ -186,12 +270,13 @@ void Transaction::setDescription(const string &desc) {
 /**
  * @brief Validates the transaction.
  *
- * Checks if the transaction type is either 'D' (Debit) or 'C' (Credit) and if the amount is non-negative.
+ * Checks if the transaction type is either 'D' (Debit) or 'C' (Credit), if the amount is non-negative, and if any
+ * date it was given was a real date.
  *
  * @return True if the transaction is valid, false otherwise
  */
 bool Transaction::isValid() const {
-    return (debitCredit == 'D' || debitCredit == 'C') && amount >= 0;
+    return (debitCredit == 'D' || debitCredit == 'C') && cents >= 0 && dayKey != INVALID_DAY;
 }
 
 // Apply Transaction to Balance
@@ -209,7 +294,7 @@ bool Transaction::applyToBalance(double &balance) const {
         cerr << "Invalid transaction. Cannot apply." << endl;
         return false;
     }
-    balance += (debitCredit == 'D') ? amount : -amount; // Add for debit, subtract for credit
+    balance += getSignedCents() / 100.0; // Add for debit, subtract for credit
     return true;
 }
 
@@ -7,6 +7,9 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <type_traits>
 
 using namespace std;
 
@@ -17,16 +20,38 @@ using namespace std;
  * The `Transaction` class allows for managing individual financial transactions, including their properties such as
  * transaction ID, amount, debit or credit type, date, and description. It also includes methods for validation,
  * applying to a balance, and input/output stream operations for reading and writing transaction data.
+ *
+ * A transaction is a fixed 32-byte record with no owned memory: the ID and date are integers, the amount is whole
+ * cents, and text lives in the `StringPool` behind 4-byte handles. It is trivially copyable, so ledgers copy and
+ * grow as plain memory and loops over them touch two transactions per cache line.
  */
 class Transaction {
 private:
-    string transactionID; ///< The unique identifier for the transaction
-    double amount;        ///< The amount involved in the transaction
-    char debitCredit;     ///< The type of transaction: 'D' for debit, 'C' for credit
-    string date;          ///< The date the transaction occurred
-    string description;   ///< The description of the transaction
+    uint64_t numericID;     ///< The transaction ID when it is a generated `FMR<decimal>` ID, else 0
+    int64_t cents;          ///< The amount involved in the transaction, in cents
+    int32_t dayKey;         ///< The date as a `YYYYMMDD` day key: 0 if undated, `INVALID_DAY` if not a date
+    uint32_t transactionID; ///< `StringPool` handle of the transaction ID when it is not numeric (external or legacy IDs)
+    uint32_t description;   ///< `StringPool` handle of the description of the transaction
+    char debitCredit;       ///< The type of transaction: 'D' for debit, 'C' for credit
+
+    /**
+     * @brief Stores a transaction ID, as an integer when it is the text form of a generated ID.
+     *
+     * @param id The transaction ID
+     */
+    void assignID(const string &id);
+
+    /**
+     * @brief Parses supplied date text into the stored day key.
+     *
+     * @param dateStr The date text, not empty
+     * @return The day key, or `INVALID_DAY` if the text is not a date
+     */
+    static int32_t dateKeyOf(const string &dateStr);
 
 public:
+    static const int32_t INVALID_DAY = -1; ///< The day key of a transaction given date text that is not a date
+
     // Constructors
 
     /**
@@ -49,17 +74,31 @@ public:
      * @param desc The description of the transaction (optional, default is empty string)
      * @param dateStr The date of the transaction (optional, default is empty string)
      */
-    Transaction(const string &id, double amt, char type, const string &desc = "", const string &dateStr = "");
+    Transaction(const string &id, double amt, char type, string_view desc = "", const string &dateStr = "");
 
     // Getters
 
     /**
      * @brief Returns the transaction ID.
      *
-     * @return The transaction ID
+     * @return The transaction ID, rendered as `FMR<decimal>` when it is numeric
      */
     string getTransactionID() const;
 
+    /**
+     * @brief Returns the transaction ID as an integer.
+     *
+     * @return The generated ID, or 0 if the ID is not numeric
+     */
+    uint64_t getNumericID() const;
+
+    /**
+     * @brief Appends the transaction ID to a text without building a temporary string.
+     *
+     * @param out The text being built
+     */
+    void appendTransactionID(string &out) const;
+
     /**
      * @brief Returns the transaction amount.
      *
@@ -67,6 +106,20 @@ public:
      */
     double getAmount() const;
 
+    /**
+     * @brief Returns the transaction amount in cents, exactly as stored.
+     *
+     * @return The amount in cents
+     */
+    int64_t getAmountCents() const;
+
+    /**
+     * @brief Returns the amount with the sign it has on a balance: positive for debits, negative for credits.
+     *
+     * @return The signed amount in cents
+     */
+    int64_t getSignedCents() const { return debitCredit == 'C' ? -cents : cents; }
+
     /**
      * @brief Returns the type of transaction (debit or credit).
      *
@@ -77,30 +130,54 @@ public:
     /**
      * @brief Returns the date of the transaction.
      *
-     * @return The date the transaction occurred
+     * @return The date the transaction occurred, in `DD-MM-YY` form (empty if undated)
      */
     string getDate() const;
 
     /**
      * @brief Returns the description of the transaction.
      *
-     * @return The description of the transaction
+     * @return The description of the transaction, valid for the life of the process
+     */
+    string_view getDescription() const;
+
+    /**
+     * @brief Returns the transaction date as a sortable day key.
+     *
+     * Dates are stored as `YYYYMMDD` integers, so day keys compare chronologically.
+     *
+     * @return The day key, or 0 if the transaction is undated
+     */
+    int getDayKey() const;
+
+    /**
+     * @brief Returns the transaction month as a sortable month key.
+     *
+     * @return The month key in `YYYYMM` form, or 0 if the transaction is undated
      */
-    string getDescription() const;
+    int getMonthKey() const;
+
+    /**
+     * @brief Converts a `DD-MM-YY` date string into a `YYYYMMDD` day key.
+     *
+     * @param dateStr The date to convert
+     * @return The day key, or 0 if the date cannot be parsed
+     */
+    static int toDayKey(const string &dateStr);
 
     // Setters
 
     /**
      * @brief Sets the transaction ID.
      *
-     * @param id The transaction ID to set
+     * @param id The transaction ID to set; when empty, a new unique ID is generated
      */
     void setTransactionID(const string &id);
 
     /**
      * @brief Sets the transaction amount.
      *
-     * @param amt The amount to set
+     * @param amt The amount to set; it is rounded to whole cents
      */
     void setAmount(double amt);
 
@@ -114,7 +191,7 @@ public:
     /**
      * @brief Sets the date of the transaction.
      *
-     * @param dateStr The date to set
+     * @param dateStr The date to set in `DD-MM-YY` form; when empty, today's date is used
      */
     void setDate(const string &dateStr);
 
@@ -123,7 +200,7 @@ public:
      *
      * @param desc The description to set
      */
-    void setDescription(const string &desc);
+    void setDescription(string_view desc);
 
     // Validation
 
@@ -160,6 +237,9 @@ public:
  */
 ostream &operator<<(ostream &os, const Transaction &transaction);
 
+static_assert(is_trivially_copyable<Transaction>::value, "transactions are copied and stored as plain memory");
+static_assert(sizeof(Transaction) <= 32, "a transaction must fit in half a cache line");
+
 /**
  * @brief Input stream operator for Transaction class.
  *
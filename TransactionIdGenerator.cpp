@@ -0,0 +1,192 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file TransactionIdGenerator.cpp
+ * @brief Implements `TransactionIdGenerator`, the lock-free Snowflake-style transaction ID source.
+ */
+
+#include "TransactionIdGenerator.h"
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * @brief Start of the ID timestamps: 2026-01-01 00:00:00 UTC, in milliseconds since the Unix epoch.
+ */
+static const uint64_t EPOCH_MILLIS = 1767225600000ull;
+
+/**
+ * @brief Largest sequence number within one millisecond.
+ */
+static const uint64_t MAX_SEQUENCE = (1ull << TransactionIdGenerator::SEQUENCE_BITS) - 1;
+
+/**
+ * @brief Number of thread slots.
+ */
+static const unsigned SLOT_COUNT = 1u << TransactionIdGenerator::SLOT_BITS;
+
+static_assert(SLOT_COUNT <= 64, "free slots are tracked in one 64-bit mask");
+static_assert(TransactionIdGenerator::TIMESTAMP_BITS + TransactionIdGenerator::NODE_BITS +
+              TransactionIdGenerator::SLOT_BITS + TransactionIdGenerator::SEQUENCE_BITS == 63,
+              "IDs use 63 bits so they stay positive as signed integers");
+
+/**
+ * @brief The node mixed into new IDs.
+ */
+static atomic<unsigned> currentNode(0);
+
+/**
+ * @brief One bit per slot, set while the slot is free.
+ */
+static atomic<uint64_t> freeSlots(~0ull);
+
+/**
+ * @brief The last millisecond each slot used, recorded when its thread exits.
+ */
+static atomic<uint64_t> slotMillis[SLOT_COUNT];
+
+/**
+ * @brief Returns the current time in milliseconds since the ID epoch.
+ *
+ * @return The milliseconds, or 0 if the clock reads earlier than the epoch.
+ */
+static uint64_t currentMillis() {
+    uint64_t now = chrono::duration_cast<chrono::milliseconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+    return now > EPOCH_MILLIS ? now - EPOCH_MILLIS : 0;
+}
+
+/**
+ * @brief A thread's claim on a slot, with the millisecond and sequence it minted last.
+ */
+struct SlotLease {
+    unsigned slot;      ///< The claimed slot
+    uint64_t millis;    ///< Millisecond of the last ID minted
+    uint64_t sequence;  ///< Sequence of the last ID minted
+
+    /**
+     * @brief Claims the lowest free slot and resumes after the last millisecond it used.
+     *
+     * @throws runtime_error If every slot is taken.
+     */
+    SlotLease() {
+        uint64_t free = freeSlots.load();
+        do {
+            if (free == 0) {
+                throw runtime_error("Too many threads minting transaction IDs at once");
+            }
+            slot = static_cast<unsigned>(__builtin_ctzll(free));
+        } while (!freeSlots.compare_exchange_weak(free, free & ~(1ull << slot)));
+        millis = slotMillis[slot].load();
+        sequence = MAX_SEQUENCE;  // The first ID moves on to a later millisecond than any the slot used before
+    }
+
+    /**
+     * @brief Records the last millisecond used and frees the slot.
+     */
+    ~SlotLease() {
+        slotMillis[slot].store(millis);
+        freeSlots.fetch_or(1ull << slot);
+    }
+};
+
+/**
+ * @brief Mints a new ID. Safe to call from any thread.
+ *
+ * @return The ID, never 0.
+ *
+ * @throws runtime_error If more threads than there are slots mint at the same time.
+ */
+uint64_t TransactionIdGenerator::next() {
+    thread_local SlotLease lease;
+
+    uint64_t now = currentMillis();
+    if (now > lease.millis) {
+        lease.millis = now;
+        lease.sequence = 0;
+    } else if (lease.sequence < MAX_SEQUENCE) {
+        ++lease.sequence;
+    } else {
+        // Sequence exhausted (or the clock stepped back): borrow the next millisecond instead of waiting for it
+        ++lease.millis;
+        lease.sequence = 0;
+    }
+
+    return (lease.millis << (NODE_BITS + SLOT_BITS + SEQUENCE_BITS)) |
+           (static_cast<uint64_t>(currentNode.load(memory_order_relaxed)) << (SLOT_BITS + SEQUENCE_BITS)) |
+           (static_cast<uint64_t>(lease.slot) << SEQUENCE_BITS) | lease.sequence;
+}
+
+/**
+ * @brief Sets the node mixed into every ID minted afterwards.
+ *
+ * @param node The node, below 2^NODE_BITS. Processes writing to the same ledger must use different nodes.
+ */
+void TransactionIdGenerator::setNode(unsigned node) {
+    currentNode.store(node & ((1u << NODE_BITS) - 1));
+}
+
+/**
+ * @brief Returns the node mixed into new IDs.
+ *
+ * @return The node
+ */
+unsigned TransactionIdGenerator::getNode() {
+    return currentNode.load();
+}
+
+/**
+ * @brief Renders an ID as text.
+ *
+ * @param id The ID
+ * @return `FMR` followed by the ID in decimal
+ */
+string TransactionIdGenerator::format(uint64_t id) {
+    string text;
+    append(text, id);
+    return text;
+}
+
+/**
+ * @brief Appends the text form of an ID, as `format` renders it.
+ *
+ * @param out The text being built
+ * @param id The ID
+ */
+void TransactionIdGenerator::append(string &out, uint64_t id) {
+    char text[24] = {'F', 'M', 'R'};
+    to_chars_result result = to_chars(text + 3, text + sizeof(text), id);
+    out.append(text, result.ptr);
+}
+
+/**
+ * @brief Recognises the text form of a numeric ID.
+ *
+ * @param text The text, e.g. an ID read from the transaction file
+ * @param id Receives the ID
+ * @return True if `text` is exactly `format(id)` for some nonzero ID, so rendering it again gives the same text.
+ */
+bool TransactionIdGenerator::parse(const string &text, uint64_t &id) {
+    // A leading zero would not survive the round trip
+    if (text.size() < 4 || text.compare(0, 3, "FMR") != 0 || text[3] < '1' || text[3] > '9') {
+        return false;
+    }
+    const char *end = text.data() + text.size();
+    from_chars_result result = from_chars(text.data() + 3, end, id);
+    return result.ec == errc() && result.ptr == end && id < (1ull << 63);
+}
+
+/**
+ * @brief Extracts the wall-clock time at which an ID was minted.
+ *
+ * @param id The ID
+ * @return Milliseconds since the Unix epoch
+ */
+uint64_t TransactionIdGenerator::timestampMillis(uint64_t id) {
+    return (id >> (NODE_BITS + SLOT_BITS + SEQUENCE_BITS)) + EPOCH_MILLIS;
+}
@@ -0,0 +1,96 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TRANSACTIONIDGENERATOR_H
+#define ADS_MIDTERM_PROJECT_TRANSACTIONIDGENERATOR_H
+
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @class TransactionIdGenerator
+ * @brief Mints unique 64-bit transaction IDs, Snowflake style, without locks.
+ *
+ * An ID packs, from the most significant bit down:
+ *
+ *     41 bits  milliseconds since 2026-01-01 UTC (about 69 years)
+ *      5 bits  node: the shard or process, set with `setNode`
+ *      6 bits  slot: the minting thread
+ *     11 bits  sequence within the millisecond
+ *
+ * The top bit stays clear, so IDs are positive as signed integers too. Each thread claims a slot the first time it
+ * mints and keeps its own millisecond and sequence in thread-local state, so minting is a clock read and a few
+ * shifts with no shared writes. When a thread mints more than 2048 IDs within one millisecond it borrows the next
+ * millisecond rather than waiting, so IDs stay unique (and increasing per thread) at any rate. A slot released by an
+ * exiting thread resumes after the last millisecond it used.
+ *
+ * IDs are kept as integers and only rendered as `FMR<decimal>` for output.
+ */
+class TransactionIdGenerator {
+public:
+    static const int SEQUENCE_BITS = 11;    ///< Bits of the per-millisecond sequence
+    static const int SLOT_BITS = 6;         ///< Bits of the thread slot (64 concurrent minting threads)
+    static const int NODE_BITS = 5;         ///< Bits of the node (32 shards or processes)
+    static const int TIMESTAMP_BITS = 41;   ///< Bits of the millisecond timestamp
+
+    /**
+     * @brief Mints a new ID. Safe to call from any thread.
+     *
+     * @return The ID, never 0.
+     *
+     * @throws runtime_error If more threads than there are slots mint at the same time.
+     */
+    static uint64_t next();
+
+    /**
+     * @brief Sets the node mixed into every ID minted afterwards.
+     *
+     * @param node The node, below 2^NODE_BITS. Processes writing to the same ledger must use different nodes.
+     */
+    static void setNode(unsigned node);
+
+    /**
+     * @brief Returns the node mixed into new IDs.
+     *
+     * @return The node
+     */
+    static unsigned getNode();
+
+    /**
+     * @brief Renders an ID as text.
+     *
+     * @param id The ID
+     * @return `FMR` followed by the ID in decimal
+     */
+    static string format(uint64_t id);
+
+    /**
+     * @brief Appends the text form of an ID, as `format` renders it.
+     *
+     * @param out The text being built
+     * @param id The ID
+     */
+    static void append(string &out, uint64_t id);
+
+    /**
+     * @brief Recognises the text form of a numeric ID.
+     *
+     * @param text The text, e.g. an ID read from the transaction file
+     * @param id Receives the ID
+     * @return True if `text` is exactly `format(id)` for some nonzero ID, so rendering it again gives the same text.
+     */
+    static bool parse(const string &text, uint64_t &id);
+
+    /**
+     * @brief Extracts the wall-clock time at which an ID was minted.
+     *
+     * @param id The ID
+     * @return Milliseconds since the Unix epoch
+     */
+    static uint64_t timestampMillis(uint64_t id);
+};
+
+#endif //ADS_MIDTERM_PROJECT_TRANSACTIONIDGENERATOR_H
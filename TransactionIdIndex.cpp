@@ -0,0 +1,234 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file TransactionIdIndex.cpp
+ * @brief Implements `TransactionIdIndex`, the Bloom filter and exact set behind duplicate transaction detection.
+ */
+
+#include "TransactionIdIndex.h"
+#include "TransactionIdGenerator.h"
+
+using namespace std;
+
+/**
+ * @brief Filter bits per expected ID; with 7 bits set per ID this gives about 1% false positives.
+ */
+static const size_t BITS_PER_ID = 10;
+
+/**
+ * @brief Bits set per ID.
+ */
+static const int BITS_SET = 7;
+
+/**
+ * @brief Words per filter block: 8 x 64 bits, one cache line.
+ */
+static const size_t WORDS_PER_BLOCK = 8;
+
+/**
+ * @brief IDs the filter is sized for before the first one arrives.
+ */
+static const size_t INITIAL_CAPACITY = 1024;
+
+/**
+ * @brief The SplitMix64 finalizer, so every bit of a hash is usable.
+ *
+ * @param hash The value to mix
+ * @return The mixed value
+ */
+static uint64_t mix(uint64_t hash) {
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+/**
+ * @brief Hashes a text ID: 64-bit FNV-1a followed by the finalizer.
+ *
+ * @param id The transaction ID
+ * @return The hash
+ */
+size_t TransactionIdIndex::IdHash::operator()(string_view id) const {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c: id) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return static_cast<size_t>(mix(hash));
+}
+
+/**
+ * @brief Hashes a generated ID. Its low bits are a sequence and high bits a timestamp, so it must be mixed.
+ *
+ * @param id The generated ID
+ * @return The hash
+ */
+size_t TransactionIdIndex::IdHash::operator()(uint64_t id) const {
+    return static_cast<size_t>(mix(id));
+}
+
+/**
+ * @brief Creates an empty index.
+ */
+TransactionIdIndex::TransactionIdIndex() : blockMask(0), capacity(0) {
+    rebuild(INITIAL_CAPACITY);
+}
+
+/**
+ * @brief Sizes the filter for a number of IDs and re-adds every ID of the exact set.
+ *
+ * @param count The number of IDs to size for
+ */
+void TransactionIdIndex::rebuild(size_t count) {
+    size_t blockCount = 1;
+    while (blockCount * WORDS_PER_BLOCK * 64 < count * BITS_PER_ID) {
+        blockCount <<= 1;
+    }
+    blocks.assign(blockCount * WORDS_PER_BLOCK, 0);
+    blockMask = blockCount - 1;
+    capacity = count;
+
+    IdHash hasher;
+    for (const string &id: ids) {
+        addToFilter(hasher(id));
+    }
+    for (uint64_t id: numericIds) {
+        addToFilter(hasher(id));
+    }
+}
+
+/**
+ * @brief Sets the filter bits of a hash.
+ *
+ * @param hash The hash of an ID
+ */
+void TransactionIdIndex::addToFilter(uint64_t hash) {
+    uint64_t *block = &blocks[((hash >> 32) & blockMask) * WORDS_PER_BLOCK];
+    // Each 9-bit slice of the low half picks one of the block's 512 bits
+    for (int i = 0; i < BITS_SET; ++i) {
+        unsigned bit = (hash >> (9 * i)) & 511;
+        block[bit >> 6] |= 1ull << (bit & 63);
+    }
+}
+
+/**
+ * @brief Checks the filter bits of a hash.
+ *
+ * @param hash The hash of an ID
+ * @return False if the ID is certainly absent.
+ */
+bool TransactionIdIndex::mayContain(uint64_t hash) const {
+    const uint64_t *block = &blocks[((hash >> 32) & blockMask) * WORDS_PER_BLOCK];
+    for (int i = 0; i < BITS_SET; ++i) {
+        unsigned bit = (hash >> (9 * i)) & 511;
+        if (!(block[bit >> 6] & (1ull << (bit & 63)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Adds a transaction's ID unless it is already present.
+ *
+ * @param transaction The transaction
+ * @return True if the ID was new or empty, false if it is a duplicate.
+ */
+bool TransactionIdIndex::insert(const Transaction &transaction) {
+    uint64_t numericID = transaction.getNumericID();
+    uint64_t hash;
+    if (numericID != 0) {
+        hash = IdHash()(numericID);
+        if (mayContain(hash) && numericIds.count(numericID)) {
+            return false;
+        }
+        numericIds.insert(numericID);
+    } else {
+        string id = transaction.getTransactionID();
+        if (id.empty()) {
+            return true;
+        }
+        hash = IdHash()(id);
+        if (mayContain(hash) && ids.count(id)) {
+            return false;
+        }
+        ids.insert(move(id));
+    }
+    if (size() > capacity) {
+        rebuild(capacity * 2);
+    } else {
+        addToFilter(hash);
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether an ID is present.
+ *
+ * @param id The transaction ID
+ * @return True if a transaction with this ID exists.
+ */
+bool TransactionIdIndex::contains(const string &id) const {
+    uint64_t numericID;
+    if (TransactionIdGenerator::parse(id, numericID)) {
+        return contains(numericID);
+    }
+    return mayContain(IdHash()(id)) && ids.count(id);
+}
+
+/**
+ * @brief Checks whether a generated ID is present.
+ *
+ * @param id The generated ID
+ * @return True if a transaction with this ID exists.
+ */
+bool TransactionIdIndex::contains(uint64_t id) const {
+    return mayContain(IdHash()(id)) && numericIds.count(id);
+}
+
+/**
+ * @brief Removes a transaction's ID, so a transaction with it can be posted again.
+ *
+ * @param transaction The transaction
+ */
+void TransactionIdIndex::erase(const Transaction &transaction) {
+    if (transaction.getNumericID() != 0) {
+        numericIds.erase(transaction.getNumericID());
+    } else {
+        ids.erase(transaction.getTransactionID());
+    }
+}
+
+/**
+ * @brief Removes every ID.
+ */
+void TransactionIdIndex::clear() {
+    ids.clear();
+    numericIds.clear();
+    rebuild(INITIAL_CAPACITY);
+}
+
+/**
+ * @brief Sizes the index for a number of IDs ahead of a bulk load.
+ *
+ * @param count The expected number of IDs
+ */
+void TransactionIdIndex::reserve(size_t count) {
+    numericIds.reserve(count);
+    if (count > capacity) {
+        rebuild(count);
+    }
+}
+
+/**
+ * @brief Returns the number of IDs.
+ *
+ * @return The ID count
+ */
+size_t TransactionIdIndex::size() const {
+    return ids.size() + numericIds.size();
+}
@@ -0,0 +1,127 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TRANSACTIONIDINDEX_H
+#define ADS_MIDTERM_PROJECT_TRANSACTIONIDINDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_set>
+#include <cstddef>
+#include <cstdint>
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @class TransactionIdIndex
+ * @brief The set of transaction IDs present in a forest, used to drop duplicate postings.
+ *
+ * A blocked Bloom filter answers first: every ID sets 7 bits inside one 64-byte block, so a check costs one hash and
+ * one cache line, and an ID never seen before (the common case) is known to be new without a lookup in the exact set.
+ * Only possible repeats fall through to an `unordered_set`, which decides. The filter is sized for about 1% false
+ * positives and doubles, rebuilding from the exact set, whenever the IDs outgrow it. Removed IDs stay in the filter
+ * until the next rebuild; they only cost an extra exact lookup.
+ *
+ * Generated IDs are kept as integers in their own exact set, so checking them never renders or hashes text. Text IDs
+ * that are the `FMR<decimal>` form of a generated ID are looked up as the integer. Transactions without an ID are
+ * never duplicates.
+ */
+class TransactionIdIndex {
+private:
+    /**
+     * @brief Hashes IDs for both the filter and the exact set.
+     */
+    struct IdHash {
+        size_t operator()(string_view id) const;
+        size_t operator()(uint64_t id) const;
+    };
+
+    vector<uint64_t> blocks;            ///< The filter: 8 words (512 bits) per block
+    size_t blockMask;                   ///< Number of blocks minus one (a power of two minus one)
+    size_t capacity;                    ///< IDs the filter is sized for
+    unordered_set<string, IdHash> ids;  ///< The exact set of text IDs
+    unordered_set<uint64_t, IdHash> numericIds; ///< The exact set of generated IDs
+
+    /**
+     * @brief Sizes the filter for a number of IDs and re-adds every ID of the exact set.
+     *
+     * @param count The number of IDs to size for
+     */
+    void rebuild(size_t count);
+
+    /**
+     * @brief Sets the filter bits of a hash.
+     *
+     * @param hash The hash of an ID
+     */
+    void addToFilter(uint64_t hash);
+
+    /**
+     * @brief Checks the filter bits of a hash.
+     *
+     * @param hash The hash of an ID
+     * @return False if the ID is certainly absent.
+     */
+    bool mayContain(uint64_t hash) const;
+
+public:
+    /**
+     * @brief Creates an empty index.
+     */
+    TransactionIdIndex();
+
+    /**
+     * @brief Adds a transaction's ID unless it is already present.
+     *
+     * @param transaction The transaction
+     * @return True if the ID was new or empty, false if it is a duplicate.
+     */
+    bool insert(const Transaction &transaction);
+
+    /**
+     * @brief Checks whether an ID is present.
+     *
+     * @param id The transaction ID
+     * @return True if a transaction with this ID exists.
+     */
+    bool contains(const string &id) const;
+
+    /**
+     * @brief Checks whether a generated ID is present.
+     *
+     * @param id The generated ID
+     * @return True if a transaction with this ID exists.
+     */
+    bool contains(uint64_t id) const;
+
+    /**
+     * @brief Removes a transaction's ID, so a transaction with it can be posted again.
+     *
+     * @param transaction The transaction
+     */
+    void erase(const Transaction &transaction);
+
+    /**
+     * @brief Removes every ID.
+     */
+    void clear();
+
+    /**
+     * @brief Sizes the index for a number of IDs ahead of a bulk load.
+     *
+     * @param count The expected number of IDs
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Returns the number of IDs.
+     *
+     * @return The ID count
+     */
+    size_t size() const;
+};
+
+#endif //ADS_MIDTERM_PROJECT_TRANSACTIONIDINDEX_H
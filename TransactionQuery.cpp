@@ -0,0 +1,73 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file TransactionQuery.cpp
+ * @brief Implements the filters and summary-based pruning of `TransactionQuery`.
+ */
+
+#include "TransactionQuery.h"
+
+using namespace std;
+
+/**
+ * @brief Returns true if the query filters on the transaction date.
+ *
+ * @return True when either date bound is set.
+ */
+bool TransactionQuery::hasDateFilter() const {
+    return fromDayKey != 0 || toDayKey != 0;
+}
+
+/**
+ * @brief Checks whether a transaction passes every filter.
+ *
+ * Cheap numeric filters are tested first so the description search only runs on otherwise matching rows.
+ *
+ * @param t The transaction to test.
+ * @return True if the transaction matches the query.
+ */
+bool TransactionQuery::matches(const Transaction &t) const {
+    if (debitCredit != 0 && t.getDebitCredit() != debitCredit) {
+        return false;
+    }
+    if (t.getAmount() < minAmount || t.getAmount() > maxAmount) {
+        return false;
+    }
+    if (hasDateFilter()) {
+        int dayKey = t.getDayKey();
+        if (dayKey == 0 || (fromDayKey != 0 && dayKey < fromDayKey) || (toDayKey != 0 && dayKey > toDayKey)) {
+            return false;
+        }
+    }
+    if (!descriptionContains.empty() && t.getDescription().find(descriptionContains) == string::npos) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether any transaction of an account could match, using only its min/max summaries.
+ *
+ * @param account The account to test.
+ * @return False if no transaction of the account can match, true otherwise.
+ */
+bool TransactionQuery::mayMatch(const Account &account) const {
+    if (account.getTransactionCount() == 0) {
+        return false;
+    }
+    if (account.getMaxAmount() < minAmount || account.getMinAmount() > maxAmount) {
+        return false;
+    }
+    if (hasDateFilter()) {
+        if (account.getMaxDayKey() == 0) {
+            return false;  // No dated transactions at all
+        }
+        if ((fromDayKey != 0 && account.getMaxDayKey() < fromDayKey) ||
+            (toDayKey != 0 && account.getMinDayKey() > toDayKey)) {
+            return false;
+        }
+    }
+    return true;
+}
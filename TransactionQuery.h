@@ -0,0 +1,73 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_TRANSACTIONQUERY_H
+#define ADS_MIDTERM_PROJECT_TRANSACTIONQUERY_H
+
+#include <string>
+#include <limits>
+#include "Account.h"
+#include "Transaction.h"
+
+using namespace std;
+
+/**
+ * @struct TransactionQuery
+ * @brief A set of filters used to select transactions inside a subtree of the chart of accounts.
+ *
+ * Every filter is optional: the default-constructed query matches every transaction. Date bounds use the
+ * `YYYYMMDD` day keys produced by `Transaction::toDayKey`, so a range such as November 2024 is
+ * `fromDayKey = 20241101, toDayKey = 20241130`.
+ */
+struct TransactionQuery {
+    int fromDayKey = 0;                                   ///< First day to include, 0 for no lower bound
+    int toDayKey = 0;                                     ///< Last day to include, 0 for no upper bound
+    double minAmount = 0.0;                               ///< Smallest amount to include
+    double maxAmount = numeric_limits<double>::max();     ///< Largest amount to include
+    char debitCredit = 0;                                 ///< 'D' or 'C' to restrict the type, 0 for both
+    string descriptionContains;                           ///< Substring the description must contain
+
+    /**
+     * @brief Returns true if the query filters on the transaction date.
+     *
+     * @return True when either date bound is set
+     */
+    bool hasDateFilter() const;
+
+    /**
+     * @brief Checks whether a transaction passes every filter.
+     *
+     * @param t The transaction to test
+     * @return True if the transaction matches the query
+     */
+    bool matches(const Transaction &t) const;
+
+    /**
+     * @brief Checks whether any transaction of an account could match, using only its min/max summaries.
+     *
+     * This is the pushdown step: accounts whose date or amount summary lies outside the query bounds are skipped
+     * without looking at their transactions.
+     *
+     * @param account The account to test
+     * @return False if no transaction of the account can match, true otherwise
+     */
+    bool mayMatch(const Account &account) const;
+};
+
+/**
+ * @struct TransactionHit
+ * @brief A transaction returned by a ranking query, together with the account it belongs to.
+ *
+ * The fields are plain values, so a hit stays meaningful after the ledger changes.
+ */
+struct TransactionHit {
+    int accountNumber;       ///< The account that owns the transaction
+    string transactionID;    ///< The transaction ID
+    int64_t amountCents;     ///< The amount, in cents
+    char debitCredit;        ///< 'D' for debit, 'C' for credit
+    string date;             ///< The date, empty if the transaction is undated
+    string description;      ///< The description
+};
+
+#endif //ADS_MIDTERM_PROJECT_TRANSACTIONQUERY_H
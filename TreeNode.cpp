@@ -12,8 +12,11 @@
  */
 
 #include "TreeNode.h"
+#include "ForestIterators.h"
+#include "ForestMetrics.h"
 #include <iostream>
 #include <string>
+#include <vector>
 
 using namespace std;
 /**
@@ -27,9 +30,9 @@ using namespace std;
 /**
  * @brief Default constructor.
  *
- * Initializes a TreeNode with null pointers for the account, left child, and right sibling.
+ * Initializes a TreeNode with an empty account and null pointers for the left child and right sibling.
  */
-TreeNode::TreeNode() : account(NULL), leftChild(NULL), rightSibling(NULL) {}
+TreeNode::TreeNode() : leftChild(NULL), rightSibling(NULL) {}
 /**
  * @brief Parameterized constructor.
  *
@@ -37,9 +40,15 @@ TreeNode::TreeNode() : account(NULL), leftChild(NULL), rightSibling(NULL) {}
  *
  * @param acc The account to store in this TreeNode.
  */
-TreeNode::TreeNode(const Account &acc) : leftChild(NULL), rightSibling(NULL) {
-    account = new Account(acc);
-}
+TreeNode::TreeNode(const Account &acc) : account(acc), leftChild(NULL), rightSibling(NULL) {}
+/**
+ * @brief Parameterized constructor that takes over an account.
+ *
+ * The account's transactions and period buckets are moved, not copied, into the node.
+ *
+ * @param acc The account to move into this TreeNode.
+ */
+TreeNode::TreeNode(Account &&acc) : account(move(acc)), leftChild(NULL), rightSibling(NULL) {}
 /**
  * @brief Copy constructor.
  *
@@ -47,16 +56,15 @@ TreeNode::TreeNode(const Account &acc) : leftChild(NULL), rightSibling(NULL) {
  *
  * @param other The TreeNode to copy from.
  */
-TreeNode::TreeNode(const TreeNode &other) {
+TreeNode::TreeNode(const TreeNode &other) : leftChild(NULL), rightSibling(NULL) {
     copyForm(other);
 }
 /**
  * @brief Destructor.
  *
- * Cleans up dynamically allocated memory for the account, child, and sibling nodes.
+ * Cleans up dynamically allocated memory for the child and sibling nodes.
  */
 TreeNode::~TreeNode() {
-    delete account;
     clean();
 }
 /**
@@ -83,16 +91,21 @@ NodePtr TreeNode::getRightSibling() const {
 /**
  * @brief Sets the account data for this TreeNode.
  *
- * Deletes the existing account (if any) and sets the new account.
+ * Replaces the stored account with a copy of the given one.
  *
  * @param acc The account to associate with this TreeNode.
  */
 //sets
 void TreeNode::setData(const Account &acc) {
-    if (account != NULL) {
-        delete account;
-    }
-    account = new Account(acc);
+    account = acc;
+}
+/**
+ * @brief Sets the account data for this TreeNode, taking over the given account.
+ *
+ * @param acc The account to move into this TreeNode.
+ */
+void TreeNode::setData(Account &&acc) {
+    account = move(acc);
 }
 /**
  * @brief Sets the left child for this TreeNode.
@@ -163,36 +176,27 @@ bool TreeNode::hasSibling() const {
 /**
  * @brief Finds a node with a specific account number in the tree.
  *
- * Performs a depth-first search for the node with the specified account number.
+ * Performs a depth-first search for the node with the specified account number, covering the root's
+ * descendants and then its right siblings.
  *
  * @param root Pointer to the root of the tree to search.
  * @param accNum The account number to search for.
  * @return Pointer to the found node, or nullptr if not found.
  */
 NodePtr TreeNode::findNode(NodePtr root, int accNum) {
-    if (!root) {
-        return nullptr;
-    }
-
-    // Check current node
-    if (root->account && root->account->getAccountNumber() == accNum) {
-        return root;
-    }
-
-    // Check children first (depth-first search)
+    // Children first, then siblings (pre-order), walked without recursion. Visits are counted locally and added to
+    // the shared counter once, so the walk does not touch an atomic per node.
     NodePtr found = nullptr;
-    if (root->leftChild) {
-        found = findNode(root->leftChild, accNum);
-        if (found) return found;
-    }
-
-    // Then check siblings
-    if (root->rightSibling) {
-        found = findNode(root->rightSibling, accNum);
-        if (found) return found;
+    uint64_t visited = 0;
+    for (TreeNode &node: preOrder(root, true)) {
+        ++visited;
+        if (node.account.getAccountNumber() == accNum) {
+            found = &node;
+            break;
+        }
     }
-
-    return nullptr;
+    FOREST_METRIC_ADD(MetricCounter::NodesVisited, visited);
+    return found;
 }
 
 /**
@@ -200,283 +204,74 @@ NodePtr TreeNode::findNode(NodePtr root, int accNum) {
  *
  * Maintains sibling order based on account numbers.
  *
- * @param acc The account to associate with the new child node.
+ * @param acc The account to associate with the new child node, moved into it.
+ * @return The new child node.
  */
-void TreeNode::addChild(const Account &acc) {
-    NodePtr newChild = new TreeNode(acc);
+NodePtr TreeNode::addChild(Account acc) {
+    int accNum = acc.getAccountNumber();
+    NodePtr newChild = new TreeNode(move(acc));
 
     if (leftChild == NULL) {
         leftChild = newChild;
-        return;
+        return newChild;
     }
 
     // Find proper position among siblings
-    if (leftChild->account->getAccountNumber() > acc.getAccountNumber()) {
+    if (leftChild->account.getAccountNumber() > accNum) {
         // Insert at beginning
         newChild->rightSibling = leftChild;
         leftChild = newChild;
-        return;
+        return newChild;
     }
 
     // Find insertion point
     NodePtr current = leftChild;
     while (current->rightSibling &&
-           current->rightSibling->account->getAccountNumber() < acc.getAccountNumber()) {
+           current->rightSibling->account.getAccountNumber() < accNum) {
         current = current->rightSibling;
     }
 
     // Insert after current
     newChild->rightSibling = current->rightSibling;
     current->rightSibling = newChild;
+    return newChild;
 }
 /**
- * @brief Adds a sibling node with the specified account to this TreeNode.
+ * @brief Links a new child account into its sorted place among this node's children.
  *
- * Maintains sibling order based on account numbers.
+ * Nothing is searched: the caller has already found this node as the parent.
  *
- * @param acc The account to associate with the new sibling node.
+ * @param acc The account of the new child.
+ * @return The new child node.
  */
-void TreeNode::addSibling(const Account &acc) {
-    NodePtr newSibling = new TreeNode(acc);
-
-    if (rightSibling == NULL) {
-        rightSibling = newSibling;
-        return;
-    }
-
-    // Find proper position
-    if (rightSibling->account->getAccountNumber() > acc.getAccountNumber()) {
-        // Insert at beginning
-        newSibling->rightSibling = rightSibling;
-        rightSibling = newSibling;
-        return;
-    }
-
-    // Find insertion point
-    NodePtr current = rightSibling;
-    while (current->rightSibling &&
-           current->rightSibling->account->getAccountNumber() < acc.getAccountNumber()) {
-        current = current->rightSibling;
-    }
-
-    // Insert after current
-    newSibling->rightSibling = current->rightSibling;
-    current->rightSibling = newSibling;
+NodePtr TreeNode::insertChild(const Account &acc) {
+    return addChild(acc);
 }
 /**
- * @brief Adds a new account node to the tree.
+ * @brief Links a new child account into its sorted place, moving the account into the new node.
  *
- * This method adds a new account node to the tree while maintaining the parent-child
- * and sibling relationships. If the account already exists, it does nothing.
- *
- * @param root Pointer to the root node of the tree.
- * @param newAcc The account to be added to the tree.
- * @return True if the account was successfully added, false otherwise.
+ * @param acc The account of the new child.
+ * @return The new child node.
  */
-bool TreeNode::addAccountNode(NodePtr root, const Account &newAcc) {
-    int newAccNum = newAcc.getAccountNumber();
-
-    // Check if account already exists
-    if (findNode(root, newAccNum) != nullptr) {
-        return false;  // Account number already exists
-    }
-
-    // If this is the first node
-    if (!account) {
-        account = new Account(newAcc);
-        return true;
-    }
-
-    // Find the proper parent for this account
-    string newAccStr = to_string(newAccNum);
-    string parentStr = newAccStr.substr(0, newAccStr.length() - 1);
-
-    if (parentStr.empty()) {
-        return false;  // Let ForestTree handle root nodes
-    }
-
-    // Validate that child is only one digit longer than parent
-    int parentNum = stoi(parentStr);
-    if (to_string(parentNum).length() + 1 != newAccStr.length()) {
-        return false;  // Invalid child-parent relationship
-    }
-
-    NodePtr parentNode = findNode(root, parentNum);
-    if (!parentNode) {
-        return false;  // Parent doesn't exist
-    }
-
-    try {
-        // If parent has no children, add as first child
-        if (!parentNode->leftChild) {
-            parentNode->addChild(newAcc);
-        } else {
-            // Find the right sibling position among existing children
-            NodePtr lastChild = parentNode->leftChild;
-
-            // If new account should be first child
-            if (lastChild->account->getAccountNumber() > newAccNum) {
-                parentNode->addChild(newAcc);
-                return true;
-            }
-
-            // Find the appropriate sibling to add after
-            while (lastChild->rightSibling &&
-                   lastChild->rightSibling->account->getAccountNumber() < newAccNum) {
-                lastChild = lastChild->rightSibling;
-            }
-            lastChild->addSibling(newAcc);
-        }
-        return true;
-    } catch (const invalid_argument &e) {
-        return false;
-    }
-}
-/**
- * @brief Updates the balances for the current account and its parent nodes.
- *
- * Applies a transaction to the current account and propagates the balance changes
- * to all parent accounts in the tree, starting from the current account and moving upward.
- *
- * @param root Pointer to the root node of the tree.
- * @param t The transaction to apply to the current account.
- * @throws runtime_error If the current account is null.
- */
-void TreeNode::updateBalance(NodePtr root, Transaction &t) {
-    if (!account) {
-        throw runtime_error("Null account pointer");
-    }
-
-    // Get parent nodes from the main root of this account's tree
-    vector<NodePtr> parents = getParentNodes(root);
-
-    // Update the current account's balance first
-    account->updateBalance(t);
-
-
-    // Update all parent balances from bottom to top
-    for (NodePtr parent: parents) {
-        if (parent && parent->account) {
-            parent->account->updateBalance(t);
-        }
-    }
-}
-/**
- * @brief Retrieves all parent nodes of the current account in the tree.
- *
- * This method calculates and returns a list of parent nodes for the current account,
- * working its way up the tree hierarchy.
- *
- * @param root Pointer to the root node of the tree.
- * @return A vector of pointers to the parent nodes.
- */
-vector<NodePtr> TreeNode::getParentNodes(NodePtr root) {
-    vector<NodePtr> parents;
-    string childNum = to_string(account->getAccountNumber());
-
-    while (childNum.length() > 1) {
-        // Remove last digit to get parent number
-        childNum = childNum.substr(0, childNum.length() - 1);
-        int parentNum = stoi(childNum);
-
-        // First try to find in current root's tree
-        NodePtr parent = findNode(root, parentNum);
-        if (parent) {
-            parents.insert(parents.begin(), parent); // Insert at beginning to maintain order
-        }
-    }
-
-    return parents;
-}
-/**
- * @brief Updates the balances of all parent accounts based on a transaction.
- *
- * This method takes a list of parent nodes and updates their balances to reflect
- * the changes introduced by the specified transaction.
- *
- * @param parents A vector of pointers to the parent nodes.
- * @param t The transaction to apply to the parent accounts.
- */
-void TreeNode::updateParentBalances(const vector<NodePtr> &parents, const Transaction &t) {
-    for (NodePtr parent: parents) {
-        parent->account->updateBalance(t);
-    }
-}
-/**
- * @brief Validates the parent-child relationship between two accounts.
- *
- * Checks whether a child account number is a valid extension of a parent account number,
- * ensuring that the child number starts with the parent's number and is exactly one digit longer.
- *
- * @param parentNum The account number of the parent.
- * @param childNum The account number of the child.
- * @return True if the child is valid, false otherwise.
- */
-bool TreeNode::isValidChild(int parentNum, int childNum) const {
-    string parent = to_string(parentNum);
-    string child = to_string(childNum);
-
-    if (child.length() <= parent.length()) {
-        return false;
-    }
-
-    return child.substr(0, parent.length()) == parent;
+NodePtr TreeNode::insertChild(Account &&acc) {
+    return addChild(move(acc));
 }
 /**
  * @brief Gets the level of the current account in the tree.
  *
  * This method calculates the depth (or level) of the current account node in the tree
- * relative to the root node.
+ * relative to the root node, searching the root's subtree in pre-order.
  *
  * @param root Pointer to the root node of the tree.
  * @return The level of the current account node, or -1 if the account is not found.
  */
 int TreeNode::getLevel(NodePtr root) const {
-    if (root == NULL) {
-        return -1;
-    }
-    if (root->account->getAccountNumber() == account->getAccountNumber()) {
-        return 0;
-    }
-
-    return getLevelHelper(root->leftChild, 1);
-}
-/**
- * @brief Helper method for calculating the level of the current node.
- *
- * This recursive method determines the depth of a specific node relative to
- * the root node by traversing the tree structure.
- *
- * @param node Pointer to the node currently being inspected.
- * @param currentLevel The current level being tracked in the recursive calls.
- * @return The level of the current node, or -1 if the node is not found.
- */
-//when your adding a trans ez il balance bas kif
-int TreeNode::getLevelHelper(NodePtr node, int currentLevel) const {
-    if (node == NULL) {
-        return -1;
-    }
-    if (node->account->getAccountNumber() == account->getAccountNumber()) {
-        return currentLevel;
-    }
-
-    NodePtr sibling = node->rightSibling;
-    while (sibling != nullptr) {
-        if (sibling->account->getAccountNumber() == account->getAccountNumber()) {
-            return currentLevel;
+    ForestRange<PreOrderIterator> nodes = preOrder(root);
+    for (PreOrderIterator it = nodes.begin(); it != nodes.end(); ++it) {
+        if (it->account.getAccountNumber() == account.getAccountNumber()) {
+            return it.depth();
         }
-        sibling = sibling->rightSibling;
     }
-
-    NodePtr child = node->leftChild;
-    while (child != nullptr) {
-        int result = getLevelHelper(child, currentLevel + 1);
-        if (result != -1) {
-            return result;
-        }
-        child = child->rightSibling;
-    }
-
     return -1;
 }
 /**
@@ -486,10 +281,41 @@ int TreeNode::getLevelHelper(NodePtr node, int currentLevel) const {
  * in this TreeNode.
  */
 void TreeNode::print() const {
-    std::cout << "Account: " << account->getAccountNumber()
-              << " - " << account->getDescription()
-              << " (Balance: " << account->getBalance() << ")\n";
+    std::cout << "Account: " << account.getAccountNumber()
+              << " - " << account.getDescription()
+              << " (Balance: " << account.getBalance() << ")\n";
+}
+/**
+ * @brief Deep-copies a chain of siblings together with all of their descendants.
+ *
+ * The source is walked in pre-order, where each node is either the first child of the node visited just before it
+ * or the right sibling of the last node copied at its depth, so no recursion is needed.
+ *
+ * @param first The first node of the chain to copy.
+ * @return The copy of `first`, or nullptr if `first` is null.
+ */
+static NodePtr copyChain(NodePtr first) {
+    NodePtr head = nullptr;
+    vector<NodePtr> lastAtDepth;  // The latest copy made at each depth
+    ForestRange<PreOrderIterator> nodes = preOrder(first, true);
+    for (PreOrderIterator it = nodes.begin(); it != nodes.end(); ++it) {
+        NodePtr copy = new TreeNode(it->getData());
+        copy->getDigest() = it->getDigest();
+
+        size_t depth = it.depth();
+        if (lastAtDepth.empty()) {
+            head = copy;
+        } else if (depth == lastAtDepth.size()) {
+            lastAtDepth.back()->setLeftChild(copy);
+        } else {
+            lastAtDepth[depth]->setRightSibling(copy);
+        }
+        lastAtDepth.resize(depth + 1);
+        lastAtDepth[depth] = copy;
+    }
+    return head;
 }
+
 /**
  * @brief Copies data from another TreeNode into this one.
  *
@@ -499,39 +325,38 @@ void TreeNode::print() const {
  * @param other The TreeNode to copy from.
  */
 void TreeNode::copyForm(const TreeNode &other) {
-    if (account != NULL) {
-        delete account;
-    }
-    if (leftChild != NULL) {
-        delete leftChild;
-    }
-    if (rightSibling != NULL) {
-        delete rightSibling;
-    }
+    clean();
 
     // Deep copy of account
-    account = (other.account != NULL) ? new Account(*other.account) : NULL;
+    account = other.account;
+    digest = other.digest;
 
-    // Deep copy of child nodes
-    leftChild = (other.leftChild != NULL) ? new TreeNode(*other.leftChild) : NULL;
-
-    // Deep copy of sibling nodes
-    rightSibling = (other.rightSibling != NULL) ? new TreeNode(*other.rightSibling) : NULL;
+    // Deep copy of child and sibling nodes
+    leftChild = copyChain(other.leftChild);
+    rightSibling = copyChain(other.rightSibling);
 }
 
 /**
  * @brief Cleans up the child and sibling nodes of this TreeNode.
  *
  * Deletes the left child and right sibling subtrees of this TreeNode, freeing
- * dynamically allocated memory.
+ * dynamically allocated memory. The nodes are freed children first and unlinked before
+ * deletion, so no destructor recurses however long the sibling chains are.
  */
 void TreeNode::clean() {
-    // Delete child subtree
-    delete leftChild;
+    NodePtr chains[] = {leftChild, rightSibling};
     leftChild = nullptr;
-
-    // Delete sibling subtree
-    delete rightSibling;
     rightSibling = nullptr;
+
+    for (NodePtr first: chains) {
+        ForestRange<PostOrderIterator> nodes = postOrder(first, true);
+        for (PostOrderIterator it = nodes.begin(); it != nodes.end();) {
+            NodePtr node = &*it;
+            ++it;  // Moves off the node before it is freed
+            node->leftChild = nullptr;
+            node->rightSibling = nullptr;
+            delete node;
+        }
+    }
 }
 
@@ -9,6 +9,7 @@
 #include <string>
 #include "Account.h"
 #include "Transaction.h"
+#include "LedgerDigest.h"
 
 using namespace std;
 
@@ -24,16 +25,17 @@ typedef class TreeNode *NodePtr;
 //didnt use elemtntypr account cause its confusing for no reason
 class TreeNode {
 private:
-    AccountPtr account;
+    Account account;
     NodePtr leftChild;
     NodePtr rightSibling;
+    SubtreeDigest digest;
 
 public:
     //constructors
     // Constructors and Destructor
     /**
      * @brief Default constructor for the `TreeNode` class.
-     * Initializes the node with default values: a null account pointer, and null pointers for left child and right sibling.
+     * Initializes the node with default values: an empty account (number 0), and null pointers for left child and right sibling.
      */
     TreeNode(); //aadeye
     /**
@@ -43,6 +45,12 @@ public:
      * @param acc The `Account` object to be stored in the node
      */
     TreeNode(const Account &acc); //with acc
+    /**
+     * @brief Parameterized constructor that takes over an `Account` instead of copying it.
+     *
+     * @param acc The `Account` object to move into the node
+     */
+    TreeNode(Account &&acc);
     /**
      * @brief Copy constructor for the `TreeNode` class.
      * Initializes the node by copying data from another node.
@@ -75,13 +83,25 @@ public:
          *
          * @return A reference to the `Account` object stored in this node
          */
-    Account &getData() { return *account; }
+    Account &getData() { return account; }
     /**
      * @brief Gets the account data stored in the node (const version).
      *
      * @return A const reference to the `Account` object stored in this node
      */
-    const Account &getData() const { return *account; }
+    const Account &getData() const { return account; }
+    /**
+     * @brief Gets the Merkle digest parts of the node, maintained by the forest.
+     *
+     * @return A reference to the digest parts
+     */
+    SubtreeDigest &getDigest() { return digest; }
+    /**
+     * @brief Gets the Merkle digest parts of the node (const version).
+     *
+     * @return A const reference to the digest parts
+     */
+    const SubtreeDigest &getDigest() const { return digest; }
 
 
     //setters
@@ -91,6 +111,12 @@ public:
      * @param acc The new `Account` to store in the node
      */
     void setData(const Account &acc);
+    /**
+     * @brief Sets the account data for the node, taking over the given account.
+     *
+     * @param acc The `Account` to move into the node
+     */
+    void setData(Account &&acc);
     /**
       * @brief Sets the left child of the node.
       *
@@ -117,37 +143,21 @@ public:
      */
     bool hasSibling() const;
     /**
-      * @brief Checks if the given account numbers represent a valid child-parent relationship.
+      * @brief Links a new child account into its sorted place among this node's children.
       *
-      * @param parentNum The parent account number
-      * @param childNum The child account number
-      * @return True if the relationship is valid, false otherwise
-      */
-    //account hierarchy
-
-    bool isValidChild(int parentNum, int childNum) const;
-    /**
-      * @brief Adds a new account node to the tree.
+      * Nothing is searched: the caller has already found this node as the parent.
       *
-      * @param root The root node of the tree to start the search for the correct position
-      * @param newAcc The new `Account` to add to the tree
-      * @return True if the account was successfully added, false otherwise
+      * @param acc The account of the new child
+      * @return The new child node
       */
-    bool addAccountNode(NodePtr root, const Account &newAcc);
+    NodePtr insertChild(const Account &acc);
     /**
-      * @brief Updates the balance of accounts in the tree based on a transaction.
+      * @brief Links a new child account into its sorted place, moving the account into the new node.
       *
-      * @param root The root node of the tree to start the update from
-      * @param t The `Transaction` object containing the update details
+      * @param acc The account of the new child
+      * @return The new child node
       */
-    void updateBalance(NodePtr root, Transaction &t);
-    /**
-        * @brief Retrieves all the parent nodes of the given node.
-        *
-        * @param root The root node of the tree
-        * @return A vector of pointers to parent nodes
-        */
-    vector<NodePtr> getParentNodes(NodePtr root);
+    NodePtr insertChild(Account &&acc);
     /**
          * @brief Finds the node with the specified account number in the tree.
          *
@@ -193,33 +203,13 @@ private:
          * This is a helper method used by the destructor.
          */
     void clean();
-    /**
-        * @brief Helper method to recursively get the level of a node.
-        *
-        * @param node The node to check
-        * @param currentLevel The current level during recursion
-        * @return The level of the node
-        */
-    int getLevelHelper(NodePtr node, int currentLevel) const;
     /**
          * @brief Adds a new child to the node.
          *
-         * @param acc The account data for the new child node
+         * @param acc The account data for the new child node, moved into it
+         * @return The new child node
          */
-    void addChild(const Account &);
-    /**
-        * @brief Adds a new sibling to the node.
-        *
-        * @param acc The account data for the new sibling node
-        */
-    void addSibling(const Account &);
-    /**
-        * @brief Updates the balances of the parent nodes based on a transaction.
-        *
-        * @param parents A list of parent nodes to update
-        * @param t The `Transaction` object containing the update details
-        */
-    void updateParentBalances(const vector<NodePtr> &parents, const Transaction &t);
+    NodePtr addChild(Account);
 
 //    NodePtr findLastChild() const;
 //    NodePtr findLastSibling() const;
@@ -0,0 +1,271 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file WorkerPool.cpp
+ * @brief Implements `WorkerPool`, the shared helper threads behind the parallel subtree walks.
+ */
+
+#include "WorkerPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief The helper threads and the tasks waiting for them.
+ */
+struct PoolState {
+    mutex lock;                     ///< Guards `tasks`
+    condition_variable ready;       ///< Signalled when a task is queued
+    deque<function<void()>> tasks;  ///< Tasks not yet taken by a helper
+    size_t threads = 0;             ///< Number of helper threads
+};
+
+/**
+ * @brief Helper thread body: runs queued tasks for the life of the process.
+ *
+ * @param pool The pool
+ */
+static void helperLoop(PoolState &pool) {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(pool.lock);
+            pool.ready.wait(guard, [&pool] { return !pool.tasks.empty(); });
+            task = move(pool.tasks.front());
+            pool.tasks.pop_front();
+        }
+        task();
+    }
+}
+
+/**
+ * @brief Returns the pool, starting its threads on first use. It is never destroyed, and its threads are detached.
+ *
+ * @return The pool
+ */
+static PoolState &state() {
+    static PoolState *pool = [] {
+        PoolState *started = new PoolState;
+        unsigned cores = thread::hardware_concurrency();
+        started->threads = cores > 2 ? cores - 1 : 1;
+        for (size_t i = 0; i < started->threads; ++i) {
+            thread([started] { helperLoop(*started); }).detach();
+        }
+        return started;
+    }();
+    return *pool;
+}
+
+/**
+ * @brief One call's items, shared by the caller and the helpers working on it.
+ *
+ * Helpers hold it through a `shared_ptr`, so one that starts after the caller has returned finds nothing left to
+ * claim and touches nothing else. `work` is only called for a claimed item, and the caller waits for every claimed
+ * item before returning.
+ */
+struct Batch {
+    const function<void(size_t)> *work = nullptr;  ///< The task for one item
+    size_t count = 0;                               ///< Number of items
+    size_t chunk = 1;                               ///< Items claimed at a time
+
+    mutex lock;                 ///< Guards everything below
+    condition_variable changed; ///< Signalled when an item finishes
+    size_t next = 0;            ///< The first unclaimed item
+    size_t active = 0;          ///< Claims still running
+    bool stopped = false;       ///< Set to stop further claims
+    vector<char> done;          ///< Which items have finished (ordered calls only)
+    exception_ptr error;        ///< The first exception thrown by an item
+};
+
+/**
+ * @brief Claims the next chunk of items.
+ *
+ * @param batch The batch
+ * @param begin Receives the first claimed item
+ * @param end Receives one past the last claimed item
+ * @return False if nothing is left or the batch was stopped
+ */
+static bool claim(Batch &batch, size_t &begin, size_t &end) {
+    lock_guard<mutex> guard(batch.lock);
+    if (batch.stopped || batch.next >= batch.count) {
+        return false;
+    }
+    begin = batch.next;
+    end = min(batch.count, begin + batch.chunk);
+    batch.next = end;
+    ++batch.active;
+    return true;
+}
+
+/**
+ * @brief Runs a claimed chunk and records its completion. An exception stops the batch.
+ *
+ * @param batch The batch
+ * @param begin The first item of the chunk
+ * @param end One past the last item of the chunk
+ */
+static void runClaimed(Batch &batch, size_t begin, size_t end) {
+    exception_ptr error;
+    size_t item = begin;
+    try {
+        for (; item < end; ++item) {
+            (*batch.work)(item);
+        }
+    } catch (...) {
+        error = current_exception();
+    }
+
+    lock_guard<mutex> guard(batch.lock);
+    --batch.active;
+    if (!batch.done.empty()) {
+        fill(batch.done.begin() + begin, batch.done.begin() + item, 1);
+    }
+    if (error) {
+        if (!batch.error) {
+            batch.error = error;
+        }
+        batch.stopped = true;
+    }
+    batch.changed.notify_all();
+}
+
+/**
+ * @brief Claims and runs chunks until none is left.
+ *
+ * @param batch The batch
+ */
+static void drain(Batch &batch) {
+    size_t begin, end;
+    while (claim(batch, begin, end)) {
+        runClaimed(batch, begin, end);
+    }
+}
+
+/**
+ * @brief Queues helper tasks for a batch.
+ *
+ * @param batch The batch
+ * @param wanted The number of helpers that could usefully join
+ */
+static void startHelpers(const shared_ptr<Batch> &batch, size_t wanted) {
+    PoolState &pool = state();
+    size_t count = min(wanted, pool.threads);
+    {
+        lock_guard<mutex> guard(pool.lock);
+        for (size_t i = 0; i < count; ++i) {
+            pool.tasks.emplace_back([batch] { drain(*batch); });
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        pool.ready.notify_one();
+    }
+}
+
+/**
+ * @brief Stops further claims and waits for the running ones, then rethrows the first item exception if any.
+ *
+ * @param batch The batch
+ */
+static void finish(Batch &batch) {
+    unique_lock<mutex> guard(batch.lock);
+    batch.stopped = true;
+    batch.changed.wait(guard, [&batch] { return batch.active == 0; });
+    if (batch.error) {
+        rethrow_exception(batch.error);
+    }
+}
+
+/**
+ * @brief Returns the number of helper threads.
+ *
+ * @return The helper count; callers add one more worker of their own
+ */
+size_t WorkerPool::helpers() {
+    return state().threads;
+}
+
+/**
+ * @brief Runs `work(i)` for every `i` below `count`, on the calling thread and the helpers, and waits for all.
+ *
+ * @param count The number of items
+ * @param work The task for one item. Called concurrently for different items.
+ *
+ * @throws Whatever the first failing item threw, once every started item has finished.
+ */
+void WorkerPool::parallelFor(size_t count, const function<void(size_t)> &work) {
+    if (count <= 1) {
+        if (count == 1) {
+            work(0);
+        }
+        return;
+    }
+
+    shared_ptr<Batch> batch = make_shared<Batch>();
+    batch->work = &work;
+    batch->count = count;
+    batch->chunk = max<size_t>(1, count / ((helpers() + 1) * 4));
+
+    size_t chunks = (count + batch->chunk - 1) / batch->chunk;
+    startHelpers(batch, chunks - 1);
+    drain(*batch);
+    finish(*batch);
+}
+
+/**
+ * @brief Runs `work(i)` for every `i` below `count` in parallel, handing each result over in index order.
+ *
+ * @param count The number of items
+ * @param work The task for one item. Called concurrently for different items.
+ * @param deliver Consumes the result of one item; returns false to stop early.
+ * @return True if every item was delivered, false if `deliver` stopped early
+ *
+ * @throws Whatever the first failing item threw, once every started item has finished.
+ */
+bool WorkerPool::parallelForOrdered(size_t count, const function<void(size_t)> &work,
+                                    const function<bool(size_t)> &deliver) {
+    shared_ptr<Batch> batch = make_shared<Batch>();
+    batch->work = &work;
+    batch->count = count;
+    batch->done.assign(count, 0);
+    if (count > 1) {
+        startHelpers(batch, count - 1);
+    }
+
+    bool complete = true;
+    try {
+        for (size_t i = 0; i < count && complete; ++i) {
+            // While item i is not done, work on the next unclaimed item rather than wait
+            unique_lock<mutex> guard(batch->lock);
+            while (!batch->done[i] && !batch->error) {
+                if (!batch->stopped && batch->next < count) {
+                    size_t item = batch->next++;
+                    ++batch->active;
+                    guard.unlock();
+                    runClaimed(*batch, item, item + 1);
+                    guard.lock();
+                } else {
+                    batch->changed.wait(guard);
+                }
+            }
+            if (batch->error) {
+                break;
+            }
+            guard.unlock();
+            complete = deliver(i);
+        }
+    } catch (...) {
+        finish(*batch);
+        throw;
+    }
+    finish(*batch);
+    return complete;
+}
@@ -0,0 +1,62 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+#ifndef ADS_MIDTERM_PROJECT_WORKERPOOL_H
+#define ADS_MIDTERM_PROJECT_WORKERPOOL_H
+
+#include <cstddef>
+#include <functional>
+
+using namespace std;
+
+/**
+ * @class WorkerPool
+ * @brief The process-wide pool of helper threads behind the forest's parallel subtree walks.
+ *
+ * The pool is started on first use with one thread fewer than `hardware_concurrency()` (at least one), and every
+ * caller works alongside it, so a walk over ten thousand children uses a handful of threads rather than ten thousand,
+ * and concurrent callers (for example the server's reader threads) share the same threads instead of each starting
+ * their own. Work items are claimed from a shared counter, so a helper that is busy elsewhere is simply not needed:
+ * the caller finishes whatever is left itself and never waits on a helper to start.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Returns the number of helper threads.
+     *
+     * @return The helper count; callers add one more worker of their own
+     */
+    static size_t helpers();
+
+    /**
+     * @brief Runs `work(i)` for every `i` below `count`, on the calling thread and the helpers, and waits for all.
+     *
+     * Items are claimed in chunks of consecutive indices, a few chunks per worker.
+     *
+     * @param count The number of items
+     * @param work The task for one item. Called concurrently for different items.
+     *
+     * @throws Whatever the first failing item threw, once every started item has finished.
+     */
+    static void parallelFor(size_t count, const function<void(size_t)> &work);
+
+    /**
+     * @brief Runs `work(i)` for every `i` below `count` in parallel, handing each result over in index order.
+     *
+     * `deliver(i)` runs on the calling thread as soon as item `i` and every item before it are done, so results can
+     * be consumed (and released) while later items are still being worked on. If `deliver` returns false, no further
+     * item is started and the call returns once the items already running have finished.
+     *
+     * @param count The number of items
+     * @param work The task for one item. Called concurrently for different items.
+     * @param deliver Consumes the result of one item; returns false to stop early.
+     * @return True if every item was delivered, false if `deliver` stopped early
+     *
+     * @throws Whatever the first failing item threw, once every started item has finished.
+     */
+    static bool parallelForOrdered(size_t count, const function<void(size_t)> &work,
+                                   const function<bool(size_t)> &deliver);
+};
+
+#endif //ADS_MIDTERM_PROJECT_WORKERPOOL_H
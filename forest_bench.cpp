@@ -0,0 +1,263 @@
+/**
+ * @file forest_bench.cpp
+ * @brief Micro-benchmark harness for the `ForestTree` load, lookup, posting, rollup and save paths.
+ *
+ * The harness generates a synthetic chart of accounts and ledger in a scratch directory with `LedgerGenerator`,
+ * then times each scenario with a configurable number of warmup and measured repetitions. Every operation is timed individually and the
+ * results are reported as percentiles in JSON, so runs can be compared across changes.
+ *
+ * Usage: forest_bench [--accounts N] [--depth D] [--fanout F] [--transactions T]
+ *                     [--warmup W] [--reps R] [--seed S] [--json FILE] [--trace FILE]
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <cstdlib>
+#include "ForestTree.h"
+#include "LedgerGenerator.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Shape of the generated chart of accounts and ledger.
+ */
+struct BenchConfig {
+    int accounts = 10000;       ///< Number of accounts in the chart
+    int depth = 5;              ///< Maximum number of digits in an account number
+    int fanout = 10;            ///< Children per account (at most 10, one per trailing digit)
+    int transactions = 50000;   ///< Number of transactions in the ledger
+    int warmup = 2;             ///< Untimed repetitions per scenario
+    int reps = 10;              ///< Timed repetitions per scenario
+    unsigned seed = 42;         ///< Seed for the generator and the random operation mix
+    string jsonFile;            ///< Where to write the JSON report, stdout if empty
+    string traceFile;           ///< Where to write a Chrome trace of the run, none if empty
+};
+
+/**
+ * @brief Latency summary of one scenario.
+ */
+struct BenchResult {
+    string name;                ///< Scenario name
+    vector<double> samples;     ///< Per-operation latencies in nanoseconds
+};
+
+/**
+ * @brief Silences `cout` for the lifetime of the object, so progress messages don't pollute timings.
+ */
+class QuietScope {
+private:
+    streambuf *saved;
+    ostringstream sink;
+public:
+    QuietScope() : saved(cout.rdbuf(sink.rdbuf())) {}
+    ~QuietScope() { cout.rdbuf(saved); }
+};
+
+/**
+ * @brief Runs a scenario: `warmup` untimed calls, then `reps` timed calls.
+ *
+ * @param name The scenario name.
+ * @param config The warmup and repetition counts.
+ * @param setup Untimed preparation before each call.
+ * @param operation The timed operation.
+ * @return The per-call latencies.
+ */
+static BenchResult runScenario(const string &name, const BenchConfig &config,
+                               const function<void()> &setup, const function<void()> &operation) {
+    BenchResult result;
+    result.name = name;
+    QuietScope quiet;
+
+    for (int i = 0; i < config.warmup; ++i) {
+        setup();
+        operation();
+    }
+    for (int i = 0; i < config.reps; ++i) {
+        setup();
+        auto start = chrono::steady_clock::now();
+        operation();
+        auto end = chrono::steady_clock::now();
+        result.samples.push_back(chrono::duration<double, nano>(end - start).count());
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the given percentile of a sorted sample vector.
+ */
+static double percentile(const vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+/**
+ * @brief Writes the results as a JSON document.
+ */
+static void writeJson(ostream &os, const BenchConfig &config, const vector<BenchResult> &results) {
+    os << "{\n  \"config\": {\"accounts\": " << config.accounts << ", \"depth\": " << config.depth
+       << ", \"fanout\": " << config.fanout << ", \"transactions\": " << config.transactions
+       << ", \"warmup\": " << config.warmup << ", \"reps\": " << config.reps << ", \"seed\": " << config.seed
+       << "},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        vector<double> sorted(results[i].samples);
+        sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double sample: sorted) sum += sample;
+        double mean = sorted.empty() ? 0.0 : sum / sorted.size();
+
+        os << fixed << setprecision(0)
+           << "    {\"name\": \"" << results[i].name << "\", \"reps\": " << sorted.size()
+           << ", \"min_ns\": " << (sorted.empty() ? 0.0 : sorted.front())
+           << ", \"mean_ns\": " << mean
+           << ", \"p50_ns\": " << percentile(sorted, 50)
+           << ", \"p90_ns\": " << percentile(sorted, 90)
+           << ", \"p99_ns\": " << percentile(sorted, 99)
+           << ", \"max_ns\": " << (sorted.empty() ? 0.0 : sorted.back()) << "}"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+/**
+ * @brief Parses the command line into a configuration.
+ */
+static bool parseArgs(int argc, char **argv, BenchConfig &config) {
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << endl;
+            return false;
+        }
+        string value = argv[++i];
+        if (arg == "--accounts") config.accounts = stoi(value);
+        else if (arg == "--depth") config.depth = stoi(value);
+        else if (arg == "--fanout") config.fanout = stoi(value);
+        else if (arg == "--transactions") config.transactions = stoi(value);
+        else if (arg == "--warmup") config.warmup = stoi(value);
+        else if (arg == "--reps") config.reps = stoi(value);
+        else if (arg == "--seed") config.seed = static_cast<unsigned>(stoul(value));
+        else if (arg == "--json") config.jsonFile = value;
+        else if (arg == "--trace") config.traceFile = value;
+        else {
+            cerr << "Unknown option: " << arg << endl;
+            return false;
+        }
+    }
+    if (config.fanout < 1 || config.fanout > 10 || config.depth < 1 || config.depth > 9 || config.accounts < 1) {
+        cerr << "fanout must be 1-10, depth 1-9 and accounts positive" << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Entry point of the benchmark.
+ *
+ * @return Exit status of the program.
+ */
+int main(int argc, char **argv) {
+    BenchConfig config;
+    try {
+        if (!parseArgs(argc, argv, config)) {
+            return 1;
+        }
+    } catch (const exception &e) {
+        cerr << "Invalid option value: " << e.what() << endl;
+        return 1;
+    }
+
+    // Work in a scratch directory: posting rewrites the ledger file in the current directory
+    fs::path workDir = fs::temp_directory_path() / ("forest_bench_" + to_string(config.seed));
+    fs::create_directories(workDir);
+    fs::path originalDir = fs::current_path();
+    fs::current_path(workDir);
+
+    const string accountsFile = "accountswithspace.txt";
+    GeneratorConfig shape;
+    shape.seed = config.seed;
+    shape.depth = config.depth;
+    shape.fanout = config.fanout;
+    shape.accounts = config.accounts;
+    shape.transactions = config.transactions;
+    LedgerGenerator generator(shape);
+    generator.writeFiles(accountsFile);
+    const vector<int> &accounts = generator.getAccounts();
+    config.accounts = static_cast<int>(accounts.size());
+
+    if (!config.traceFile.empty()) {
+        ForestTrace::start();
+    }
+
+    vector<BenchResult> results;
+    mt19937 rng(config.seed + 1);
+    uniform_int_distribution<size_t> pick(0, accounts.size() - 1);
+
+    // Load: parse the chart, link the tree and load the ledger
+    results.push_back(runScenario("buildFromFile", config, [] {}, [&] {
+        ForestTree tree;
+        tree.buildFromFile(accountsFile);
+    }));
+
+    ForestTree tree;
+    {
+        QuietScope quiet;
+        tree.buildFromFile(accountsFile);
+    }
+
+    int target = 0;
+    results.push_back(runScenario("findAccount", config, [&] { target = accounts[pick(rng)]; }, [&] {
+        if (!tree.findAccount(target)) cerr << "missing account " << target << endl;
+    }));
+
+    int postCount = 0;
+    results.push_back(runScenario("addTransaction", config, [&] { target = accounts[pick(rng)]; }, [&] {
+        Transaction t("BP" + to_string(postCount++), 12.5, 'D', "Bench post", "15-06-24");
+        tree.addTransaction(target, t);
+    }));
+
+    results.push_back(runScenario("deleteTransaction", config, [&] {
+        do {
+            target = accounts[pick(rng)];
+        } while (tree.findAccount(target)->getData().getTransactionCount() == 0);
+    }, [&] {
+        tree.deleteTransaction(target, 0);
+    }));
+
+    results.push_back(runScenario("getMonthlyTotals", config, [&] { target = accounts[pick(rng)]; }, [&] {
+        tree.getMonthlyTotals(target, 2024, 6);
+    }));
+
+    results.push_back(runScenario("saveToFile", config, [] {}, [&] {
+        tree.saveToFile(accountsFile);
+    }));
+
+    results.push_back(runScenario("saveTransactions", config, [] {}, [&] {
+        tree.saveTransactions(tree.getTransactionFilename(accountsFile));
+    }));
+
+    fs::current_path(originalDir);
+    fs::remove_all(workDir);
+
+    if (!config.traceFile.empty()) {
+        ForestTrace::stop();
+        ForestTrace::writeChromeTrace(config.traceFile);
+    }
+
+    if (config.jsonFile.empty()) {
+        writeJson(cout, config, results);
+    } else {
+        ofstream out(config.jsonFile);
+        writeJson(out, config, results);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file forest_server.cpp
+ * @brief Long-running server that shares one warm in-memory ledger between many local clients.
+ *
+ * Loads `accountswithspace.txt` and its transaction file from the data directory, then serves lookups, queries and
+ * postings over a Unix-domain socket (or loopback TCP) using the frame protocol described in `ForestProtocol.h`.
+ * SIGINT or SIGTERM stops the server cleanly.
+ *
+ * Usage: forest_server [--data DIR] [--socket PATH | --port N] [--readers N] [--batch-size N]
+ */
+#include <iostream>
+#include <string>
+#include <filesystem>
+#include <csignal>
+#include <cstdlib>
+#include "ForestTree.h"
+#include "ForestServer.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * @brief The running server, for the signal handler.
+ */
+static ForestServer *activeServer = nullptr;
+
+/**
+ * @brief Stops the server on SIGINT or SIGTERM.
+ *
+ * @param signal The signal number.
+ */
+static void handleSignal(int signal) {
+    (void) signal;
+    if (activeServer) {
+        activeServer->stop();
+    }
+}
+
+/**
+ * @brief Prints the command-line usage.
+ */
+static void printUsage() {
+    cerr << "Usage: forest_server [--data DIR] [--socket PATH | --port N] [--readers N] [--batch-size N]" << endl;
+}
+
+/**
+ * @brief Entry point of the server.
+ *
+ * @return Exit status of the program.
+ */
+int main(int argc, char **argv) {
+    ServerConfig config;
+    string dataDir = ".";
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 2;
+        }
+        string value = argv[++i];
+        if (arg == "--data") dataDir = value;
+        else if (arg == "--socket") config.socketPath = value;
+        else if (arg == "--port") config.port = atoi(value.c_str());
+        else if (arg == "--readers") config.readers = strtoul(value.c_str(), nullptr, 10);
+        else if (arg == "--batch-size") config.batchSize = strtoul(value.c_str(), nullptr, 10);
+        else {
+            printUsage();
+            return 2;
+        }
+    }
+
+    // Resolve the socket before moving into the data directory, so a relative path means what the caller meant
+    if (!config.socketPath.empty()) {
+        config.socketPath = fs::absolute(config.socketPath).string();
+    }
+
+    // The transaction file is written relative to the working directory, so work inside the data directory
+    error_code ec;
+    fs::current_path(dataDir, ec);
+    if (ec) {
+        cerr << "Error: cannot use data directory " << dataDir << ": " << ec.message() << endl;
+        return 2;
+    }
+
+    ForestTree tree;
+    tree.buildFromFile("accountswithspace.txt");
+    tree.enableBackgroundPersistence(tree.getTransactionsFile());
+
+    ForestServer server(tree, config);
+    if (!server.start()) {
+        return 1;
+    }
+
+    activeServer = &server;
+    struct sigaction action{};
+    action.sa_handler = handleSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (config.socketPath.empty()) {
+        cout << "Serving on 127.0.0.1:" << config.port << endl;
+    } else {
+        cout << "Serving on " << config.socketPath << endl;
+    }
+    server.run();
+    activeServer = nullptr;
+
+    // The writer has stopped, so nothing else changes the tree; make sure the chart and the transactions are saved
+    if (!tree.commit()) {
+        cerr << "Error: not every change could be written to disk" << endl;
+        return 1;
+    }
+
+    cout << "Server stopped." << endl;
+    return 0;
+}
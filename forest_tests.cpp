@@ -0,0 +1,393 @@
+//
+// Created by Faysal on 10/19/2026.
+//
+
+/**
+ * @file forest_tests.cpp
+ * @brief Self-checking tests for the persistence, checksum and transaction ID code, run through CTest.
+ *
+ * Usage: forest_tests <suite>, where the suite is `persistence`, `checksums` or `id_index`. Each failed check is
+ * printed with its line; the exit status is the number of failures, capped at 1.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <filesystem>
+#include <unistd.h>
+#include "ForestTree.h"
+#include "PersistenceWorker.h"
+#include "RecordChecksum.h"
+#include "TransactionIdIndex.h"
+#include "TransactionIdGenerator.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Number of checks that failed so far.
+ */
+static int failures = 0;
+
+/**
+ * @brief Counts and reports a check that did not hold.
+ */
+#define CHECK(condition)                                                                \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << endl; \
+            ++failures;                                                                 \
+        }                                                                               \
+    } while (false)
+
+/**
+ * @brief Creates an empty scratch directory for one test.
+ *
+ * @param name The test name
+ * @return The directory
+ */
+static fs::path scratchDirectory(const string &name) {
+    fs::path dir = fs::temp_directory_path() / ("forest_tests_" + to_string(getpid()) + "_" + name);
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+/**
+ * @brief Reads a whole file.
+ *
+ * @param path The file
+ * @return Its contents, empty if it cannot be read
+ */
+static string readFile(const fs::path &path) {
+    ifstream file(path);
+    stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+/**
+ * @brief Counts the lines of a text that contain a string.
+ *
+ * @param text The text
+ * @param needle The string to look for
+ * @return The number of lines holding it
+ */
+static size_t countLines(const string &text, const string &needle) {
+    istringstream lines(text);
+    string line;
+    size_t count = 0;
+    while (getline(lines, line)) {
+        if (line.find(needle) != string::npos) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Checks that `waitDurable` only returns once a change and everything before it is on disk, with records
+ * submitted concurrently and so dequeued out of sequence order.
+ */
+static void testDurableOrdering() {
+    fs::path dir = scratchDirectory("ordering");
+    fs::path file = dir / "ledger.txt";
+    const int threads = 4, perThread = 200;
+    {
+        PersistenceWorker worker(file.string(), false);
+        vector<thread> producers;
+        vector<int> early(threads, 0);
+        for (int t = 0; t < threads; ++t) {
+            producers.emplace_back([&, t] {
+                for (int i = 0; i < perThread; ++i) {
+                    uint64_t sequence = worker.submit(ChangeRecord::Append,
+                                                      "t" + to_string(t) + "-" + to_string(i) + "\n");
+                    if (!worker.waitDurable(sequence) || worker.durableSequence() < sequence) {
+                        ++early[t];
+                    }
+                }
+            });
+        }
+        for (thread &producer: producers) {
+            producer.join();
+        }
+        for (int count: early) {
+            CHECK(count == 0);
+        }
+        CHECK(worker.flush());
+        CHECK(worker.lastSequence() == uint64_t(threads * perThread));
+        CHECK(worker.durableSequence() == worker.lastSequence());
+    }
+
+    string contents = readFile(file);
+    set<string> lines;
+    istringstream in(contents);
+    string line;
+    while (getline(in, line)) {
+        lines.insert(line);
+    }
+    CHECK(lines.size() == size_t(threads * perThread));
+    CHECK(count(contents.begin(), contents.end(), '\n') == threads * perThread);
+
+    // A replacement discards the appends queued before it but keeps the ones after it
+    {
+        PersistenceWorker worker(file.string(), false);
+        worker.submit(ChangeRecord::Append, "dropped\n");
+        worker.submit(ChangeRecord::Replace, "R\n");
+        CHECK(worker.waitDurable(worker.submit(ChangeRecord::Append, "A\n")));
+    }
+    CHECK(readFile(file) == "R\nA\n");
+    fs::remove_all(dir);
+}
+
+/**
+ * @brief Checks that a failed background append is not acknowledged, and that the next write rewrites the whole
+ * transaction file so the failed posting is not lost.
+ */
+static void testFailureRewrite() {
+    fs::path dir = scratchDirectory("rewrite");
+    fs::path away = dir.string() + ".away";
+    fs::remove_all(away);
+    fs::path chart = dir / "accountswithspace.txt";
+    ofstream(chart) << "1 Assets 0.00\n11 Cash 0.00\n";
+    string transactionsFile;
+
+    {
+        ForestTree tree;
+        tree.buildFromFile(chart.string());
+        transactionsFile = tree.getTransactionsFile();
+        tree.enableBackgroundPersistence(tree.getTransactionsFile(), false);
+
+        Transaction first("T1", 10.0, 'D', "first", "01-02-25");
+        CHECK(tree.addTransaction(11, first));
+        CHECK(tree.waitDurable(tree.getLastChangeSequence()));
+
+        // Replace the directory with a file, so every write into it fails
+        fs::rename(dir, away);
+        ofstream(dir) << "not a directory";
+        Transaction second("T2", 20.0, 'D', "second", "02-02-25");
+        CHECK(tree.addTransaction(11, second));
+        CHECK(!tree.waitDurable(tree.getLastChangeSequence()));
+
+        fs::remove(dir);
+        fs::rename(away, dir);
+        Transaction third("T3", 30.0, 'C', "third", "03-02-25");
+        CHECK(tree.addTransaction(11, third));
+        CHECK(tree.commit());
+    }
+
+    string contents = readFile(transactionsFile);
+    CHECK(countLines(contents, "|T1|") == 1);
+    CHECK(countLines(contents, "|T2|") == 1);
+    CHECK(countLines(contents, "|T3|") == 1);
+
+    ForestTree reloaded;
+    reloaded.buildFromFile(chart.string());
+    NodePtr cash = reloaded.findAccount(11);
+    CHECK(cash && cash->getData().getTransactionCount() == 3);
+    CHECK(reloaded.getLoadIntegrity().clean());
+    fs::remove_all(dir);
+}
+
+/**
+ * @brief Checks that a tree never given a transaction file writes nothing, not even into the working directory.
+ */
+static void testNoTransactionsFile() {
+    fs::path dir = scratchDirectory("nofile");
+    fs::path original = fs::current_path();
+    fs::current_path(dir);
+    {
+        ForestTree tree;
+        CHECK(tree.getTransactionsFile().empty());
+        Account cash;
+        cash.setAccountNumber(1);
+        cash.setDescription("Cash");
+        CHECK(tree.addAccount(cash, -1));
+        Transaction t("T1", 5.0, 'D', "in memory", "01-02-25");
+        CHECK(tree.addTransaction(1, t));
+        CHECK(tree.commit());
+        CHECK(tree.getPendingChanges() == 0);
+    }
+    fs::current_path(original);
+    CHECK(fs::is_empty(dir));
+    fs::remove_all(dir);
+}
+
+/**
+ * @brief Checks sealing and opening single records.
+ */
+static void testRecordChecksums() {
+    string sealed;
+    RecordChecksum::seal(sealed, "11|T1|10.00|D|01-02-25|first");
+    CHECK(sealed.back() == '\n');
+
+    string line = sealed.substr(0, sealed.size() - 1);
+    CHECK(RecordChecksum::open(line) == RecordChecksum::Valid);
+    CHECK(line == "11|T1|10.00|D|01-02-25|first");
+
+    string flipped = sealed.substr(0, sealed.size() - 1);
+    flipped[3] = 'X';
+    CHECK(RecordChecksum::open(flipped) == RecordChecksum::Corrupt);
+
+    string plain = "11|T1|10.00|D|01-02-25|first";
+    CHECK(RecordChecksum::open(plain) == RecordChecksum::Unchecked);
+    CHECK(plain == "11|T1|10.00|D|01-02-25|first");
+}
+
+/**
+ * @brief Reads a file's text through a `RecordReader`.
+ *
+ * @param text The file contents
+ * @param report Receives the counts
+ * @return The intact records, in order
+ */
+static vector<string> readRecords(const string &text, IntegrityReport &report) {
+    istringstream in(text);
+    RecordReader reader(in, "test", report);
+    vector<string> records;
+    string record;
+    while (reader.next(record)) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+/**
+ * @brief Checks section trailers, and that the reader skips corrupt records and notices missing or torn sections.
+ */
+static void testSections() {
+    string lines;
+    RecordChecksum::seal(lines, "a");
+    RecordChecksum::seal(lines, "b");
+    ChecksumSection section;
+    section.add(lines);
+    string trailer = section.trailer();
+    CHECK(RecordChecksum::isSectionTrailer(trailer));
+    CHECK(section.matches(trailer.substr(0, trailer.size() - 1)));
+
+    ChecksumSection shorter;
+    shorter.add(lines.substr(0, lines.find('\n') + 1));
+    CHECK(!shorter.matches(trailer.substr(0, trailer.size() - 1)));
+
+    {
+        IntegrityReport report;
+        vector<string> records = readRecords(lines + trailer, report);
+        CHECK(records == vector<string>({"a", "b"}));
+        CHECK(report.records == 2 && report.sections == 1);
+        CHECK(report.clean());
+    }
+    {
+        // Two sections, as left by a save followed by an appended batch
+        string appended;
+        RecordChecksum::seal(appended, "c");
+        ChecksumSection batch;
+        batch.add(appended);
+        IntegrityReport report;
+        vector<string> records = readRecords(lines + trailer + appended + batch.trailer(), report);
+        CHECK(records.size() == 3 && report.sections == 2 && report.clean());
+    }
+    {
+        string damaged = lines + trailer;
+        damaged[0] = 'z';
+        IntegrityReport report;
+        vector<string> records = readRecords(damaged, report);
+        CHECK(records == vector<string>({"b"}));
+        CHECK(report.corrupt >= 1 && !report.clean());
+        CHECK(report.firstCorruptLine == 1);
+    }
+    {
+        // A batch that never got its trailer
+        IntegrityReport report;
+        readRecords(lines, report);
+        CHECK(report.badSections == 1 && !report.clean());
+    }
+    {
+        IntegrityReport report;
+        readRecords(lines + trailer + "11|T9|1.0", report);
+        CHECK(report.tornTail && !report.clean());
+    }
+    {
+        // Files written before checksums existed still load
+        IntegrityReport report;
+        vector<string> records = readRecords("a\nb\n", report);
+        CHECK(records.size() == 2 && report.unchecked == 2 && report.clean());
+    }
+}
+
+/**
+ * @brief Checks the duplicate detection of `TransactionIdIndex` for text and generated IDs.
+ */
+static void testIdIndex() {
+    TransactionIdIndex index;
+    Transaction text("T1", 1.0, 'D');
+    CHECK(index.insert(text));
+    CHECK(!index.insert(Transaction("T1", 2.0, 'C')));
+    CHECK(index.contains(string("T1")));
+    CHECK(!index.contains(string("T2")));
+
+    uint64_t id = TransactionIdGenerator::next();
+    string formatted = TransactionIdGenerator::format(id);
+    uint64_t parsed = 0;
+    CHECK(TransactionIdGenerator::parse(formatted, parsed) && parsed == id);
+    CHECK(index.insert(Transaction(formatted, 1.0, 'D')));
+    CHECK(index.contains(id));
+    CHECK(index.contains(formatted));
+    CHECK(!index.insert(Transaction(formatted, 1.0, 'D')));
+    CHECK(index.size() == 2);
+
+    index.erase(text);
+    CHECK(!index.contains(string("T1")));
+    CHECK(index.insert(text));
+
+    // Enough IDs to grow the filter several times
+    const int count = 20000;
+    vector<uint64_t> generated;
+    for (int i = 0; i < count; ++i) {
+        CHECK(index.insert(Transaction("X" + to_string(i), 1.0, 'D')));
+        generated.push_back(TransactionIdGenerator::next());
+        CHECK(index.insert(Transaction(TransactionIdGenerator::format(generated.back()), 1.0, 'D')));
+    }
+    CHECK(index.size() == size_t(2 * count + 2));
+    int missing = 0;
+    for (int i = 0; i < count; ++i) {
+        missing += !index.contains("X" + to_string(i)) + !index.contains(generated[i]);
+    }
+    CHECK(missing == 0);
+    CHECK(!index.contains(string("X-absent")));
+
+    index.clear();
+    CHECK(index.size() == 0 && !index.contains(id));
+}
+
+/**
+ * @brief Runs one test suite.
+ *
+ * @param argc Argument count
+ * @param argv The suite name: `persistence`, `checksums` or `id_index`
+ * @return 0 if every check held
+ */
+int main(int argc, char *argv[]) {
+    string suite = argc > 1 ? argv[1] : "";
+    if (suite == "persistence") {
+        testDurableOrdering();
+        testFailureRewrite();
+        testNoTransactionsFile();
+    } else if (suite == "checksums") {
+        testRecordChecksums();
+        testSections();
+    } else if (suite == "id_index") {
+        testIdIndex();
+    } else {
+        cerr << "Usage: " << argv[0] << " persistence|checksums|id_index" << endl;
+        return 2;
+    }
+    if (failures > 0) {
+        cerr << failures << " check(s) failed" << endl;
+        return 1;
+    }
+    cout << suite << ": all checks passed" << endl;
+    return 0;
+}
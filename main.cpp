@@ -6,15 +6,33 @@
  * including adding accounts, applying transactions, generating reports, and more.
  * The accounts are managed using a ForestTree data structure and are saved to or
  * loaded from files for persistence.
+ *
+ * Usage:
+ *   ADS_midterm_project [--data DIR] [--durability POLICY] [--node N]
+ *   ADS_midterm_project --batch [--data DIR] [--commands FILE] [--batch-size N] [--durability POLICY] [--node N]
+ *
+ * `--data` names the directory holding `accountswithspace.txt` and its transaction file. With `--batch` the
+ * program runs headless: commands are read from FILE (or stdin) and executed by `BatchRunner`, one JSON result
+ * line per command is written to stdout, and diagnostics go to stderr.
+ *
+ * `--durability` chooses when changes reach the transaction file: `every-op` (the interactive default), `group`
+ * or `group:N:MS` (every N changes or MS milliseconds; the batch default), or `manual` (only at the end).
+ *
+ * `--node` (0-31, default 0) goes into every transaction ID this process generates; processes posting to the same
+ * ledger at the same time need different nodes.
  */
 #include <iostream>
 #include <string>
 #include <filesystem>
 #include "ForestTree.h"
-#include <direct.h>
+#include "BatchRunner.h"
+#include "TransactionIdGenerator.h"
 #include <fstream>
+#include <cstdlib>
+#include <cstdio>
 
 using namespace std;
+namespace fs = std::filesystem;
 
 /**
  * @brief Displays the main menu options to the user.
@@ -28,6 +46,7 @@ void display_menu() {
     cout << "4. Delete Transaction" << endl;
     cout << "5. Display Chart of Accounts" << endl;
     cout << "6. Search Account" << endl;
+    cout << "7. Search by Description" << endl;
     cout << "0. Exit" << endl;
     cout << "\nEnter choice: ";
 }
@@ -38,20 +57,130 @@ void display_menu() {
  */
 void ensure_reports_directory() {
     const string reportDir = "reports";
-    if (_mkdir(reportDir.c_str()) == 0) {
+    error_code ec;
+    if (fs::create_directories(reportDir, ec)) {
         cout << "Created reports directory." << endl;
     }
-    // If directory already exists, -1 is returned but that's okay
+    // If directory already exists, false is returned but that's okay
 }
 
+/**
+ * @brief The directory holding the account data, set by `--data` or chosen by `main`.
+ */
+fs::path dataDirectory;
+
 /**
  * @brief Retrieves the file path to the project file containing account data.
  *
  * @return The file path as a string.
  */
 string getProjectPath() {
-    string userProfile = getenv("USERPROFILE"); // Gets C:\Users\User
-    return userProfile + "\\CLionProjects\\ADS-MID\\accountswithspace.txt";
+    return (dataDirectory / "accountswithspace.txt").string();
+}
+
+/**
+ * @brief Chooses the default data directory: the CLion project folder when `USERPROFILE` is set (Windows),
+ *        otherwise the current directory.
+ *
+ * @return The directory.
+ */
+fs::path default_data_directory() {
+    const char *userProfile = getenv("USERPROFILE"); // Gets C:\Users\User
+    if (userProfile) {
+        return fs::path(userProfile) / "CLionProjects" / "ADS-MID";
+    }
+    return fs::current_path();
+}
+
+/**
+ * @brief Parses a `--durability` value.
+ *
+ * @param value `every-op`, `group`, `group:N:MS` (commit every N changes or MS milliseconds) or `manual`.
+ * @param policy Receives the policy.
+ *
+ * @return True if the value is valid.
+ */
+bool parse_durability(const string &value, DurabilityPolicy &policy) {
+    policy = DurabilityPolicy();
+    if (value == "every-op") {
+        policy.mode = DurabilityMode::EveryOperation;
+    } else if (value == "manual") {
+        policy.mode = DurabilityMode::Manual;
+    } else if (value == "group") {
+        policy.mode = DurabilityMode::GroupCommit;
+    } else if (value.rfind("group:", 0) == 0) {
+        policy.mode = DurabilityMode::GroupCommit;
+        unsigned long changes = 0, millis = 0;
+        char extra;
+        if (sscanf(value.c_str() + 6, "%lu:%lu%c", &changes, &millis, &extra) != 2 || changes == 0) {
+            return false;
+        }
+        policy.maxPendingChanges = changes;
+        policy.maxPendingMillis = static_cast<unsigned>(millis);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Tells the user whether a change made from the menu is on disk.
+ *
+ * Under the every-operation policy the change is committed first, so success is only reported once the transactions
+ * and the chart are durable. Other policies leave it for their next write.
+ *
+ * @param tree The forest the change was made to.
+ * @param change What was done, e.g. "Transaction applied".
+ */
+void report_change(ForestTree &tree, const string &change) {
+    if (tree.getDurabilityPolicy().mode != DurabilityMode::EveryOperation) {
+        cout << "\n" << change << "; it will be saved with the next commit." << endl;
+    } else if (tree.commit()) {
+        cout << "\n" << change << " and saved successfully." << endl;
+    } else {
+        cerr << change << ", but it could not be saved. It will be saved with the next change." << endl;
+    }
+}
+
+/**
+ * @brief Runs the headless command mode.
+ *
+ * @param commandsFile The command file, or empty to read commands from stdin.
+ * @param batchSize Maximum number of commands per bulk call.
+ * @param durability When changes (the transactions and the chart's balances) are written; everything is committed
+ * before returning either way.
+ *
+ * @return Exit status: 0 if every command succeeded, 1 if any failed, 2 if the command file cannot be opened.
+ */
+int run_batch(const string &commandsFile, size_t batchSize, const DurabilityPolicy &durability) {
+    // Results own stdout; the tree's progress and error messages are sent to stderr
+    ostream results(cout.rdbuf());
+    streambuf *saved = cout.rdbuf(cerr.rdbuf());
+
+    ifstream commandStream;
+    if (!commandsFile.empty()) {
+        commandStream.open(commandsFile);
+        if (!commandStream) {
+            cerr << "Error opening command file: " << commandsFile << endl;
+            cout.rdbuf(saved);
+            return 2;
+        }
+    }
+
+    ForestTree tree;
+    tree.buildFromFile(getProjectPath());
+    tree.enableBackgroundPersistence(tree.getTransactionsFile());
+    tree.setDurabilityPolicy(durability);
+
+    BatchRunner runner(tree, getProjectPath(), batchSize);
+    BatchStats stats = runner.run(commandsFile.empty() ? cin : commandStream, results);
+    if (!tree.commit()) {
+        cerr << "Error: not every change could be written to disk" << endl;
+        stats.failed++;
+    }
+
+    cout.rdbuf(saved);
+    return stats.failed == 0 ? 0 : 1;
 }
 
 /**
@@ -60,7 +189,62 @@ string getProjectPath() {
  *
  * @return Exit status of the program.
  */
-int main() {
+int main(int argc, char *argv[]) {
+    bool batch = false;
+    string commandsFile;
+    size_t batchSize = 1024;
+    string durabilityName;
+    dataDirectory = default_data_directory();
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--batch") {
+            batch = true;
+        } else if (arg == "--data" && i + 1 < argc) {
+            dataDirectory = argv[++i];
+        } else if (arg == "--commands" && i + 1 < argc) {
+            commandsFile = argv[++i];
+        } else if (arg == "--batch-size" && i + 1 < argc) {
+            batchSize = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--durability" && i + 1 < argc) {
+            durabilityName = argv[++i];
+        } else if (arg == "--node" && i + 1 < argc) {
+            unsigned long node = strtoul(argv[++i], nullptr, 10);
+            if (node >= (1u << TransactionIdGenerator::NODE_BITS)) {
+                cerr << "Error: --node must be below " << (1u << TransactionIdGenerator::NODE_BITS) << endl;
+                return 2;
+            }
+            TransactionIdGenerator::setNode(static_cast<unsigned>(node));
+        } else {
+            cerr << "Usage: " << argv[0] << " [--batch] [--data DIR] [--commands FILE] [--batch-size N]"
+                 << " [--durability every-op|group|group:N:MS|manual] [--node N]" << endl;
+            return 2;
+        }
+    }
+
+    // Bulk jobs default to group commit; the interactive menu writes every change as it is made
+    DurabilityPolicy durability;
+    if (batch) {
+        durability.mode = DurabilityMode::GroupCommit;
+    }
+    if (!durabilityName.empty() && !parse_durability(durabilityName, durability)) {
+        cerr << "Error: unknown durability policy " << durabilityName << endl;
+        return 2;
+    }
+
+    // The transaction file is written relative to the working directory, so work inside the data directory
+    error_code ec;
+    fs::current_path(dataDirectory, ec);
+    if (ec) {
+        cerr << "Error: cannot use data directory " << dataDirectory.string() << ": " << ec.message() << endl;
+        return 2;
+    }
+    dataDirectory = fs::current_path();
+
+    if (batch) {
+        return run_batch(commandsFile, batchSize, durability);
+    }
+
     ForestTree tree;
 
     ensure_reports_directory();
@@ -68,6 +252,10 @@ int main() {
     // Build chart of accounts from a file
     tree.buildFromFile(getProjectPath());
 
+    // Postings and deletions queue their transaction file writes for a background thread
+    tree.enableBackgroundPersistence(tree.getTransactionsFile());
+    tree.setDurabilityPolicy(durability);
+
     int choice;
     do {
         display_menu();
@@ -109,7 +297,7 @@ int main() {
                 }
 
                 if (tree.addAccountWithFile(accountNumber, description, balance, getProjectPath())) {
-                    cout << "\nAccount added and saved successfully." << endl;
+                    report_change(tree, "Account added");
                 } else {
                     cout
                             << "\nFailed to add account. Ensure the account number is unique and follows the chart of accounts structure."
@@ -134,14 +322,7 @@ int main() {
                 cin >> newTransaction;  // This will prompt for all transaction details
 
                 if (tree.addTransaction(accountNumber, newTransaction)) {
-                    // Save changes to file after successful transaction
-                    try {
-                        tree.saveToFile(getProjectPath());
-                        tree.saveTransactions(tree.getTransactionFilename(getProjectPath()));
-                        cout << "\nTransaction applied and saved successfully." << endl;
-                    } catch (const exception &e) {
-                        cerr << "Transaction applied but failed to save: " << e.what() << endl;
-                    }
+                    report_change(tree, "Transaction applied");
                 } else {
                     cout << "Failed to apply transaction." << endl;
                 }
@@ -236,14 +417,7 @@ int main() {
                     cin >> transactionIndex;
 
                     if (tree.deleteTransaction(accountNumber, transactionIndex)) {
-                        // Save changes to file after successful deletion
-                        try {
-                            tree.saveToFile(getProjectPath());
-                            tree.saveTransactions(tree.getTransactionFilename(getProjectPath()));
-                            cout << "Transaction deleted and changes saved successfully.\n";
-                        } catch (const exception &e) {
-                            cerr << "Transaction deleted but failed to save changes: " << e.what() << endl;
-                        }
+                        report_change(tree, "Transaction deleted");
                     } else {
                         cout << "Failed to delete transaction.\n";
                     }
@@ -281,6 +455,29 @@ int main() {
                 }
                 break;
             }
+            case 7: {
+                string text;
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cout << "Enter text to search for: ";
+                getline(cin, text);
+
+                vector<SearchHit> hits = tree.getSearchIndex().search(text, 20);
+                if (hits.empty()) {
+                    cout << "No accounts or transactions match \"" << text << "\"." << endl;
+                    break;
+                }
+
+                cout << "\nMatches:" << endl;
+                for (const SearchHit &hit: hits) {
+                    if (hit.isTransaction) {
+                        cout << "Transaction " << hit.transactionID << " (account " << hit.accountNumber << "): ";
+                    } else {
+                        cout << "Account " << hit.accountNumber << ": ";
+                    }
+                    cout << hit.description << endl;
+                }
+                break;
+            }
 
             case 0:
                 cout << "Exiting program thank you for choosing us:)...\n";